@@ -0,0 +1,12 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+int main() {
+  auto* p1 = shm_open;
+  auto* p2 = shm_unlink;
+  auto* p3 = mmap;
+  (void) p1;
+  (void) p2;
+  (void) p3;
+  return 0;
+}
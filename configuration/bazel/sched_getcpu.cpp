@@ -0,0 +1,6 @@
+#include <sched.h>
+int main() {
+  int cpu = sched_getcpu();
+  (void) cpu;
+  return 0;
+}
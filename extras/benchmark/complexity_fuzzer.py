@@ -0,0 +1,477 @@
+#!/usr/bin/env python3
+# Copyright 2016 Google Inc. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS-IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Checks that the run time of each phase of Fruit (normalization, injector creation, injection) scales at most as
+n*log(n) in the size of the component graph.
+
+This generates random component graphs of increasing size for several shapes (see SCENARIOS), times each phase with a
+driver program compiled once against the Fruit sources, fits a power law t = c*n^k to the timings of each phase and
+flags the phases whose exponent k is higher than the one of n*log(n) over the same range of sizes (plus a tolerance,
+since the timings are noisy).
+
+All graphs except the "typed_bindings" ones are built at runtime with components with arguments (installing each
+other, replacing each other and adding multibindings), so that the driver doesn't need to be recompiled for each size.
+The "typed_bindings" graphs use a different type for each node, to also exercise the data structures indexed by type
+(e.g. the SemistaticMap lookup table); their maximum size is fixed at compile time by --max-typed-bindings.
+
+Example:
+
+    extras/benchmark/complexity_fuzzer.py \\
+        --fruit-sources-dir ~/projects/fruit \\
+        --fruit-build-dir ~/projects/fruit/build
+
+Exits with status 1 if any phase was flagged.
+"""
+
+import argparse
+import os
+import random
+import sys
+import tempfile
+import textwrap
+from typing import Dict, List, Tuple
+
+import numpy
+
+from run_benchmarks import run_command, ensure_empty_dir
+
+# The phases timed by the driver, in the order they're printed.
+PHASES = [
+    'normalized_component_creation',
+    'injector_creation_from_normalized_component',
+    'injection',
+    'injector_creation_from_component',
+]
+
+DRIVER_SOURCE = textwrap.dedent('''\
+    #include <fruit/fruit.h>
+    #include <fruit/impl/injector/injector_accessor_for_tests.h>
+
+    #include <algorithm>
+    #include <chrono>
+    #include <cstdlib>
+    #include <fstream>
+    #include <iostream>
+    #include <vector>
+
+    struct Value {
+      int n;
+    };
+
+    struct Node {
+      bool adds_multibinding;
+      bool replaces_leaf;
+      std::vector<int> installs;
+    };
+
+    static std::vector<Node> nodes;
+    static std::vector<Value> values;
+    static std::vector<Value> replacement_values;
+    static int num_typed_bindings = 0;
+
+    // Typed bindings: X<I> depends on X<I/2>, and getTypedComponent<I> installs getTypedComponent<I/2>, so that the
+    // installs form a binary tree (that's de-duplicated during normalization).
+    template <int I>
+    struct X {
+      int n;
+    };
+
+    template <int I>
+    struct TypedBinding {
+      static fruit::Component<X<I>> getTypedComponent() {
+        return fruit::createComponent()
+            .install(TypedBinding<I / 2>::getTypedComponent)
+            .registerProvider([](const X<I / 2>& x) { return X<I>{x.n + 1}; });
+      }
+      static fruit::Component<> getComponent() {
+        return fruit::createComponent().install(getTypedComponent);
+      }
+      static int inject(fruit::Injector<>& injector) {
+        return fruit::impl::InjectorAccessorForTests::unsafeGet<X<I>>(injector)->n;
+      }
+    };
+
+    template <>
+    struct TypedBinding<0> {
+      static fruit::Component<X<0>> getTypedComponent() {
+        return fruit::createComponent().registerProvider([]() { return X<0>{0}; });
+      }
+      static fruit::Component<> getComponent() {
+        return fruit::createComponent().install(getTypedComponent);
+      }
+      static int inject(fruit::Injector<>& injector) {
+        return fruit::impl::InjectorAccessorForTests::unsafeGet<X<0>>(injector)->n;
+      }
+    };
+
+    using TypedComponentFunction = fruit::Component<> (*)();
+    using TypedInjectFunction = int (*)(fruit::Injector<>&);
+
+    extern const TypedComponentFunction typed_components[];
+    extern const TypedInjectFunction typed_injects[];
+
+    fruit::Component<> getLeaf(int i) {
+      return fruit::createComponent().addInstanceMultibinding(values[i]);
+    }
+
+    fruit::Component<> getReplacementLeaf(int i) {
+      return fruit::createComponent().addInstanceMultibinding(replacement_values[i]);
+    }
+
+    fruit::Component<> getNode(int i);
+
+    // Installs nodes[i].installs[k], nodes[i].installs[k+1], ...
+    fruit::Component<> getInstalls(int i, std::size_t k) {
+      if (k == nodes[i].installs.size()) {
+        return fruit::createComponent();
+      }
+      return fruit::createComponent().install(getNode, nodes[i].installs[k]).install(getInstalls, i, k + 1);
+    }
+
+    fruit::Component<> getNodeBody(int i) {
+      if (nodes[i].adds_multibinding) {
+        return fruit::createComponent().install(getInstalls, i, 0).addInstanceMultibinding(values[i]);
+      }
+      return fruit::createComponent().install(getInstalls, i, 0);
+    }
+
+    fruit::Component<> getNode(int i) {
+      if (nodes[i].replaces_leaf) {
+        return fruit::createComponent()
+            .replace(getLeaf, i)
+            .with(getReplacementLeaf, i)
+            .install(getNodeBody, i)
+            .install(getLeaf, i);
+      }
+      return fruit::createComponent().install(getNodeBody, i);
+    }
+
+    // Installs the typed bindings [i, num_typed_bindings).
+    fruit::Component<> getTypedBindings(int i) {
+      if (i == num_typed_bindings) {
+        return fruit::createComponent();
+      }
+      return fruit::createComponent().install(typed_components[i]).install(getTypedBindings, i + 1);
+    }
+
+    fruit::Component<> getRootComponent() {
+      if (nodes.empty()) {
+        return fruit::createComponent().install(getTypedBindings, 0);
+      }
+      return fruit::createComponent().install(getNode, 0).install(getTypedBindings, 0);
+    }
+
+    fruit::Component<> getEmptyComponent() {
+      return fruit::createComponent();
+    }
+
+    int injectAll(fruit::Injector<>& injector) {
+      int result = 0;
+      for (Value* value : injector.getMultibindings<Value>()) {
+        result += value->n;
+      }
+      for (int i = 0; i < num_typed_bindings; ++i) {
+        result += typed_injects[i](injector);
+      }
+      return result;
+    }
+
+    // The input is:
+    // num_typed_bindings num_nodes
+    // followed by a line for each node:
+    // adds_multibinding replaces_leaf num_installs install_1 install_2 ...
+    void readGraph(const char* path) {
+      std::ifstream input(path);
+      std::size_t num_nodes;
+      input >> num_typed_bindings >> num_nodes;
+      nodes.resize(num_nodes);
+      for (std::size_t i = 0; i < num_nodes; ++i) {
+        std::size_t num_installs;
+        input >> nodes[i].adds_multibinding >> nodes[i].replaces_leaf >> num_installs;
+        nodes[i].installs.resize(num_installs);
+        for (int& install : nodes[i].installs) {
+          input >> install;
+        }
+        values.push_back(Value{1});
+        replacement_values.push_back(Value{2});
+      }
+      if (!input || num_typed_bindings > MAX_TYPED_BINDINGS) {
+        std::cerr << "Invalid graph file: " << path << std::endl;
+        exit(1);
+      }
+    }
+
+    template <typename F>
+    double timeMin(std::size_t num_repetitions, F f) {
+      double result = 1e30;
+      for (std::size_t i = 0; i < num_repetitions; ++i) {
+        auto begin = std::chrono::steady_clock::now();
+        f();
+        auto end = std::chrono::steady_clock::now();
+        result = std::min(result, std::chrono::duration<double>(end - begin).count());
+      }
+      return result;
+    }
+
+    int main(int argc, char* argv[]) {
+      if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <graph_file> <num_repetitions>" << std::endl;
+        return 1;
+      }
+      readGraph(argv[1]);
+      std::size_t num_repetitions = atoi(argv[2]);
+
+      // Used so that the compiler can't optimize out any of the phases.
+      int result = 0;
+
+      double normalized_component_creation_time = timeMin(num_repetitions, [&] {
+        fruit::NormalizedComponent<> normalized_component(getRootComponent);
+        result += 1;
+      });
+
+      fruit::NormalizedComponent<> normalized_component(getRootComponent);
+      double injector_creation_from_normalized_component_time = timeMin(num_repetitions, [&] {
+        fruit::Injector<> injector(normalized_component, getEmptyComponent);
+        result += 1;
+      });
+
+      double injection_time = 1e30;
+      for (std::size_t i = 0; i < num_repetitions; ++i) {
+        fruit::Injector<> injector(normalized_component, getEmptyComponent);
+        injection_time = std::min(injection_time, timeMin(1, [&] { result += injectAll(injector); }));
+      }
+
+      double injector_creation_from_component_time = timeMin(num_repetitions, [&] {
+        fruit::Injector<> injector(getRootComponent);
+        result += 1;
+      });
+
+      std::cout << "normalized_component_creation " << normalized_component_creation_time << std::endl;
+      std::cout << "injector_creation_from_normalized_component " << injector_creation_from_normalized_component_time
+                << std::endl;
+      std::cout << "injection " << injection_time << std::endl;
+      std::cout << "injector_creation_from_component " << injector_creation_from_component_time << std::endl;
+      std::cout << "result " << result << std::endl;
+      return 0;
+    }
+''')
+
+
+def generate_driver_source(max_typed_bindings: int) -> str:
+    """Returns the source of the driver, with the tables of the typed bindings [0, max_typed_bindings)."""
+    typed_components = ',\n'.join('    TypedBinding<%s>::getComponent' % i for i in range(max_typed_bindings))
+    typed_injects = ',\n'.join('    TypedBinding<%s>::inject' % i for i in range(max_typed_bindings))
+    return ('#define MAX_TYPED_BINDINGS %s\n\n' % max_typed_bindings
+            + DRIVER_SOURCE
+            + '\nconst TypedComponentFunction typed_components[] = {\n%s\n};\n' % typed_components
+            + '\nconst TypedInjectFunction typed_injects[] = {\n%s\n};\n' % typed_injects)
+
+
+class Graph:
+    """A graph of components to be read by the driver. Node 0 is the one installed by the root component."""
+    def __init__(self, num_typed_bindings: int = 0):
+        self.num_typed_bindings = num_typed_bindings
+        self.adds_multibinding = []  # type: List[bool]
+        self.replaces_leaf = []  # type: List[bool]
+        self.installs = []  # type: List[List[int]]
+
+    def add_node(self, installs: List[int], adds_multibinding: bool = False, replaces_leaf: bool = False) -> None:
+        self.adds_multibinding.append(adds_multibinding)
+        self.replaces_leaf.append(replaces_leaf)
+        self.installs.append(installs)
+
+    def write(self, path: str) -> None:
+        with open(path, 'w') as file:
+            file.write('%s %s\n' % (self.num_typed_bindings, len(self.installs)))
+            for adds_multibinding, replaces_leaf, installs in zip(self.adds_multibinding, self.replaces_leaf, self.installs):
+                file.write('%d %d %s %s\n' % (adds_multibinding, replaces_leaf, len(installs), ' '.join(str(i) for i in installs)))
+
+
+def random_dag(n: int, rng: random.Random) -> Graph:
+    # Each node installs a few random nodes with a higher index, and node 0 installs all the nodes that would otherwise
+    # be unreachable.
+    graph = Graph()
+    reachable = [False] * n
+    all_installs = []
+    for i in range(n):
+        installs = sorted(set(rng.randrange(i + 1, n) for _ in range(min(3, n - i - 1))))
+        for j in installs:
+            reachable[j] = True
+        all_installs.append(installs)
+    all_installs[0] += [j for j in range(1, n) if not reachable[j]]
+    for i in range(n):
+        graph.add_node(all_installs[i], adds_multibinding=rng.random() < 0.5)
+    return graph
+
+
+def deep_nesting(n: int, rng: random.Random) -> Graph:
+    # A single chain of installs, n components deep.
+    graph = Graph()
+    for i in range(n):
+        graph.add_node([i + 1] if i + 1 < n else [], adds_multibinding=True)
+    return graph
+
+
+def parameterized_installs(n: int, rng: random.Random) -> Graph:
+    # A few hub nodes installed by every other node, so that most installs are duplicates that must be de-duplicated.
+    graph = Graph()
+    num_hubs = 8
+    graph.add_node(list(range(1, n)))
+    for i in range(1, n):
+        hubs = [j for j in range(max(1, n - num_hubs), n) if j > i]
+        graph.add_node(hubs + rng.sample(range(i + 1, n), min(4, n - i - 1)), adds_multibinding=True)
+    return graph
+
+
+def replacements(n: int, rng: random.Random) -> Graph:
+    # Half of the nodes replace the leaf component that they install.
+    graph = Graph()
+    graph.add_node(list(range(1, n)))
+    for i in range(1, n):
+        graph.add_node([], adds_multibinding=True, replaces_leaf=rng.random() < 0.5)
+    return graph
+
+
+def multibindings(n: int, rng: random.Random) -> Graph:
+    # A wide and shallow graph where every component adds a multibinding.
+    graph = Graph()
+    width = max(1, int(n ** 0.5))
+    graph.add_node(list(range(1, min(n, width + 1))), adds_multibinding=True)
+    for i in range(1, n):
+        graph.add_node([j for j in range(i * width + 1, (i + 1) * width + 1) if j < n], adds_multibinding=True)
+    return graph
+
+
+def typed_bindings(n: int, rng: random.Random) -> Graph:
+    return Graph(num_typed_bindings=n)
+
+
+SCENARIOS = {
+    'random_dag': random_dag,
+    'deep_nesting': deep_nesting,
+    'parameterized_installs': parameterized_installs,
+    'replacements': replacements,
+    'multibindings': multibindings,
+    'typed_bindings': typed_bindings,
+}
+
+
+def fit_exponent(sizes: List[int], times: List[float]) -> float:
+    """Returns k such that times ~= c*sizes^k, with a least-squares fit in log-log space."""
+    k, _ = numpy.polyfit(numpy.log(sizes), numpy.log(times), 1)
+    return k
+
+
+def n_log_n_exponent(sizes: List[int]) -> float:
+    """The exponent that fit_exponent() would return for times exactly proportional to n*log(n)."""
+    return fit_exponent(sizes, [n * numpy.log(n) for n in sizes])
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Flags the phases of Fruit that scale worse than n*log(n).')
+    parser.add_argument('--fruit-sources-dir', required=True, help='Path to the fruit sources')
+    parser.add_argument('--fruit-build-dir', required=True, help='Path to a Fruit build dir (with libfruit built)')
+    parser.add_argument('--cxx', default='g++', help='The C++ compiler to use')
+    parser.add_argument('--cxx-std', default='c++11', help='The C++ standard to use')
+    parser.add_argument('--scenarios', default=','.join(SCENARIOS.keys()),
+                        help='Comma-separated list of the scenarios to run')
+    parser.add_argument('--min-size', type=int, default=256, help='The size of the smallest graphs')
+    parser.add_argument('--max-size', type=int, default=8192, help='The size of the largest graphs')
+    parser.add_argument('--max-typed-bindings', type=int, default=1024,
+                        help='The size of the largest typed_bindings graphs (each one is a different type, so this '
+                             'affects the compile time of the driver)')
+    parser.add_argument('--repetitions', type=int, default=5,
+                        help='Each phase is run this many times for each graph, and the fastest run is used')
+    parser.add_argument('--min-time', type=float, default=0.00002,
+                        help='Timings (in seconds) below this are too noisy and are not used for the fit')
+    parser.add_argument('--tolerance', type=float, default=0.2,
+                        help='How much the fitted exponent can exceed the n*log(n) one before the phase is flagged')
+    parser.add_argument('--seed', type=int, default=0, help='The seed for the random graphs')
+    args = parser.parse_args()
+
+    for scenario in args.scenarios.split(','):
+        if scenario not in SCENARIOS:
+            raise Exception('Unknown scenario: %s. The known scenarios are: %s' % (scenario, ', '.join(SCENARIOS.keys())))
+
+    tmpdir = tempfile.gettempdir() + '/fruit-complexity-fuzzer-dir'
+    ensure_empty_dir(tmpdir)
+    with open(tmpdir + '/main.cpp', 'w') as file:
+        file.write(generate_driver_source(args.max_typed_bindings))
+    print('Compiling the driver...', flush=True)
+    fruit_build_dir = os.path.abspath(args.fruit_build_dir)
+    run_command(args.cxx,
+                args=[
+                    '-O2',
+                    '-DNDEBUG',
+                    '-std=%s' % args.cxx_std,
+                    '-ftemplate-depth=%s' % (args.max_typed_bindings + 1000),
+                    '-I', args.fruit_sources_dir + '/include',
+                    '-I', fruit_build_dir + '/include',
+                    tmpdir + '/main.cpp',
+                    '-o', tmpdir + '/main',
+                    '-L', fruit_build_dir + '/src',
+                    '-Wl,-rpath,' + fruit_build_dir + '/src',
+                    '-lfruit',
+                ])
+
+    flagged = []  # type: List[Tuple[str, str, float, float]]
+    for scenario in args.scenarios.split(','):
+        max_size = args.max_size if scenario != 'typed_bindings' else min(args.max_size, args.max_typed_bindings)
+        sizes = []  # type: List[int]
+        size = args.min_size
+        while size <= max_size:
+            sizes.append(size)
+            size *= 2
+        if len(sizes) < 3:
+            raise Exception('At least 3 sizes are needed to fit a curve, but the sizes for %s are only %s' % (scenario, sizes))
+
+        times_by_phase = {phase: [] for phase in PHASES}  # type: Dict[str, List[float]]
+        for size in sizes:
+            graph = SCENARIOS[scenario](size, random.Random('%s-%s-%s' % (args.seed, scenario, size)))
+            graph.write(tmpdir + '/graph.txt')
+            stdout, _ = run_command(tmpdir + '/main', args=[tmpdir + '/graph.txt', args.repetitions])
+            results = dict(line.split() for line in stdout.splitlines())
+            for phase in PHASES:
+                times_by_phase[phase].append(float(results[phase]))
+
+        expected_exponent = n_log_n_exponent(sizes)
+        print('\n%s (sizes %s..%s, n*log(n) exponent: %.2f)' % (scenario, sizes[0], sizes[-1], expected_exponent))
+        for phase in PHASES:
+            times = times_by_phase[phase]
+            formatted_times = ' '.join('%.3f' % (time * 1000) for time in times)
+            measurable_sizes = [size for size, time in zip(sizes, times) if time >= args.min_time]
+            measurable_times = [time for time in times if time >= args.min_time]
+            if len(measurable_times) < 3:
+                print('  %-45s too fast to measure       times (ms): %s' % (phase, formatted_times))
+                continue
+            # The exponent of n*log(n) is a bit higher when only considering the larger sizes.
+            phase_expected_exponent = n_log_n_exponent(measurable_sizes)
+            exponent = fit_exponent(measurable_sizes, measurable_times)
+            is_flagged = exponent > phase_expected_exponent + args.tolerance
+            if is_flagged:
+                flagged.append((scenario, phase, exponent, phase_expected_exponent))
+            print('  %-45s exponent %5.2f  %s  times (ms): %s' % (
+                phase, exponent, 'FLAGGED' if is_flagged else 'ok     ', formatted_times))
+
+    if flagged:
+        print('\nThese phases grow faster than n*log(n):')
+        for scenario, phase, exponent, expected_exponent in flagged:
+            print('  %s / %s: exponent %.2f (expected at most %.2f)' % (scenario, phase, exponent, expected_exponent))
+        sys.exit(1)
+    print('\nAll phases grow at most as n*log(n).')
+
+
+if __name__ == '__main__':
+    main()
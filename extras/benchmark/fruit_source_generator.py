@@ -16,28 +16,92 @@ from typing import List
 import networkx as nx
 
 
-def generate_files(injection_graph: nx.DiGraph, generate_runtime_bench_code: bool, use_normalized_component: bool=False):
+def generate_files(injection_graph: nx.DiGraph, generate_runtime_bench_code: bool, use_normalized_component: bool=False,
+                   use_single_threaded_injector: bool=False, use_replace: bool=False, use_component_args: bool=False,
+                   use_multibindings: bool=False, use_binding_compression_undo: bool=False):
+    """Generates the sources for a Fruit benchmark.
+
+    The following options make the generated code exercise some features (and their slow paths) at scale:
+
+    :param use_replace: each component with no deps gets a replacement component, and the toplevel component replaces
+        each of them (using replace(...).with(...)).
+    :param use_component_args: all component functions take an int argument, so they're installed as components with
+        args (that need to be hashed, compared and copied).
+    :param use_multibindings: each component also registers a multibinding for its interface.
+    :param use_binding_compression_undo: the injector is created with an additional component that depends directly
+        on the implementation class of each component with no deps. These bindings were compressed in the
+        NormalizedComponent, so the compression has to be undone when creating each injector.
+    """
     if use_normalized_component:
         assert not generate_runtime_bench_code
 
+    options = _Options(use_single_threaded_injector=use_single_threaded_injector,
+                       use_replace=use_replace,
+                       use_component_args=use_component_args,
+                       use_multibindings=use_multibindings,
+                       use_binding_compression_undo=use_binding_compression_undo)
+
     file_content_by_name = dict()
 
+    leaf_nodes = [node_id
+                  for node_id in injection_graph.nodes
+                  if not any(True for s in injection_graph.successors(node_id))]
+
     for node_id in injection_graph.nodes:
-        file_content_by_name['component%s.h' % node_id] = _generate_component_header(node_id)
-        file_content_by_name['component%s.cpp' % node_id] = _generate_component_source(node_id, list(injection_graph.successors(node_id)))
+        is_leaf = node_id in leaf_nodes
+        file_content_by_name['component%s.h' % node_id] = _generate_component_header(node_id, is_leaf, options)
+        file_content_by_name['component%s.cpp' % node_id] = _generate_component_source(
+            node_id, list(injection_graph.successors(node_id)), is_leaf, options)
 
     [toplevel_node] = [node_id
                        for node_id in injection_graph.nodes
                        if not any(True for p in injection_graph.predecessors(node_id))]
-    file_content_by_name['main.cpp'] = _generate_main(toplevel_node, generate_runtime_bench_code)
+    file_content_by_name['main.cpp'] = _generate_main(toplevel_node, sorted(leaf_nodes), generate_runtime_bench_code,
+                                                      options)
 
     return file_content_by_name
 
+class _Options:
+    def __init__(self, use_single_threaded_injector: bool, use_replace: bool, use_component_args: bool,
+                 use_multibindings: bool, use_binding_compression_undo: bool):
+        self.use_single_threaded_injector = use_single_threaded_injector
+        self.use_replace = use_replace
+        self.use_component_args = use_component_args
+        self.use_multibindings = use_multibindings
+        self.use_binding_compression_undo = use_binding_compression_undo
+
 def _get_component_type(component_index: int):
     return 'fruit::Component<Interface{component_index}>'.format(**locals())
 
-def _generate_component_header(component_index: int):
+def _get_component_params(options: _Options):
+    return 'int' if options.use_component_args else ''
+
+# Returns the arguments to pass after the component function in install(), replace(), etc.
+# When the components have args, we pass the component index, so that each component is always installed with the same
+# value.
+def _get_component_args(component_index: int, options: _Options):
+    return ', %s' % component_index if options.use_component_args else ''
+
+def _generate_component_header(component_index: int, is_leaf: bool, options: _Options):
     component_type = _get_component_type(component_index)
+    component_params = _get_component_params(options)
+
+    declarations = ''
+    if is_leaf and options.use_binding_compression_undo:
+        # The implementation class is visible here so that other components can depend on it directly.
+        declarations += """
+struct X{component_index} : public Interface{component_index} {{
+  INJECT(X{component_index}()) = default;
+}};
+"""
+    declarations += """
+{component_type} getComponent{component_index}({component_params});
+"""
+    if is_leaf and options.use_replace:
+        declarations += """
+{component_type} getReplacementComponent{component_index}({component_params});
+"""
+
     template = """
 #ifndef COMPONENT{component_index}_H
 #define COMPONENT{component_index}_H
@@ -50,14 +114,12 @@ def _generate_component_header(component_index: int):
 struct Interface{component_index} {{
   virtual ~Interface{component_index}() = default;
 }};
-
-{component_type} getComponent{component_index}();
-
+""" + declarations + """
 #endif // COMPONENT{component_index}_H
 """
     return template.format(**locals())
 
-def _generate_component_source(component_index: int, deps: List[int]):
+def _generate_component_source(component_index: int, deps: List[int], is_leaf: bool, options: _Options):
     include_directives = ''.join(['#include "component%s.h"\n' % index for index in deps + [component_index]])
 
     fields = ''.join(['Interface%s& x%s;\n' % (dep, dep)
@@ -70,11 +132,15 @@ def _generate_component_source(component_index: int, deps: List[int]):
     if param_initializers:
         param_initializers = ': ' + param_initializers
 
-    install_expressions = ''.join(['        .install(getComponent%s)\n' % dep for dep in deps])
+    install_expressions = ''.join(['        .install(getComponent%s%s)\n' % (dep, _get_component_args(dep, options))
+                                   for dep in deps])
 
     component_type = _get_component_type(component_index)
+    component_params = _get_component_params(options)
 
-    template = """
+    template = ''
+    if not (is_leaf and options.use_binding_compression_undo):
+        template += """
 {include_directives}
 
 namespace {{
@@ -88,21 +154,98 @@ struct X{component_index} : public Interface{component_index} {{
 }}
 
 """
+    else:
+        # X{component_index} is defined in the header.
+        template += """
+{include_directives}
+
+"""
+
+    multibinding_expressions = ''
+    if options.use_multibindings:
+        multibinding_expressions = '\n        .addMultibinding<Interface{component_index}, X{component_index}>()'
 
     template += """
-{component_type} getComponent{component_index}() {{
+{component_type} getComponent{component_index}({component_params}) {{
     return fruit::createComponent(){install_expressions}
-        .bind<Interface{component_index}, X{component_index}>();
+        .bind<Interface{component_index}, X{component_index}>()""" + multibinding_expressions + """;
+}}
+"""
+
+    if is_leaf and options.use_replace:
+        replacement_multibinding_expressions = ''
+        if options.use_multibindings:
+            replacement_multibinding_expressions = \
+                '\n        .addMultibinding<Interface{component_index}, Y{component_index}>()'
+        template += """
+namespace {{
+struct Y{component_index} : public Interface{component_index} {{
+  INJECT(Y{component_index}()) = default;
+}};
+}}
+
+{component_type} getReplacementComponent{component_index}({component_params}) {{
+    return fruit::createComponent()
+        .bind<Interface{component_index}, Y{component_index}>()""" + replacement_multibinding_expressions + """;
 }}
 """
 
     return template.format(**locals())
 
-def _generate_main(toplevel_component: int, generate_runtime_bench_code: bool):
+def _generate_main(toplevel_component: int, leaf_components: List[int], generate_runtime_bench_code: bool,
+                   options: _Options):
+    injector_args_prefix = 'fruit::SingleThreaded(), ' if options.use_single_threaded_injector else ''
+
+    include_directives = '#include "component%s.h"\n' % toplevel_component
+    if options.use_replace or options.use_binding_compression_undo:
+        include_directives += ''.join('#include "component%s.h"\n' % leaf for leaf in leaf_components)
+
+    toplevel_component_type = _get_component_type(toplevel_component)
+    toplevel_component_args = _get_component_args(toplevel_component, options)
+    if options.use_replace:
+        replace_expressions = ''.join(
+            '        .replace(getComponent{leaf}{args}).with(getReplacementComponent{leaf}{args})\n'.format(
+                leaf=leaf, args=_get_component_args(leaf, options))
+            for leaf in leaf_components)
+        definitions = """
+{toplevel_component_type} getRootComponent() {{
+    return fruit::createComponent()
+{replace_expressions}        .install(getComponent{toplevel_component}{toplevel_component_args});
+}}
+""".format(**locals())
+        normalized_component_args = 'getRootComponent'
+    else:
+        definitions = ''
+        normalized_component_args = 'getComponent%s%s' % (toplevel_component, toplevel_component_args)
+
+    if options.use_binding_compression_undo:
+        user_types = ['User%s' % leaf for leaf in leaf_components]
+        definitions += ''.join("""
+struct User{leaf} {{
+  INJECT(User{leaf}(X{leaf}*)) {{}}
+}};
+""".format(leaf=leaf) for leaf in leaf_components)
+        definitions += """
+fruit::Component<{user_types}> getAdditionalComponent() {{
+  return fruit::createComponent();
+}}
+""".format(user_types=', '.join(user_types))
+        injector_type = 'fruit::Injector<%s>' % ', '.join(['Interface%s' % toplevel_component] + user_types)
+    else:
+        definitions += """
+fruit::Component<> getAdditionalComponent() {
+  return fruit::createComponent();
+}
+"""
+        injector_type = 'fruit::Injector<Interface%s>' % toplevel_component
+
+    injector_uses = 'injector.get<std::shared_ptr<Interface%s>>();' % toplevel_component
+    if options.use_multibindings:
+        injector_uses += '\n    injector.getMultibindings<Interface%s>();' % toplevel_component
+
     if generate_runtime_bench_code:
         template = """
-#include "component{toplevel_component}.h"
-
+{include_directives}
 #include <ctime>
 #include <iostream>
 #include <cstdlib>
@@ -110,11 +253,7 @@ def _generate_main(toplevel_component: int, generate_runtime_bench_code: bool):
 #include <chrono>
 
 using namespace std;
-
-fruit::Component<> getEmptyComponent() {{
-  return fruit::createComponent();
-}}
-
+{definitions}
 int main(int argc, char* argv[]) {{
   if (argc != 2) {{
     std::cout << "Need to specify num_loops as argument." << std::endl;
@@ -122,12 +261,12 @@ int main(int argc, char* argv[]) {{
   }}
   size_t num_loops = std::atoi(argv[1]);
   
-  fruit::NormalizedComponent<Interface{toplevel_component}> normalizedComponent(getComponent{toplevel_component});
+  fruit::NormalizedComponent<Interface{toplevel_component}> normalizedComponent({normalized_component_args});
     
   std::chrono::high_resolution_clock::time_point start_time = std::chrono::high_resolution_clock::now();
   for (size_t i = 0; i < num_loops; i++) {{
-    fruit::Injector<Interface{toplevel_component}> injector(normalizedComponent, getEmptyComponent);
-    injector.get<std::shared_ptr<Interface{toplevel_component}>>();
+    {injector_type} injector({injector_args_prefix}normalizedComponent, getAdditionalComponent);
+    {injector_uses}
   }}
   double perRequestTime = std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::high_resolution_clock::now() - start_time).count();
 
@@ -139,18 +278,13 @@ int main(int argc, char* argv[]) {{
     """
     else:
         template = """
-#include "component{toplevel_component}.h"
-
+{include_directives}
 #include <iostream>
-
-fruit::Component<> getEmptyComponent() {{
-  return fruit::createComponent();
-}}
-
+{definitions}
 int main(void) {{
-  fruit::NormalizedComponent<Interface{toplevel_component}> normalizedComponent(getComponent{toplevel_component});
-  fruit::Injector<Interface{toplevel_component}> injector(normalizedComponent, getEmptyComponent);
-  injector.get<std::shared_ptr<Interface{toplevel_component}>>();
+  fruit::NormalizedComponent<Interface{toplevel_component}> normalizedComponent({normalized_component_args});
+  {injector_type} injector({injector_args_prefix}normalizedComponent, getAdditionalComponent);
+  {injector_uses}
   std::cout << "Hello, world" << std::endl;
   return 0;
 }}
@@ -47,7 +47,7 @@ def generate_injection_graph(num_components_with_no_deps: int,
             # We need at least 1 dep with deps, otherwise the last few components will not be enough
             # to tie together all components.
             num_deps_with_deps = len(toplevel_components) - (num_components_with_deps - 1 - i) * (num_deps - 1)
-            deps |= set(random.sample(toplevel_components, num_deps_with_deps))
+            deps |= set(random.sample(sorted(toplevel_components), num_deps_with_deps))
 
         # Add other deps to get to the desired num_deps.
         deps |= set(random.sample(range(0, num_components_with_no_deps + i), num_deps - len(deps)))
@@ -87,7 +87,12 @@ def generate_benchmark(
         generate_debuginfo: bool=False,
         use_new_delete: bool=False,
         use_interfaces: bool=False,
-        use_normalized_component: bool=False):
+        use_normalized_component: bool=False,
+        use_single_threaded_injector: bool=False,
+        use_replace: bool=False,
+        use_component_args: bool=False,
+        use_multibindings: bool=False,
+        use_binding_compression_undo: bool=False):
     """Generates a sample codebase using the specified DI library, meant for benchmarking.
 
     :param boost_di_sources_dir: this is only used if di_library=='boost_di', it can be None otherwise.
@@ -107,7 +112,12 @@ def generate_benchmark(
                                                num_deps=num_deps)
 
     if di_library == 'fruit':
-        file_content_by_name = fruit_source_generator.generate_files(injection_graph, generate_runtime_bench_code)
+        file_content_by_name = fruit_source_generator.generate_files(injection_graph, generate_runtime_bench_code,
+                                                                     use_single_threaded_injector=use_single_threaded_injector,
+                                                                     use_replace=use_replace,
+                                                                     use_component_args=use_component_args,
+                                                                     use_multibindings=use_multibindings,
+                                                                     use_binding_compression_undo=use_binding_compression_undo)
         include_dirs = [fruit_build_dir + '/include', fruit_sources_dir + '/include']
         library_dirs = [fruit_build_dir + '/src']
         link_libraries = ['fruit']
@@ -169,6 +179,11 @@ def main():
     parser.add_argument('--use-new-delete', default='false', help='Set this to \'true\' to use new/delete. Only relevant when --di_library=none.')
     parser.add_argument('--use-interfaces', default='false', help='Set this to \'true\' to use interfaces. Only relevant when --di_library=none.')
     parser.add_argument('--use-normalized-component', default='false', help='Set this to \'true\' to create a NormalizedComponent and create the injector from that. Only relevant when --di_library=fruit and --generate-runtime-bench-code=false.')
+    parser.add_argument('--use-single-threaded-injector', default='false', help='Set this to \'true\' to construct the injectors with fruit::SingleThreaded(), so that they don\'t do any locking. Only relevant when --di_library=fruit.')
+    parser.add_argument('--use-replace', default='false', help='Set this to \'true\' to replace each component with no deps (using replace(...).with(...)). Only relevant when --di_library=fruit.')
+    parser.add_argument('--use-component-args', default='false', help='Set this to \'true\' to make all component functions take an argument. Only relevant when --di_library=fruit.')
+    parser.add_argument('--use-multibindings', default='false', help='Set this to \'true\' to also register a multibinding in each component. Only relevant when --di_library=fruit.')
+    parser.add_argument('--use-binding-compression-undo', default='false', help='Set this to \'true\' to create the injectors with an additional component that forces Fruit to undo some binding compressions done in the NormalizedComponent. Only relevant when --di_library=fruit.')
     parser.add_argument('--generate-runtime-bench-code', default='true', help='Set this to \'false\' for compile benchmarks.')
     parser.add_argument('--generate-debuginfo', default='false', help='Set this to \'true\' to generate debugging information (-g).')
     parser.add_argument('--use-exceptions', default='true', help='Set this to \'false\' to disable exceptions.')
@@ -214,6 +229,11 @@ def main():
         use_new_delete=(args.use_new_delete == 'true'),
         use_interfaces=(args.use_interfaces == 'true'),
         use_normalized_component=(args.use_normalized_component == 'true'),
+        use_single_threaded_injector=(args.use_single_threaded_injector == 'true'),
+        use_replace=(args.use_replace == 'true'),
+        use_component_args=(args.use_component_args == 'true'),
+        use_multibindings=(args.use_multibindings == 'true'),
+        use_binding_compression_undo=(args.use_binding_compression_undo == 'true'),
         generate_runtime_bench_code=(args.generate_runtime_bench_code == 'true'),
         use_exceptions=(args.use_exceptions == 'true'),
         use_rtti=(args.use_rtti == 'true'))
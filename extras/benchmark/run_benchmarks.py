@@ -214,6 +214,54 @@ class FruitSingleFileCompileTimeBenchmark(Benchmark):
         return self.benchmark_definition
 
 
+class FruitComponentDeclarationsCompileTimeBenchmark(Benchmark):
+    """Compile time of a source file that only declares component functions, as most headers in a large codebase would.
+
+    Comparing `header: "fruit_forward_decls.h"` with `header: "component.h"` gives the per-TU savings of including the
+    forward declarations only.
+    """
+    def __init__(self, benchmark_definition: Dict[str, Any], fruit_sources_dir: str, fruit_build_dir: str):
+        self.benchmark_definition = add_synthetic_benchmark_parameters(benchmark_definition, path_to_code_under_test=fruit_sources_dir)
+        self.fruit_sources_dir = fruit_sources_dir
+        self.fruit_build_dir = fruit_build_dir
+
+    def prepare(self):
+        header = self.benchmark_definition['header']
+        num_declarations = self.benchmark_definition['num_declarations']
+
+        self.tmpdir = tempfile.gettempdir() + '/fruit-benchmark-dir'
+        ensure_empty_dir(self.tmpdir)
+        with open(self.tmpdir + '/main.cpp', 'w') as file:
+            file.write('#include <fruit/%s>\n\n' % header)
+            for i in range(num_declarations):
+                file.write('struct Annotation%s;\n' % i)
+                file.write('struct X%s;\n' % i)
+                file.write('struct Y%s;\n' % i)
+                file.write('fruit::Component<fruit::Required<X%s>, fruit::Annotated<Annotation%s, Y%s>> getY%sComponent();\n\n'
+                           % (i, i, i, i))
+
+    def run(self):
+        cxx_std = self.benchmark_definition['cxx_std']
+        compiler_executable_name = self.benchmark_definition['compiler']
+
+        start = timer()
+        run_command(compiler_executable_name,
+                    args = compile_flags + [
+                        '-std=%s' % cxx_std,
+                        '-I', self.fruit_sources_dir + '/include',
+                        '-I', self.fruit_build_dir + '/include',
+                        '-c',
+                        self.tmpdir + '/main.cpp',
+                        '-o',
+                        '/dev/null',
+                    ])
+        end = timer()
+        return {"compile_time": end - start}
+
+    def describe(self):
+        return self.benchmark_definition
+
+
 def ensure_empty_dir(dirname: str):
     # We start by creating the directory instead of just calling rmtree with ignore_errors=True because that would ignore
     # all errors, so we might otherwise go ahead even if the directory wasn't properly deleted.
@@ -335,6 +383,16 @@ class GenericGeneratedSourcesBenchmark(Benchmark):
         num_bytes = wc_result.splitlines()[0].split(' ')[0]
         return {'num_bytes': float(num_bytes)}
 
+    def run_executable_symbols_size_benchmark(self):
+        result = self.run_executable_size_benchmark()
+        # The (mangled) symbol names end up in .strtab/.dynstr and also dominate the size of the debug info and the
+        # link time, so we measure their total size separately.
+        nm_result, _ = run_command('nm', args=['--format=posix', self.tmpdir + '/main'])
+        symbol_names = [line.split(' ')[0] for line in nm_result.splitlines() if line]
+        result['num_symbol_name_bytes'] = float(sum(len(name) for name in symbol_names))
+        result['max_symbol_name_length'] = float(max((len(name) for name in symbol_names), default=0))
+        return result
+
     def describe(self):
         return self.benchmark_definition
 
@@ -406,6 +464,19 @@ class ExecutableSizeBenchmark(GenericGeneratedSourcesBenchmark):
     def run(self):
         return self.run_executable_size_benchmark()
 
+# This is not really a 'benchmark', but we consider it as such to reuse the benchmark infrastructure.
+# Unlike ExecutableSizeBenchmark, this doesn't strip the executable.
+class ExecutableSymbolsSizeBenchmark(GenericGeneratedSourcesBenchmark):
+    def __init__(self, **kwargs):
+        super().__init__(generate_runtime_bench_code=False,
+                         **kwargs)
+
+    def prepare(self):
+        self.prepare_runtime_benchmark()
+
+    def run(self):
+        return self.run_executable_symbols_size_benchmark()
+
 # This is not really a 'benchmark', but we consider it as such to reuse the benchmark infrastructure.
 class ExecutableSizeBenchmarkWithoutExceptionsAndRtti(ExecutableSizeBenchmark):
     def __init__(self, **kwargs):
@@ -461,6 +532,14 @@ class FruitExecutableSizeBenchmark(ExecutableSizeBenchmark):
                          fruit_sources_dir=fruit_sources_dir,
                          **kwargs)
 
+# This is not really a 'benchmark', but we consider it as such to reuse the benchmark infrastructure.
+class FruitExecutableSymbolsSizeBenchmark(ExecutableSymbolsSizeBenchmark):
+    def __init__(self, fruit_sources_dir, **kwargs):
+        super().__init__(di_library='fruit',
+                         path_to_code_under_test=fruit_sources_dir,
+                         fruit_sources_dir=fruit_sources_dir,
+                         **kwargs)
+
 # This is not really a 'benchmark', but we consider it as such to reuse the benchmark infrastructure.
 class FruitExecutableSizeBenchmarkWithoutExceptionsAndRtti(ExecutableSizeBenchmarkWithoutExceptionsAndRtti):
     def __init__(self, fruit_sources_dir, **kwargs):
@@ -806,6 +885,11 @@ def main():
                     fruit_sources_dir=args.fruit_sources_dir,
                     fruit_benchmark_sources_dir=args.fruit_benchmark_sources_dir,
                     fruit_build_dir=fruit_build_dir)
+            elif benchmark_name == 'fruit_component_declarations_compile_time':
+                benchmark = FruitComponentDeclarationsCompileTimeBenchmark(
+                    benchmark_definition,
+                    fruit_sources_dir=args.fruit_sources_dir,
+                    fruit_build_dir=fruit_build_dir)
             elif benchmark_name.startswith('fruit_'):
                 benchmark_class = {
                     'fruit_compile_time': FruitCompileTimeBenchmark,
@@ -815,6 +899,7 @@ def main():
                     'fruit_startup_time': FruitStartupTimeBenchmark,
                     'fruit_startup_time_with_normalized_component': FruitStartupTimeWithNormalizedComponentBenchmark,
                     'fruit_executable_size': FruitExecutableSizeBenchmark,
+                    'fruit_executable_symbols_size': FruitExecutableSymbolsSizeBenchmark,
                     'fruit_executable_size_without_exceptions_and_rtti': FruitExecutableSizeBenchmarkWithoutExceptionsAndRtti,
                 }[benchmark_name]
                 benchmark = benchmark_class(
@@ -0,0 +1,185 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Displays the stats exported by an injector with Injector::enableStatsExport(), from a separate process.
+//
+// Usage: fruit_stats_reader <segment_name> [--top=<num_bindings>] [--interval=<seconds>]
+//
+// With --interval, the stats are printed again every <seconds> seconds until the segment is removed (i.e. until the
+// injector is destroyed) or the process is interrupted. This only maps the segment read-only, so it can't affect the
+// monitored process other than by reading the same memory.
+
+#include <fruit/impl/injector/injector_stats_segment.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using fruit::impl::InjectorStatsSegment;
+
+namespace {
+
+struct MappedSegment {
+  const InjectorStatsSegment::Header* header = nullptr;
+  std::size_t size = 0;
+};
+
+// Returns a segment with header==nullptr (after printing an error) if the segment can't be mapped or is not valid.
+MappedSegment mapSegment(const std::string& segment_name) {
+  MappedSegment result;
+  int fd = shm_open(segment_name.c_str(), O_RDONLY, 0);
+  if (fd < 0) {
+    std::cerr << "Can't open the shared memory segment " << segment_name << ": " << std::strerror(errno) << std::endl;
+    return result;
+  }
+  struct stat segment_stat;
+  if (fstat(fd, &segment_stat) != 0 || std::size_t(segment_stat.st_size) < sizeof(InjectorStatsSegment::Header)) {
+    std::cerr << "The shared memory segment " << segment_name << " is not a Fruit stats segment." << std::endl;
+    close(fd);
+    return result;
+  }
+  std::size_t size = segment_stat.st_size;
+  void* p = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (p == MAP_FAILED) {
+    std::cerr << "Can't map the shared memory segment " << segment_name << ": " << std::strerror(errno) << std::endl;
+    return result;
+  }
+  const InjectorStatsSegment::Header* header = static_cast<const InjectorStatsSegment::Header*>(p);
+  if (header->magic.load(std::memory_order_acquire) != InjectorStatsSegment::magic_value ||
+      header->version != InjectorStatsSegment::current_version ||
+      size < InjectorStatsSegment::getSegmentSize(header->num_binding_slots)) {
+    std::cerr << "The shared memory segment " << segment_name
+              << " is not a Fruit stats segment, or it was written by an incompatible version of Fruit." << std::endl;
+    munmap(p, size);
+    return result;
+  }
+  result.header = header;
+  result.size = size;
+  return result;
+}
+
+double toMillis(std::uint64_t nanos) {
+  return nanos / 1000000.0;
+}
+
+void printStats(const InjectorStatsSegment::Header& header, std::size_t max_num_bindings) {
+  std::uint64_t num_lock_acquisitions = header.num_lock_acquisitions.load(std::memory_order_relaxed);
+  std::uint64_t num_lock_waits = header.num_lock_waits.load(std::memory_order_relaxed);
+  std::cout << "pid:                 " << header.pid << "\n"
+            << "constructions:       " << header.num_constructions.load(std::memory_order_relaxed) << "\n"
+            << "lock acquisitions:   " << num_lock_acquisitions << "\n"
+            << "lock waits:          " << num_lock_waits << " (" << std::fixed << std::setprecision(3)
+            << toMillis(header.lock_wait_nanos.load(std::memory_order_relaxed)) << " ms total)\n"
+            << "arena usage (bytes): " << header.arena_used_bytes.load(std::memory_order_relaxed) << " / "
+            << header.arena_capacity_bytes.load(std::memory_order_relaxed) << "\n";
+
+  struct BindingStats {
+    const InjectorStatsSegment::BindingSlot* slot;
+    std::uint64_t num_constructions;
+    std::uint64_t construction_nanos;
+  };
+  std::vector<BindingStats> binding_stats;
+  const InjectorStatsSegment::BindingSlot* slots = InjectorStatsSegment::getBindingSlots(&header);
+  for (std::size_t i = 0; i < header.num_binding_slots; ++i) {
+    std::uint64_t num_constructions = slots[i].num_constructions.load(std::memory_order_relaxed);
+    if (num_constructions != 0) {
+      binding_stats.push_back(
+          BindingStats{&slots[i], num_constructions, slots[i].construction_nanos.load(std::memory_order_relaxed)});
+    }
+  }
+  std::sort(binding_stats.begin(), binding_stats.end(), [](const BindingStats& x, const BindingStats& y) {
+    return x.construction_nanos > y.construction_nanos;
+  });
+  if (binding_stats.size() > max_num_bindings) {
+    binding_stats.resize(max_num_bindings);
+  }
+
+  std::cout << "\n" << std::setw(14) << "time (ms)" << std::setw(10) << "count"
+            << "  type\n";
+  for (const BindingStats& stats : binding_stats) {
+    // The name is NUL-terminated by the writer, but we don't rely on that.
+    std::string type_name(stats.slot->type_name,
+                          strnlen(stats.slot->type_name, sizeof(stats.slot->type_name)));
+    std::cout << std::setw(14) << std::fixed << std::setprecision(3) << toMillis(stats.construction_nanos)
+              << std::setw(10) << stats.num_constructions << "  " << type_name
+              << (stats.slot->is_multibinding ? " (multibindings)" : "") << "\n";
+  }
+  std::cout << std::flush;
+}
+
+bool parseFlag(const std::string& arg, const std::string& flag_prefix, long& value) {
+  if (arg.compare(0, flag_prefix.size(), flag_prefix) != 0) {
+    return false;
+  }
+  char* end = nullptr;
+  value = std::strtol(arg.c_str() + flag_prefix.size(), &end, 10);
+  return *end == '\0' && value > 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  std::string segment_name;
+  long max_num_bindings = 20;
+  long interval_seconds = 0;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg.compare(0, 2, "--") != 0 && segment_name.empty()) {
+      segment_name = arg;
+    } else if (!parseFlag(arg, "--top=", max_num_bindings) && !parseFlag(arg, "--interval=", interval_seconds)) {
+      segment_name.clear();
+      break;
+    }
+  }
+  if (segment_name.empty()) {
+    std::cerr << "Usage: " << argv[0] << " <segment_name> [--top=<num_bindings>] [--interval=<seconds>]"
+              << std::endl;
+    return 1;
+  }
+
+  MappedSegment segment = mapSegment(segment_name);
+  if (segment.header == nullptr) {
+    return 1;
+  }
+  printStats(*segment.header, max_num_bindings);
+  while (interval_seconds != 0) {
+    std::this_thread::sleep_for(std::chrono::seconds(interval_seconds));
+    // The injector unlinks the segment when it's destroyed; our mapping would stay valid, but it won't change anymore.
+    int fd = shm_open(segment_name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+      std::cout << "\nThe segment was removed." << std::endl;
+      break;
+    }
+    close(fd);
+    std::cout << "\n";
+    printStats(*segment.header, max_num_bindings);
+  }
+  munmap(const_cast<InjectorStatsSegment::Header*>(segment.header), segment.size);
+  return 0;
+}
@@ -510,6 +510,77 @@ public:
   PartialComponent<fruit::impl::RegisterProvider<AnnotatedSignature, Lambda>, Bindings...>
   registerProvider(Lambda lambda);
 
+  /**
+   * Similar to registerProvider(), but registers a provider for fruit::ThreadLocal<T> instead of T, where T is the type
+   * returned by the lambda (or the pointed type, if the lambda returns a pointer). The lambda will be called once in
+   * each thread that calls get() on the ThreadLocal object, and each of those threads will then use its own instance.
+   * For example:
+   *
+   * fruit::Component<fruit::ThreadLocal<Parser>> getParserComponent() {
+   *   return fruit::createComponent()
+   *       .install(getGrammarComponent)
+   *       .registerThreadLocalProvider([](Grammar* grammar) {
+   *          return Parser(grammar);
+   *       });
+   * }
+   *
+   * The lambda's parameters are injected only once (like for any other provider) and are then shared by all threads,
+   * so they must be safe to use concurrently. The per-thread instances are destroyed when their thread exits or when
+   * the injector is destroyed, whichever comes first.
+   *
+   * As for registerProvider(), the lambda must not have captures.
+   */
+  template <typename Lambda>
+  PartialComponent<typename fruit::impl::ThreadLocalProviderForLambdaHelper<Lambda>::Binding, Bindings...>
+  registerThreadLocalProvider(Lambda lambda);
+
+  /**
+   * Similar to the previous version of registerThreadLocalProvider(), but allows to specify an annotated signature
+   * (as in registerProvider<AnnotatedSignature>()). An annotation on the return type is applied to the resulting
+   * ThreadLocal<T> type; e.g. for the signature
+   *
+   * fruit::Annotated<MyAnnotation, Parser>(Grammar*)
+   *
+   * the binding will be for fruit::Annotated<MyAnnotation, fruit::ThreadLocal<Parser>>.
+   */
+  template <typename AnnotatedSignature, typename Lambda>
+  PartialComponent<typename fruit::impl::ThreadLocalProviderHelper<AnnotatedSignature, Lambda>::Binding, Bindings...>
+  registerThreadLocalProvider(Lambda lambda);
+
+  /**
+   * Similar to registerProvider(), but registers a provider for fruit::PerCpu<T> instead of T, where T is the type
+   * returned by the lambda. The lambda will be called once for each CPU when the PerCpu object is injected, and get()
+   * on the PerCpu object returns the instance of the CPU that the calling thread is running on. For example:
+   *
+   * fruit::Component<fruit::PerCpu<RequestStats>> getRequestStatsComponent() {
+   *   return fruit::createComponent()
+   *       .install(getClockComponent)
+   *       .registerPerCpuProvider([](Clock* clock) {
+   *          return RequestStats(clock);
+   *       });
+   * }
+   *
+   * The lambda must return T by value (not a pointer), since the instances are stored in cache-line-aligned slots to
+   * avoid false sharing between CPUs. Each instance is constructed in place from the lambda's result, so since C++17
+   * T doesn't need to be movable (before C++17, T must be MoveConstructible to be returned by the lambda). The
+   * lambda's parameters are injected only once and are then shared by all the instances. Threads can be migrated
+   * between CPUs, so T must still be safe to use concurrently; see fruit::PerCpu for more details.
+   *
+   * As for registerProvider(), the lambda must not have captures.
+   */
+  template <typename Lambda>
+  PartialComponent<typename fruit::impl::PerCpuProviderForLambdaHelper<Lambda>::Binding, Bindings...>
+  registerPerCpuProvider(Lambda lambda);
+
+  /**
+   * Similar to the previous version of registerPerCpuProvider(), but allows to specify an annotated signature (as in
+   * registerProvider<AnnotatedSignature>()). An annotation on the return type is applied to the resulting PerCpu<T>
+   * type, as for registerThreadLocalProvider<AnnotatedSignature>().
+   */
+  template <typename AnnotatedSignature, typename Lambda>
+  PartialComponent<typename fruit::impl::PerCpuProviderHelper<AnnotatedSignature, Lambda>::Binding, Bindings...>
+  registerPerCpuProvider(Lambda lambda);
+
   /**
    * Similar to bind<I, C>(), but adds a multibinding instead.
    *
@@ -811,6 +882,43 @@ public:
   PartialComponent<fruit::impl::RegisterFactory<DecoratedSignature, Factory>, Bindings...>
   registerFactory(Factory factory);
 
+  /**
+   * Similar to registerFactory(), but the bound std::function returns a std::shared_ptr<C> and memoizes the objects it
+   * returns: calling it again with the same assisted params returns the same object (instead of calling `factory'
+   * again). This is useful when the factory is called repeatedly with a small set of recurring params.
+   *
+   * If the factory returns a std::unique_ptr<C>, the std::function still returns a std::shared_ptr<C>.
+   * The assisted params must be usable as keys of a hash table: std::hash and operator== must be defined for them
+   * (after removing any reference and const).
+   *
+   * The cached objects are shared between all copies of the std::function injected from the same injector, and
+   * they're kept alive by the cache (and by any std::shared_ptr returned to the callers). The std::function can be
+   * called concurrently from multiple threads, and calls that find the object in the cache don't lock any mutex. If
+   * multiple threads call it concurrently with the same (uncached) params, `factory' might be called more than once,
+   * but they all get the same object.
+   *
+   * If max_cached_objects is not 0, the cache holds (about) max_cached_objects objects at most, evicting the ones that
+   * were cached first.
+   *
+   * Example:
+   *
+   * Component<std::function<std::shared_ptr<Scaler>(double)>> getScalerComponent() {
+   *   return fruit::createComponent()
+   *       .registerMemoizedFactory<std::unique_ptr<Scaler>(fruit::Assisted<double>)>(
+   *          [](double factor) {
+   *              return std::unique_ptr<Scaler>(new ScalerImpl(factor));
+   *          });
+   * }
+   *
+   * Injector<std::function<std::shared_ptr<Scaler>(double)>> injector(getScalerComponent);
+   * std::function<std::shared_ptr<Scaler>(double)> scalerFactory(injector);
+   * std::shared_ptr<Scaler> scaler1 = scalerFactory(2.0);
+   * std::shared_ptr<Scaler> scaler2 = scalerFactory(2.0); // Same object as scaler1.
+   */
+  template <typename DecoratedSignature, std::size_t max_cached_objects = 0, typename Factory>
+  PartialComponent<fruit::impl::RegisterMemoizedFactory<DecoratedSignature, Factory, max_cached_objects>, Bindings...>
+  registerMemoizedFactory(Factory factory);
+
   /**
    * Adds the bindings (and multibindings) in the Component obtained by calling fun(args...) to the current component.
    *
@@ -929,7 +1037,7 @@ public:
   class PartialComponentWithReplacementInProgress {
   private:
     using storage_t = fruit::impl::PartialComponentStorage<
-        fruit::impl::PartialReplaceComponent<ReplacedComponent(GetReplacedComponentFormalArgs...)>, Bindings...>;
+        fruit::impl::PartialReplaceComponent<ReplacedComponent(GetReplacedComponentFormalArgs...)>>;
 
   public:
     template <typename... FormalArgs, typename... Args>
@@ -1065,9 +1173,9 @@ private:
   template <typename... Types>
   friend class Component;
 
-  fruit::impl::PartialComponentStorage<Bindings...> storage;
+  fruit::impl::PartialComponentStorageFor<Bindings...> storage;
 
-  PartialComponent(fruit::impl::PartialComponentStorage<Bindings...> storage); // NOLINT(google-explicit-constructor)
+  PartialComponent(fruit::impl::PartialComponentStorageFor<Bindings...> storage); // NOLINT(google-explicit-constructor)
 
   template <typename NewBinding>
   using OpFor = typename fruit::impl::meta::OpForComponent<Bindings...>::template AddBinding<NewBinding>;
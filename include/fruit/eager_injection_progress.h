@@ -0,0 +1,41 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_EAGER_INJECTION_PROGRESS_H
+#define FRUIT_EAGER_INJECTION_PROGRESS_H
+
+#include <cstddef>
+
+namespace fruit {
+
+/**
+ * The result of Injector::eagerlyInjectSome(): how much of the eager injection has been completed so far.
+ */
+struct EagerInjectionProgress {
+  // The number of steps completed so far, including those completed by previous calls.
+  std::size_t num_completed_steps;
+
+  // The total number of steps. Each step injects one of the types exposed by the injector or one multibinding set.
+  std::size_t num_steps;
+
+  bool isDone() const {
+    return num_completed_steps == num_steps;
+  }
+};
+
+} // namespace fruit
+
+#endif // FRUIT_EAGER_INJECTION_PROGRESS_H
@@ -27,9 +27,15 @@
 #include <fruit/component.h>
 #include <fruit/component_function.h>
 #include <fruit/fruit_forward_decls.h>
+#include <fruit/eager_injection_progress.h>
+#include <fruit/generational_injector.h>
 #include <fruit/injector.h>
+#include <fruit/injector_buffer.h>
 #include <fruit/macro.h>
 #include <fruit/normalized_component.h>
+#include <fruit/per_cpu.h>
 #include <fruit/provider.h>
+#include <fruit/thread_local.h>
+#include <fruit/type_allocation_stats.h>
 
 #endif // FRUIT_FRUIT_H
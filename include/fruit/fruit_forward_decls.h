@@ -19,6 +19,13 @@
 
 // This header contains forward declarations of all types in the `fruit' namespace.
 // Avoid writing forward declarations yourself; use this header instead.
+//
+// It doesn't include anything, so it's much cheaper to include than fruit/component.h; prefer it in headers that only
+// declare component functions, e.g.:
+//
+// fruit::Component<fruit::Required<Foo>, fruit::Annotated<MyAnnotation, Bar>> getBarComponent();
+//
+// The files that define or install those component functions still need fruit/component.h (or fruit/fruit.h).
 
 namespace fruit {
 
@@ -43,6 +50,18 @@ struct Assisted;
 template <typename Annotation, typename T>
 struct Annotated {};
 
+/**
+ * A tag that can be passed as first argument to the constructors of Injector, to create an injector that will only be
+ * used from a single thread. See Injector for details.
+ */
+struct SingleThreaded {};
+
+struct InjectorBuffer;
+
+struct EagerInjectionProgress;
+
+struct TypeAllocationStats;
+
 template <typename... Types>
 class Component;
 
@@ -60,6 +79,15 @@ class Provider;
 template <typename... P>
 class Injector;
 
+template <typename... P>
+class GenerationalInjector;
+
+template <typename T>
+class ThreadLocal;
+
+template <typename T>
+class PerCpu;
+
 template <typename ComponentType, typename... ComponentFunctionArgs>
 class ComponentFunction;
 
@@ -0,0 +1,143 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_GENERATIONAL_INJECTOR_H
+#define FRUIT_GENERATIONAL_INJECTOR_H
+
+#include <fruit/fruit_forward_decls.h>
+#include <fruit/injector.h>
+
+#include <memory>
+#include <mutex>
+
+namespace fruit {
+
+/**
+ * A GenerationalInjector holds a sequence of injectors (generations), e.g. one for each version of a configuration
+ * that can be reloaded at runtime. Only the last generation is current, and it can be replaced with reload().
+ *
+ * When a new generation is constructed, it reuses the objects already constructed by the current generation whose
+ * binding is the same in the new generation, as long as the bindings of all their (direct and indirect) dependencies
+ * are the same too. Two bindings are the same if they're both bindInstance() bindings for the same instance (not just
+ * an equal one), or if they construct the object in the same way (e.g. the same provider lambda or the same
+ * constructor) and with the same dependencies. So e.g. objects that depend on a configuration bound with
+ * bindInstance() are constructed again when the configuration object changes, while the objects that don't depend on
+ * it are reused.
+ *
+ * Objects are never reused if they obtained a Provider while being constructed (since they might use it later to
+ * construct objects in the old generation), and multibindings are never reused.
+ *
+ * Each generation is an Injector, shared between the GenerationalInjector and the users that called current(). A
+ * generation is destroyed once it's not current and all users have released it, and that destroys all its objects
+ * except the ones that are also used by other generations (constructed by an older generation and reused by this one,
+ * or constructed by this one and reused by a newer one). Each of those is destroyed when the last generation that uses
+ * it is destroyed. The memory block where a generation stored its objects is only deallocated when none of its
+ * objects is still in use.
+ *
+ * Example usage:
+ *
+ * Component<Server> getServerComponent(const Config* config) {
+ *   ...
+ * }
+ *
+ * GenerationalInjector<Server> injector(getServerComponent, config);
+ * ...
+ * // When handling a request.
+ * std::shared_ptr<Injector<Server>> current_injector = injector.current();
+ * Server* server = current_injector->get<Server*>();
+ * ...
+ * // When the configuration changes.
+ * injector.reload(getServerComponent, new_config);
+ */
+template <typename... P>
+class GenerationalInjector {
+public:
+  /**
+   * Creates a GenerationalInjector whose first generation is constructed from a component function, as in the
+   * corresponding Injector constructor.
+   */
+  template <typename... FormalArgs, typename... Args>
+  explicit GenerationalInjector(Component<P...> (*getComponent)(FormalArgs...), Args&&... args);
+
+  /**
+   * Creates a GenerationalInjector whose first generation is constructed from a normalized component and a component
+   * function, as in the corresponding Injector constructor.
+   *
+   * The NormalizedComponent must remain valid until all generations constructed with it have been destroyed.
+   */
+  template <typename... NormalizedComponentParams, typename... ComponentParams, typename... FormalArgs,
+            typename... Args>
+  GenerationalInjector(const NormalizedComponent<NormalizedComponentParams...>& normalized_component,
+                       Component<ComponentParams...> (*getComponent)(FormalArgs...), Args&&... args);
+
+  template <typename... NormalizedComponentParams, typename... ComponentParams, typename... FormalArgs,
+            typename... Args>
+  GenerationalInjector(NormalizedComponent<NormalizedComponentParams...>&& normalized_component,
+                       Component<ComponentParams...> (*getComponent)(FormalArgs...), Args&&... args) = delete;
+
+  GenerationalInjector(const GenerationalInjector&) = delete;
+  GenerationalInjector& operator=(const GenerationalInjector&) = delete;
+
+  /**
+   * Returns the current generation. This can be called concurrently with reload(); the returned injector remains valid
+   * (even if it's replaced by a newer generation) as long as the returned shared_ptr (or a copy of it) is alive.
+   */
+  std::shared_ptr<Injector<P...>> current() const;
+
+  /**
+   * Constructs a new generation from a component function (reusing the objects of the current generation as
+   * described above) and then makes it the current generation.
+   *
+   * The objects that can't be reused are not constructed here, but only when they're first requested from the new
+   * generation (as for any Injector).
+   * Concurrent calls to reload() are serialized, so each generation is constructed from the one published just
+   * before it.
+   */
+  template <typename... FormalArgs, typename... Args>
+  void reload(Component<P...> (*getComponent)(FormalArgs...), Args&&... args);
+
+  /**
+   * Similar to the above, but constructs the new generation from a normalized component and a component function.
+   *
+   * The NormalizedComponent must remain valid until all generations constructed with it have been destroyed.
+   */
+  template <typename... NormalizedComponentParams, typename... ComponentParams, typename... FormalArgs,
+            typename... Args>
+  void reload(const NormalizedComponent<NormalizedComponentParams...>& normalized_component,
+              Component<ComponentParams...> (*getComponent)(FormalArgs...), Args&&... args);
+
+  template <typename... NormalizedComponentParams, typename... ComponentParams, typename... FormalArgs,
+            typename... Args>
+  void reload(NormalizedComponent<NormalizedComponentParams...>&& normalized_component,
+              Component<ComponentParams...> (*getComponent)(FormalArgs...), Args&&... args) = delete;
+
+private:
+  // Enables generation tracking on `next', makes it reuse objects from the current generation (if any) and then makes
+  // it the current generation.
+  void publish(std::shared_ptr<Injector<P...>> next);
+
+  // Only accessed using std::atomic_load() and std::atomic_store(), so that current() doesn't need to lock anything.
+  std::shared_ptr<Injector<P...>> current_injector;
+
+  // Held while constructing and publishing a new generation.
+  std::mutex reload_mutex;
+};
+
+} // namespace fruit
+
+#include <fruit/impl/generational_injector.defn.h>
+
+#endif // FRUIT_GENERATIONAL_INJECTOR_H
@@ -115,6 +115,13 @@ struct AddMultibindingProvider<AnnotatedSignature, Lambda> {};
 template <typename DecoratedSignature, typename Lambda>
 struct RegisterFactory {};
 
+/**
+ * Similar to RegisterFactory, but the bound std::function returns a std::shared_ptr<C> and caches the returned objects
+ * (keyed by the assisted params). If max_cached_objects is not 0, at most (about) that many objects are cached.
+ */
+template <typename DecoratedSignature, typename Lambda, std::size_t max_cached_objects>
+struct RegisterMemoizedFactory {};
+
 /**
  * Adds the bindings (and multibindings) in `component' to the current component.
  * OtherComponent must be of the form Component<...>.
@@ -22,6 +22,8 @@
 #include <fruit/impl/component_storage/component_storage.h>
 #include <fruit/impl/injection_errors.h>
 #include <fruit/impl/component_install_arg_checks.h>
+#include <fruit/per_cpu.h>
+#include <fruit/thread_local.h>
 
 #include <memory>
 
@@ -31,17 +33,61 @@ namespace impl {
 namespace meta {
 // This is a helper class used in the implementation of Component and PartialComponent.
 // It's in fruit::impl::meta so that we don't need to qualify everything with fruit::impl::meta.
+//
+// OpForComponent<B, PreviousBindings...> only processes B, starting from the component computed by
+// OpForComponent<PreviousBindings...> (that was already instantiated by the previous call in the PartialComponent
+// chain). So each call in the chain performs a constant number of new instantiations, instead of also instantiating a
+// composition of the functors for all previous bindings (whose types, and symbol names, grow with the chain length).
 template <typename... PreviousBindings>
-struct OpForComponent {
+struct OpForComponent;
+
+template <>
+struct OpForComponent<> {
+  // The component obtained after processing all bindings (or an Error).
+  using Result = Eval<ConstructComponentImpl()>;
+
+  static void addEntries(FixedSizeVector<ComponentStorageEntry>&) {}
+
+  static std::size_t numEntries() {
+    return 0;
+  }
+
+  // The operation that completes the component (processing deferred bindings) and converts it to Comp. The entries
+  // for the bindings themselves are added by addEntries().
   template <typename Comp>
-  using ConvertTo = Eval<Call(ReverseComposeFunctors(Id<ComponentFunctor(ConvertComponent, Comp)>,
-                                                     ProcessDeferredBindings, Id<ProcessBinding(PreviousBindings)>...),
-                              ConstructComponentImpl())>;
+  using ConvertTo =
+      Eval<Call(ReverseComposeFunctors(Id<ComponentFunctor(ConvertComponent, Comp)>, ProcessDeferredBindings), Result)>;
 
   template <typename Binding>
-  using AddBinding =
-      Eval<Call(ReverseComposeFunctors(Id<ProcessBinding(Binding)>, Id<ProcessBinding(PreviousBindings)>...),
-                ConstructComponentImpl())>;
+  using AddBinding = Eval<Call(ProcessBinding(Binding), Result)>;
+};
+
+template <typename Binding, typename... PreviousBindings>
+struct OpForComponent<Binding, PreviousBindings...> {
+  using Previous = OpForComponent<PreviousBindings...>;
+
+  // The operation for this binding only. If the previous bindings resulted in an Error, this is that Error.
+  using Op = typename Previous::template AddBinding<Binding>;
+
+  using Result = Eval<GetResult(Op)>;
+
+  // Adds the entries for this binding and then the ones for the previous bindings, in the same order as a composition
+  // of the functors would.
+  static void addEntries(FixedSizeVector<ComponentStorageEntry>& entries) {
+    Op()(entries);
+    Previous::addEntries(entries);
+  }
+
+  static std::size_t numEntries() {
+    return Op().numEntries() + Previous::numEntries();
+  }
+
+  template <typename Comp>
+  using ConvertTo =
+      Eval<Call(ReverseComposeFunctors(Id<ComponentFunctor(ConvertComponent, Comp)>, ProcessDeferredBindings), Result)>;
+
+  template <typename NewBinding>
+  using AddBinding = Eval<Call(ProcessBinding(NewBinding), Result)>;
 };
 } // namespace meta
 } // namespace impl
@@ -52,18 +98,16 @@ inline Component<Params...>::Component(PartialComponent<Bindings...>&& partial_c
 
   (void)typename fruit::impl::meta::CheckIfError<Comp>::type();
 
-  using Op = typename fruit::impl::meta::OpForComponent<Bindings...>::template ConvertTo<Comp>;
+  using BindingsOp = fruit::impl::meta::OpForComponent<Bindings...>;
+  using Op = typename BindingsOp::template ConvertTo<Comp>;
   (void)typename fruit::impl::meta::CheckIfError<Op>::type();
 
-#if !FRUIT_NO_LOOP_CHECK
-  (void)typename fruit::impl::meta::CheckIfError<
-      fruit::impl::meta::Eval<fruit::impl::meta::CheckNoLoopInDeps(typename Op::Result)>>::type();
-#endif // !FRUIT_NO_LOOP_CHECK
-
-  std::size_t num_entries = partial_component.storage.numBindings() + Op().numEntries();
-  fruit::impl::FixedSizeVector<fruit::impl::ComponentStorageEntry> entries(num_entries);
+  std::size_t num_entries = partial_component.storage.numBindings() + Op().numEntries() + BindingsOp::numEntries();
+  fruit::impl::FixedSizeVector<fruit::impl::ComponentStorageEntry> entries =
+      fruit::impl::ComponentStorage::allocateEntries(num_entries);
 
   Op()(entries);
+  BindingsOp::addEntries(entries);
 
   // addBindings may modify the storage member of PartialComponent.
   // Therefore, it should not be used after this operation.
@@ -154,6 +198,76 @@ PartialComponent<Bindings...>::registerProvider(Lambda) {
   return {{storage}};
 }
 
+template <typename... Bindings>
+template <typename Lambda>
+inline PartialComponent<typename fruit::impl::ThreadLocalProviderForLambdaHelper<Lambda>::Binding, Bindings...>
+PartialComponent<Bindings...>::registerThreadLocalProvider(Lambda) {
+  using Op = OpFor<typename fruit::impl::ThreadLocalProviderForLambdaHelper<Lambda>::Binding>;
+  (void)typename fruit::impl::meta::CheckIfError<Op>::type();
+  return {{storage}};
+}
+
+template <typename... Bindings>
+template <typename AnnotatedSignature, typename Lambda>
+inline PartialComponent<typename fruit::impl::ThreadLocalProviderHelper<AnnotatedSignature, Lambda>::Binding,
+                        Bindings...>
+PartialComponent<Bindings...>::registerThreadLocalProvider(Lambda) {
+  using Helper = fruit::impl::ThreadLocalProviderHelper<AnnotatedSignature, Lambda>;
+  using Check = fruit::impl::meta::Eval<fruit::impl::meta::If(
+      fruit::impl::meta::Not(fruit::impl::meta::IsSame(
+          fruit::impl::meta::RemoveAnnotationsFromSignature(fruit::impl::meta::Type<AnnotatedSignature>),
+          fruit::impl::meta::FunctionSignature(fruit::impl::meta::Type<Lambda>))),
+      fruit::impl::meta::ConstructError(
+          fruit::impl::AnnotatedSignatureDifferentFromLambdaSignatureErrorTag,
+          fruit::impl::meta::RemoveAnnotationsFromSignature(fruit::impl::meta::Type<AnnotatedSignature>),
+          fruit::impl::meta::FunctionSignature(fruit::impl::meta::Type<Lambda>)),
+      fruit::impl::meta::None)>;
+  (void)typename fruit::impl::meta::CheckIfError<Check>::type();
+  using Op = OpFor<typename Helper::Binding>;
+  (void)typename fruit::impl::meta::CheckIfError<Op>::type();
+  return {{storage}};
+}
+
+template <typename... Bindings>
+template <typename Lambda>
+inline PartialComponent<typename fruit::impl::PerCpuProviderForLambdaHelper<Lambda>::Binding, Bindings...>
+PartialComponent<Bindings...>::registerPerCpuProvider(Lambda) {
+  using Helper = fruit::impl::PerCpuProviderForLambdaHelper<Lambda>;
+  using Check = fruit::impl::meta::Eval<fruit::impl::meta::If(
+      fruit::impl::meta::IsPointer(fruit::impl::meta::Type<typename Helper::T>),
+      fruit::impl::meta::ConstructError(fruit::impl::PerCpuProviderReturningPointerErrorTag,
+                                        fruit::impl::meta::RemovePointer(fruit::impl::meta::Type<typename Helper::T>)),
+      fruit::impl::meta::None)>;
+  (void)typename fruit::impl::meta::CheckIfError<Check>::type();
+  using Op = OpFor<typename Helper::Binding>;
+  (void)typename fruit::impl::meta::CheckIfError<Op>::type();
+  return {{storage}};
+}
+
+template <typename... Bindings>
+template <typename AnnotatedSignature, typename Lambda>
+inline PartialComponent<typename fruit::impl::PerCpuProviderHelper<AnnotatedSignature, Lambda>::Binding, Bindings...>
+PartialComponent<Bindings...>::registerPerCpuProvider(Lambda) {
+  using Helper = fruit::impl::PerCpuProviderHelper<AnnotatedSignature, Lambda>;
+  using Check = fruit::impl::meta::Eval<fruit::impl::meta::If(
+      fruit::impl::meta::Not(fruit::impl::meta::IsSame(
+          fruit::impl::meta::RemoveAnnotationsFromSignature(fruit::impl::meta::Type<AnnotatedSignature>),
+          fruit::impl::meta::FunctionSignature(fruit::impl::meta::Type<Lambda>))),
+      fruit::impl::meta::ConstructError(
+          fruit::impl::AnnotatedSignatureDifferentFromLambdaSignatureErrorTag,
+          fruit::impl::meta::RemoveAnnotationsFromSignature(fruit::impl::meta::Type<AnnotatedSignature>),
+          fruit::impl::meta::FunctionSignature(fruit::impl::meta::Type<Lambda>)),
+      fruit::impl::meta::If(fruit::impl::meta::IsPointer(fruit::impl::meta::Type<typename Helper::T>),
+                            fruit::impl::meta::ConstructError(
+                                fruit::impl::PerCpuProviderReturningPointerErrorTag,
+                                fruit::impl::meta::RemovePointer(fruit::impl::meta::Type<typename Helper::T>)),
+                            fruit::impl::meta::None))>;
+  (void)typename fruit::impl::meta::CheckIfError<Check>::type();
+  using Op = OpFor<typename Helper::Binding>;
+  (void)typename fruit::impl::meta::CheckIfError<Op>::type();
+  return {{storage}};
+}
+
 template <typename... Bindings>
 template <typename AnnotatedI, typename AnnotatedC>
 inline PartialComponent<fruit::impl::AddMultibinding<AnnotatedI, AnnotatedC>, Bindings...>
@@ -237,7 +351,18 @@ PartialComponent<Bindings...>::registerFactory(Lambda) {
 }
 
 template <typename... Bindings>
-inline PartialComponent<Bindings...>::PartialComponent(fruit::impl::PartialComponentStorage<Bindings...> storage)
+template <typename DecoratedSignature, std::size_t max_cached_objects, typename Lambda>
+inline PartialComponent<fruit::impl::RegisterMemoizedFactory<DecoratedSignature, Lambda, max_cached_objects>,
+                        Bindings...>
+PartialComponent<Bindings...>::registerMemoizedFactory(Lambda) {
+  using Op = OpFor<fruit::impl::RegisterMemoizedFactory<DecoratedSignature, Lambda, max_cached_objects>>;
+  (void)typename fruit::impl::meta::CheckIfError<Op>::type();
+
+  return {{storage}};
+}
+
+template <typename... Bindings>
+inline PartialComponent<Bindings...>::PartialComponent(fruit::impl::PartialComponentStorageFor<Bindings...> storage)
     : storage(std::move(storage)) {}
 
 template <typename... Bindings>
@@ -21,7 +21,9 @@
 
 #include <fruit/impl/injection_debug_errors.h>
 #include <fruit/impl/injection_errors.h>
+#include <fruit/impl/data_structures/concurrent_memo_cache.h>
 #include <fruit/impl/injector/injector_storage.h>
+#include <fruit/impl/util/hash_codes.h>
 
 #include <memory>
 
@@ -388,21 +390,61 @@ struct RegisterMultibindingProvider {
   };
 };
 
-// Non-assisted case.
-template <int numAssistedBefore, int numNonAssistedBefore, typename Arg>
-struct GetAssistedArg {
+// Gets an arg for the lambda of an assisted factory, as described by an element of AssistedFactoryArgSources.
+template <typename ArgSource>
+struct AssistedFactoryArg;
+
+// Non-assisted case. The injected args are passed as lvalues, since the factory can be called multiple times.
+template <int index>
+struct AssistedFactoryArg<Pair<Bool<false>, Int<index>>> {
   template <typename InjectedArgsTuple, typename UserProvidedArgsTuple>
-  inline Arg operator()(InjectedArgsTuple& injected_args, UserProvidedArgsTuple&) {
-    return std::get<numNonAssistedBefore>(injected_args);
+  static inline auto get(InjectedArgsTuple& injected_args, UserProvidedArgsTuple&)
+      -> decltype(std::get<index>(injected_args)) {
+    return std::get<index>(injected_args);
   }
 };
 
-// Assisted case.
-template <int numAssistedBefore, int numNonAssistedBefore, typename Arg>
-struct GetAssistedArg<numAssistedBefore, numNonAssistedBefore, Assisted<Arg>> {
+// Assisted case. Each user-provided arg is used once, so it's forwarded as-is.
+template <int index>
+struct AssistedFactoryArg<Pair<Bool<true>, Int<index>>> {
   template <typename InjectedArgsTuple, typename UserProvidedArgsTuple>
-  inline Arg operator()(InjectedArgsTuple&, UserProvidedArgsTuple& user_provided_args) {
-    return std::get<numAssistedBefore>(user_provided_args);
+  static inline auto get(InjectedArgsTuple&, UserProvidedArgsTuple& user_provided_args)
+      -> decltype(std::get<index>(std::move(user_provided_args))) {
+    return std::get<index>(std::move(user_provided_args));
+  }
+};
+
+// The functor wrapped in the std::function bound by registerFactory().
+// The injected args of the lambda are resolved once, when the factory is injected, and stored in `injected_args';
+// each call then invokes the lambda directly, passing each arg from where ArgSources says.
+template <typename Lambda, typename NakedC, typename InjectedArgsTuple, typename ArgSources>
+struct AssistedFactory;
+
+template <typename Lambda, typename NakedC, typename InjectedArgsTuple, typename... ArgSources>
+struct AssistedFactory<Lambda, NakedC, InjectedArgsTuple, Vector<ArgSources...>> {
+  InjectedArgsTuple injected_args;
+
+  template <typename... UserProvidedArgs>
+  inline NakedC operator()(UserProvidedArgs&&... params) {
+    auto user_provided_args = std::forward_as_tuple(std::forward<UserProvidedArgs>(params)...);
+    // This is unused if it's a 0-arg tuple. Silence the unused-variable warning anyway.
+    (void)user_provided_args;
+    return LambdaInvoker::invoke<Lambda>(AssistedFactoryArg<ArgSources>::get(injected_args, user_provided_args)...);
+  }
+};
+
+// Converts the result of a factory (a C or a std::unique_ptr<C>) into a std::shared_ptr<C>.
+template <typename C>
+struct SharedPtrMaker {
+  inline std::shared_ptr<C> operator()(C&& c) {
+    return std::make_shared<C>(std::move(c));
+  }
+};
+
+template <typename C>
+struct SharedPtrMaker<std::unique_ptr<C>> {
+  inline std::shared_ptr<C> operator()(std::unique_ptr<C>&& p) {
+    return std::shared_ptr<C>(std::move(p));
   }
 };
 
@@ -412,22 +454,23 @@ struct RegisterFactoryHelper {
             // std::function<InjectedSignature> is the injected type (possibly with an Annotation<> wrapping it)
             typename InjectedSignature, typename RequiredLambdaSignature, typename InjectedAnnotatedArgs,
             // The types that are injected, unwrapped from any Annotation<>.
-            typename InjectedArgs, typename IndexSequence>
+            typename InjectedArgs, typename ArgSources>
   struct apply;
 
   template <typename Comp, typename DecoratedSignature, typename Lambda, typename NakedC,
             typename... NakedUserProvidedArgs, typename... NakedAllArgs, typename... InjectedAnnotatedArgs,
-            typename... NakedInjectedArgs, typename... Indexes>
+            typename... NakedInjectedArgs, typename ArgSources>
   struct apply<Comp, DecoratedSignature, Lambda, Type<NakedC(NakedUserProvidedArgs...)>, Type<NakedC(NakedAllArgs...)>,
-               Vector<InjectedAnnotatedArgs...>, Vector<Type<NakedInjectedArgs>...>, Vector<Indexes...>> {
+               Vector<InjectedAnnotatedArgs...>, Vector<Type<NakedInjectedArgs>...>, ArgSources> {
     // Here we call "decorated" the types that might be wrapped in Annotated<> or Assisted<>,
     // while we call "annotated" the ones that might only be wrapped in Annotated<> (but not Assisted<>).
     using AnnotatedT = SignatureType(DecoratedSignature);
     using T = RemoveAnnotations(AnnotatedT);
-    using DecoratedArgs = SignatureArgs(DecoratedSignature);
     using NakedInjectedSignature = NakedC(NakedUserProvidedArgs...);
     using NakedRequiredSignature = NakedC(NakedAllArgs...);
     using NakedFunctor = std::function<NakedInjectedSignature>;
+    using InjectedArgsTuple = std::tuple<typename std::decay<NakedInjectedArgs>::type...>;
+    using Factory = AssistedFactory<UnwrapType<Lambda>, NakedC, InjectedArgsTuple, ArgSources>;
     // This is usually the same as Functor, but this might be annotated.
     using AnnotatedFunctor = CopyAnnotation(AnnotatedT, Type<NakedFunctor>);
     using FunctorDeps = NormalizeTypeVector(Vector<InjectedAnnotatedArgs...>);
@@ -437,22 +480,7 @@ struct RegisterFactoryHelper {
       using Result = Eval<R>;
       void operator()(FixedSizeVector<ComponentStorageEntry>& entries) {
         auto function_provider = [](NakedInjectedArgs... args) {
-          auto injected_args = std::make_tuple(args...);
-          auto object_provider = [injected_args](NakedUserProvidedArgs... params) mutable {
-            auto user_provided_args = std::tie(params...);
-            // These are unused if they are 0-arg tuples. Silence the unused-variable warnings anyway.
-            (void)injected_args;
-            (void)user_provided_args;
-
-            return LambdaInvoker::invoke<UnwrapType<Lambda>, NakedAllArgs...>(
-                GetAssistedArg<
-                    Eval<NumAssistedBefore(Indexes, DecoratedArgs)>::value,
-                    getIntValue<Indexes>() - Eval<NumAssistedBefore(Indexes, DecoratedArgs)>::value,
-                    // Note that the Assisted<> wrapper (if any) remains, we just remove any wrapping Annotated<>.
-                    UnwrapType<Eval<RemoveAnnotations(GetNthType(Indexes, DecoratedArgs))>>>()(injected_args,
-                                                                                               user_provided_args)...);
-          };
-          return NakedFunctor(object_provider);
+          return NakedFunctor(Factory{std::make_tuple(args...)});
         };
         entries.push_back(InjectorStorage::createComponentStorageEntryForProvider<
                           UnwrapType<Eval<ConsSignatureWithVector(AnnotatedFunctor, Vector<InjectedAnnotatedArgs...>)>>,
@@ -472,8 +500,68 @@ struct RegisterFactoryHelper {
   };
 };
 
-struct RegisterFactory {
-  template <typename Comp, typename DecoratedSignature, typename Lambda>
+// Similar to RegisterFactoryHelper, but binds a std::function that returns a std::shared_ptr and that caches the
+// objects it returns in a ConcurrentMemoCache (keyed by the assisted params).
+template <std::size_t max_cached_objects>
+struct RegisterMemoizedFactoryHelper {
+
+  template <typename Comp, typename DecoratedSignature, typename Lambda, typename InjectedSignature,
+            typename RequiredLambdaSignature, typename InjectedAnnotatedArgs, typename InjectedArgs,
+            typename ArgSources>
+  struct apply;
+
+  template <typename Comp, typename DecoratedSignature, typename Lambda, typename NakedC,
+            typename... NakedUserProvidedArgs, typename... NakedAllArgs, typename... InjectedAnnotatedArgs,
+            typename... NakedInjectedArgs, typename ArgSources>
+  struct apply<Comp, DecoratedSignature, Lambda, Type<NakedC(NakedUserProvidedArgs...)>, Type<NakedC(NakedAllArgs...)>,
+               Vector<InjectedAnnotatedArgs...>, Vector<Type<NakedInjectedArgs>...>, ArgSources> {
+    using AnnotatedT = SignatureType(DecoratedSignature);
+    using T = RemoveAnnotations(AnnotatedT);
+    // If the lambda returns a std::unique_ptr<X>, the cached objects are of type X.
+    using NakedValue = UnwrapType<Eval<RemoveUniquePtr(Type<NakedC>)>>;
+    using Key = std::tuple<typename std::decay<NakedUserProvidedArgs>::type...>;
+    using Cache = ConcurrentMemoCache<Key, NakedValue, TupleHasher>;
+    using InjectedArgsTuple = std::tuple<typename std::decay<NakedInjectedArgs>::type...>;
+    using Factory = AssistedFactory<UnwrapType<Lambda>, NakedC, InjectedArgsTuple, ArgSources>;
+    using NakedRequiredSignature = NakedC(NakedAllArgs...);
+    using NakedFunctor = std::function<std::shared_ptr<NakedValue>(NakedUserProvidedArgs...)>;
+    using AnnotatedFunctor = CopyAnnotation(AnnotatedT, Type<NakedFunctor>);
+    using FunctorDeps = NormalizeTypeVector(Vector<InjectedAnnotatedArgs...>);
+    using FunctorNonConstDeps = NormalizedNonConstTypesIn(Vector<InjectedAnnotatedArgs...>);
+    using R = AddProvidedType(Comp, AnnotatedFunctor, Bool<true>, FunctorDeps, FunctorNonConstDeps);
+    struct Op {
+      using Result = Eval<R>;
+      void operator()(FixedSizeVector<ComponentStorageEntry>& entries) {
+        auto function_provider = [](NakedInjectedArgs... args) {
+          Factory factory{std::make_tuple(args...)};
+          // The cache is shared by all copies of the returned std::function.
+          std::shared_ptr<Cache> cache = std::make_shared<Cache>(max_cached_objects);
+          auto object_provider = [factory, cache](NakedUserProvidedArgs... params) mutable {
+            return cache->getOrCreate(Key(params...), [&]() {
+              return SharedPtrMaker<NakedC>()(factory(std::forward<NakedUserProvidedArgs>(params)...));
+            });
+          };
+          return NakedFunctor(object_provider);
+        };
+        entries.push_back(InjectorStorage::createComponentStorageEntryForProvider<
+                          UnwrapType<Eval<ConsSignatureWithVector(AnnotatedFunctor, Vector<InjectedAnnotatedArgs...>)>>,
+                          decltype(function_provider)>());
+      }
+      std::size_t numEntries() {
+        return 1;
+      }
+    };
+    using type = If(Not(IsSame(Type<NakedRequiredSignature>, FunctionSignature(Lambda))),
+                    ConstructError(FunctorSignatureDoesNotMatchErrorTag, Type<NakedRequiredSignature>,
+                                   FunctionSignature(Lambda)),
+                    If(IsPointer(T), ConstructError(FactoryReturningPointerErrorTag, DecoratedSignature),
+                       PropagateError(R, Op)));
+  };
+};
+
+// Checks the factory and then calls Helper, that must be RegisterFactoryHelper or RegisterMemoizedFactoryHelper.
+struct RegisterFactoryWithHelper {
+  template <typename Comp, typename DecoratedSignature, typename Lambda, typename Helper>
   struct apply {
     using LambdaReturnType = SignatureType(FunctionSignature(Lambda));
     using type =
@@ -498,14 +586,28 @@ struct RegisterFactory {
                                        Not(HasVirtualDestructor(RemoveUniquePtr(LambdaReturnType))))),
                                ConstructError(RegisterFactoryForUniquePtrOfAbstractClassWithNoVirtualDestructorErrorTag,
                                               RemoveUniquePtr(LambdaReturnType)),
-                               RegisterFactoryHelper(
+                               Helper(
                                    Comp, DecoratedSignature, Lambda,
                                    InjectedSignatureForAssistedFactory(DecoratedSignature),
                                    RequiredLambdaSignatureForAssistedFactory(DecoratedSignature),
                                    RemoveAssisted(SignatureArgs(DecoratedSignature)),
                                    RemoveAnnotationsFromVector(RemoveAssisted(SignatureArgs(DecoratedSignature))),
-                                   GenerateIntSequence(
-                                       VectorSize(RequiredLambdaArgsForAssistedFactory(DecoratedSignature)))))))))));
+                                   AssistedFactoryArgSources(SignatureArgs(DecoratedSignature))))))))));
+  };
+};
+
+struct RegisterFactory {
+  template <typename Comp, typename DecoratedSignature, typename Lambda>
+  struct apply {
+    using type = RegisterFactoryWithHelper(Comp, DecoratedSignature, Lambda, RegisterFactoryHelper);
+  };
+};
+
+struct RegisterMemoizedFactory {
+  template <typename Comp, typename DecoratedSignature, typename Lambda, typename MaxCachedObjects>
+  struct apply {
+    using type = RegisterFactoryWithHelper(Comp, DecoratedSignature, Lambda,
+                                           RegisterMemoizedFactoryHelper<UnwrapType<MaxCachedObjects>::value>);
   };
 };
 
@@ -682,6 +784,30 @@ struct RegisterConstructorAsUniquePtrFactory {
   };
 };
 
+// Checks whether some type is provided only as const by ProvidingComp but required as non-const by RequiringComp.
+// This is equivalent to
+// Not(IsDisjoint(SetDifference(ProvidingComp::Ps, ProvidingComp::NonConstRsPs),
+//                SetIntersection(SetDifference(RequiringComp::RsSuperset, RequiringComp::Ps),
+//                                RequiringComp::NonConstRsPs)))
+// but it only performs set lookups, without constructing the intermediate sets (that are only needed to report the
+// error, if any).
+struct HasTypeProvidedAsConstButRequiredAsNonConst {
+  template <typename ProvidingComp, typename RequiringComp>
+  struct apply {
+    struct Helper {
+      template <typename CurrentResult, typename T>
+      struct apply {
+        using type = Or(CurrentResult, And(IsInSet(T, typename ProvidingComp::Ps),
+                                           Not(IsInSet(T, typename ProvidingComp::NonConstRsPs)),
+                                           IsInSet(T, typename RequiringComp::RsSuperset),
+                                           Not(IsInSet(T, typename RequiringComp::Ps))));
+      };
+    };
+
+    using type = FoldVector(typename RequiringComp::NonConstRsPs, Helper, Bool<false>);
+  };
+};
+
 struct InstallComponent {
   template <typename Comp, typename OtherComp>
   struct apply {
@@ -720,15 +846,29 @@ struct InstallComponent {
     using OtherCompRs = SetDifference(typename OtherComp::RsSuperset, typename OtherComp::Ps);
     using OtherCompNonConstRs = SetIntersection(OtherCompRs, typename OtherComp::NonConstRsPs);
 
+    // The sets above are only evaluated (in the error branches) if the corresponding check fails.
     using type = If(Not(IsDisjoint(typename OtherComp::Ps, AllPs)),
                     ConstructErrorWithArgVector(DuplicateTypesInComponentErrorTag, SetToVector(DuplicateTypes)),
-                    If(Not(IsDisjoint(CompConstPs, OtherCompNonConstRs)),
+                    If(HasTypeProvidedAsConstButRequiredAsNonConst(Comp, OtherComp),
                        ConstructError(NonConstBindingRequiredButConstBindingProvidedErrorTag,
                                       GetArbitrarySetElement(SetIntersection(CompConstPs, OtherCompNonConstRs))),
-                       If(Not(IsDisjoint(CompNonConstRs, OtherCompConstPs)),
+                       If(HasTypeProvidedAsConstButRequiredAsNonConst(OtherComp, Comp),
                           ConstructError(NonConstBindingRequiredButConstBindingProvidedErrorTag,
                                          GetArbitrarySetElement(SetIntersection(CompNonConstRs, OtherCompConstPs))),
-                          Op)));
+#if !FRUIT_NO_LOOP_CHECK
+                          // Neither Comp nor OtherComp have loops, so a new loop must go from a type provided by
+                          // OtherComp and required by Comp to a type provided by Comp and required by OtherComp.
+                          If(Or(IsDisjoint(typename OtherComp::Ps, typename Comp::RsSuperset),
+                                IsDisjoint(OtherCompRs, typename Comp::Ps)),
+                             Op,
+                             PropagateError(CheckNoLoopInDepsFrom(R, SetToVector(SetIntersection(
+                                                                         typename OtherComp::Ps,
+                                                                         typename Comp::RsSuperset))),
+                                            Op))
+#else
+                          Op
+#endif
+                          )));
   };
 };
 
@@ -1279,6 +1419,12 @@ struct ProcessBinding {
     using type = ComponentFunctor(RegisterFactory, Type<DecoratedSignature>, Type<Lambda>);
   };
 
+  template <typename DecoratedSignature, typename Lambda, std::size_t max_cached_objects>
+  struct apply<fruit::impl::RegisterMemoizedFactory<DecoratedSignature, Lambda, max_cached_objects>> {
+    using type = ComponentFunctor(RegisterMemoizedFactory, Type<DecoratedSignature>, Type<Lambda>,
+                                  Type<std::integral_constant<std::size_t, max_cached_objects>>);
+  };
+
   template <typename... Params, typename... Args>
   struct apply<fruit::impl::InstallComponent<fruit::Component<Params...>(Args...)>> {
     using type = ComponentFunctor(InstallComponentHelper, Type<Params>...);
@@ -22,31 +22,78 @@
 namespace fruit {
 namespace impl {
 
-template <typename L>
-struct GetBindingDepsHelper;
-
+// This is keyed on the types themselves (instead of on a meta::Vector of meta::Type<>s) to keep the symbol names of the
+// static variables below short.
+// When getTypeId() is constexpr these are constant-initialized, so there's no guard variable (nor initialization code).
 template <typename... Ts>
-struct GetBindingDepsHelper<fruit::impl::meta::Vector<fruit::impl::meta::Type<Ts>...>> {
+struct GetBindingDepsHelper {
   inline const BindingDeps* operator()() {
     static const TypeId types[] = {getTypeId<Ts>()..., TypeId{nullptr}}; // LCOV_EXCL_BR_LINE
-    static const BindingDeps deps = {types, sizeof...(Ts)};
+    static const BindingDeps deps = {types, sizeof...(Ts), nullptr};
     return &deps;
   }
 };
 
 // We specialize the "no Ts" case to avoid declaring types[] as an array of length 0.
 template <>
-struct GetBindingDepsHelper<fruit::impl::meta::Vector<>> {
+struct GetBindingDepsHelper<> {
   inline const BindingDeps* operator()() {
     static const TypeId types[] = {TypeId{nullptr}};
-    static const BindingDeps deps = {types, 0};
+    static const BindingDeps deps = {types, 0, nullptr};
     return &deps;
   }
 };
 
+template <bool... is_lazy>
+struct LazyDeps {};
+
+constexpr bool anyLazyDep() {
+  return false;
+}
+
+template <typename... Bools>
+constexpr bool anyLazyDep(bool is_lazy, Bools... others) {
+  return is_lazy || anyLazyDep(others...);
+}
+
+template <typename IsLazyDeps, typename... Ts>
+struct GetBindingDepsWithLazyDepsHelper;
+
+template <bool... is_lazy, typename... Ts>
+struct GetBindingDepsWithLazyDepsHelper<LazyDeps<is_lazy...>, Ts...> {
+  inline const BindingDeps* operator()() {
+    static const TypeId types[] = {getTypeId<Ts>()..., TypeId{nullptr}}; // LCOV_EXCL_BR_LINE
+    static const bool lazy_deps[] = {is_lazy..., false};
+    static const BindingDeps deps = {types, sizeof...(Ts), anyLazyDep(is_lazy...) ? lazy_deps : nullptr};
+    return &deps;
+  }
+};
+
+template <typename L>
+struct GetBindingDepsForList;
+
+template <typename... Ts>
+struct GetBindingDepsForList<fruit::impl::meta::Vector<fruit::impl::meta::Type<Ts>...>> {
+  using type = GetBindingDepsHelper<Ts...>;
+};
+
+template <typename L, typename IsLazyL>
+struct GetBindingDepsWithLazyDepsForList;
+
+template <typename... Ts, bool... is_lazy>
+struct GetBindingDepsWithLazyDepsForList<fruit::impl::meta::Vector<fruit::impl::meta::Type<Ts>...>,
+                                         fruit::impl::meta::Vector<fruit::impl::meta::Bool<is_lazy>...>> {
+  using type = GetBindingDepsWithLazyDepsHelper<LazyDeps<is_lazy...>, Ts...>;
+};
+
 template <typename Deps>
 inline const BindingDeps* getBindingDeps() {
-  return GetBindingDepsHelper<Deps>()();
+  return typename GetBindingDepsForList<Deps>::type()();
+}
+
+template <typename Deps, typename IsLazyDeps>
+inline const BindingDeps* getBindingDeps() {
+  return typename GetBindingDepsWithLazyDepsForList<Deps, IsLazyDeps>::type()();
 }
 
 } // namespace impl
@@ -28,11 +28,20 @@ struct BindingDeps {
 
   // The size of the above array.
   std::size_t num_deps;
+
+  // A C-style array with an element for each dep, that's true iff that dep is lazy (i.e. only injected as a Provider,
+  // so it's not constructed when the binding is constructed). nullptr if no dep is lazy.
+  const bool* lazy_deps;
 };
 
+// `Deps' is a meta::Vector of the (normalized) types of the deps. All of them are non-lazy.
 template <typename Deps>
 const BindingDeps* getBindingDeps();
 
+// `IsLazyDeps' is a meta::Vector with a meta::Bool for each element of `Deps', see BindingDeps::lazy_deps.
+template <typename Deps, typename IsLazyDeps>
+const BindingDeps* getBindingDeps();
+
 } // namespace impl
 } // namespace fruit
 
@@ -53,6 +53,28 @@ public:
 
   std::size_t numEntries() const;
 
+  /**
+   * While an EntryRecyclingScope is alive in a thread, allocateEntries() in that thread reuses the last vector passed
+   * to recycleEntries() (if it's large enough) instead of allocating a new one.
+   * Binding normalization opens one of these, since each lazy component that it expands calls a component function
+   * that builds a Component whose entries are copied to the normalization stack right away.
+   */
+  class EntryRecyclingScope {
+  public:
+    EntryRecyclingScope();
+    ~EntryRecyclingScope();
+
+    EntryRecyclingScope(const EntryRecyclingScope&) = delete;
+    EntryRecyclingScope& operator=(const EntryRecyclingScope&) = delete;
+  };
+
+  // Returns an empty vector that can hold at least num_entries entries.
+  static FixedSizeVector<ComponentStorageEntry> allocateEntries(std::size_t num_entries);
+
+  // Allows a vector returned by release() to be reused by allocateEntries(). The entries in it must have been copied
+  // elsewhere, they're not destroyed.
+  static void recycleEntries(FixedSizeVector<ComponentStorageEntry>&& entries);
+
   ComponentStorage& operator=(const ComponentStorage&);
   ComponentStorage& operator=(ComponentStorage&&) noexcept;
 };
@@ -17,6 +17,7 @@
 #ifndef FRUIT_COMPONENT_STORAGE_ENTRY_DEFN_H
 #define FRUIT_COMPONENT_STORAGE_ENTRY_DEFN_H
 
+#include <fruit/impl/component_storage/component_storage.h>
 #include <fruit/impl/component_storage/component_storage_entry.h>
 #include <fruit/impl/util/call_with_tuple.h>
 #include <fruit/impl/util/hash_codes.h>
@@ -92,6 +93,7 @@ public:
     Component component = callWithTuple<Component, Args...>(reinterpret_cast<fun_t>(erased_fun), args_tuple);
     FixedSizeVector<ComponentStorageEntry> component_entries = std::move(component.storage).release();
     entries.insert(entries.end(), component_entries.begin(), component_entries.end());
+    ComponentStorage::recycleEntries(std::move(component_entries));
   }
 
   inline std::size_t hashCode() const final {
@@ -170,6 +172,7 @@ void ComponentStorageEntry::LazyComponentWithNoArgs::addBindings(erased_fun_t er
   Component component = reinterpret_cast<Component (*)()>(erased_fun)();
   FixedSizeVector<ComponentStorageEntry> component_entries = std::move(component.storage).release();
   entries.insert(entries.end(), component_entries.begin(), component_entries.end());
+  ComponentStorage::recycleEntries(std::move(component_entries));
 }
 
 template <typename Component>
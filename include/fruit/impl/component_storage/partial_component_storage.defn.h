@@ -28,65 +28,73 @@
 namespace fruit {
 namespace impl {
 
-template <>
-class PartialComponentStorage<> {
-public:
-  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) const {
-    (void)entries;
-  }
+inline PartialComponentStorageBase::PartialComponentStorageBase(add_bindings_t add_bindings,
+                                                                num_bindings_t num_bindings)
+    : add_bindings(add_bindings), num_bindings(num_bindings) {}
 
-  std::size_t numBindings() const {
-    return 0;
-  }
-};
+inline void PartialComponentStorageBase::addBindings(FixedSizeVector<ComponentStorageEntry>& entries) {
+  add_bindings(*this, entries);
+}
 
-template <typename I, typename C, typename... PreviousBindings>
-class PartialComponentStorage<Bind<I, C>, PreviousBindings...> {
-private:
-  PartialComponentStorage<PreviousBindings...>& previous_storage;
+inline std::size_t PartialComponentStorageBase::numBindings() const {
+  return num_bindings(*this);
+}
 
-public:
-  PartialComponentStorage(PartialComponentStorage<PreviousBindings...>& previous_storage) // NOLINT(google-explicit-constructor)
-      : previous_storage(previous_storage) {}
+template <typename Derived>
+inline PartialComponentStorageImpl<Derived>::PartialComponentStorageImpl()
+    : PartialComponentStorageBase(addBindingsOf, numBindingsOf) {}
 
-  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) const {
-    previous_storage.addBindings(entries);
-  }
+template <typename Derived>
+inline void PartialComponentStorageImpl<Derived>::addBindingsOf(PartialComponentStorageBase& storage,
+                                                                FixedSizeVector<ComponentStorageEntry>& entries) {
+  static_cast<Derived&>(storage).addBindings(entries);
+}
 
-  std::size_t numBindings() const {
-    return previous_storage.numBindings();
-  }
-};
+template <typename Derived>
+inline std::size_t PartialComponentStorageImpl<Derived>::numBindingsOf(const PartialComponentStorageBase& storage) {
+  return static_cast<const Derived&>(storage).numBindings();
+}
 
-template <typename Signature, typename... PreviousBindings>
-class PartialComponentStorage<RegisterConstructor<Signature>, PreviousBindings...> {
-private:
-  PartialComponentStorage<PreviousBindings...>& previous_storage;
+inline PartialComponentStorageWithNoData::PartialComponentStorageWithNoData(
+    PartialComponentStorageBase& previous_storage)
+    : previous_storage(previous_storage) {}
+
+inline void PartialComponentStorageWithNoData::addBindings(FixedSizeVector<ComponentStorageEntry>& entries) {
+  previous_storage.addBindings(entries);
+}
+
+inline std::size_t PartialComponentStorageWithNoData::numBindings() const {
+  return previous_storage.numBindings();
+}
 
+template <>
+class PartialComponentStorage<> : public PartialComponentStorageImpl<PartialComponentStorage<>> {
 public:
-  PartialComponentStorage(PartialComponentStorage<PreviousBindings...>& previous_storage) // NOLINT(google-explicit-constructor)
-      : previous_storage(previous_storage) {}
+  // This must be user-provided (not defaulted), otherwise since C++17 this class is an aggregate and `{}' initializes
+  // the (protected) base class directly.
+  PartialComponentStorage() {}
 
-  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) const {
-    previous_storage.addBindings(entries);
+  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) {
+    (void)entries;
   }
 
   std::size_t numBindings() const {
-    return previous_storage.numBindings();
+    return 0;
   }
 };
 
-template <typename C, typename C1, typename... PreviousBindings>
-class PartialComponentStorage<BindInstance<C, C1>, PreviousBindings...> {
+template <typename C, typename C1>
+class PartialComponentStorage<BindInstance<C, C1>>
+    : public PartialComponentStorageImpl<PartialComponentStorage<BindInstance<C, C1>>> {
 private:
-  PartialComponentStorage<PreviousBindings...>& previous_storage;
+  PartialComponentStorageBase& previous_storage;
   C& instance;
 
 public:
-  PartialComponentStorage(PartialComponentStorage<PreviousBindings...>& previous_storage, C& instance)
+  PartialComponentStorage(PartialComponentStorageBase& previous_storage, C& instance)
       : previous_storage(previous_storage), instance(instance) {}
 
-  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) const {
+  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) {
     entries.push_back(InjectorStorage::createComponentStorageEntryForBindInstance<C, C>(instance));
     previous_storage.addBindings(entries);
   }
@@ -96,17 +104,18 @@ public:
   }
 };
 
-template <typename C, typename C1, typename... PreviousBindings>
-class PartialComponentStorage<BindConstInstance<C, C1>, PreviousBindings...> {
+template <typename C, typename C1>
+class PartialComponentStorage<BindConstInstance<C, C1>>
+    : public PartialComponentStorageImpl<PartialComponentStorage<BindConstInstance<C, C1>>> {
 private:
-  PartialComponentStorage<PreviousBindings...>& previous_storage;
+  PartialComponentStorageBase& previous_storage;
   const C& instance;
 
 public:
-  PartialComponentStorage(PartialComponentStorage<PreviousBindings...>& previous_storage, const C& instance)
+  PartialComponentStorage(PartialComponentStorageBase& previous_storage, const C& instance)
       : previous_storage(previous_storage), instance(instance) {}
 
-  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) const {
+  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) {
     entries.push_back(InjectorStorage::createComponentStorageEntryForBindConstInstance<C, C>(instance));
     previous_storage.addBindings(entries);
   }
@@ -116,17 +125,18 @@ public:
   }
 };
 
-template <typename C, typename Annotation, typename C1, typename... PreviousBindings>
-class PartialComponentStorage<BindInstance<fruit::Annotated<Annotation, C>, C1>, PreviousBindings...> {
+template <typename C, typename Annotation, typename C1>
+class PartialComponentStorage<BindInstance<fruit::Annotated<Annotation, C>, C1>>
+    : public PartialComponentStorageImpl<PartialComponentStorage<BindInstance<fruit::Annotated<Annotation, C>, C1>>> {
 private:
-  PartialComponentStorage<PreviousBindings...>& previous_storage;
+  PartialComponentStorageBase& previous_storage;
   C& instance;
 
 public:
-  PartialComponentStorage(PartialComponentStorage<PreviousBindings...>& previous_storage, C& instance)
+  PartialComponentStorage(PartialComponentStorageBase& previous_storage, C& instance)
       : previous_storage(previous_storage), instance(instance) {}
 
-  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) const {
+  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) {
     entries.push_back(
         InjectorStorage::createComponentStorageEntryForBindInstance<fruit::Annotated<Annotation, C>, C>(instance));
     previous_storage.addBindings(entries);
@@ -137,17 +147,19 @@ public:
   }
 };
 
-template <typename C, typename Annotation, typename C1, typename... PreviousBindings>
-class PartialComponentStorage<BindConstInstance<fruit::Annotated<Annotation, C>, C1>, PreviousBindings...> {
+template <typename C, typename Annotation, typename C1>
+class PartialComponentStorage<BindConstInstance<fruit::Annotated<Annotation, C>, C1>>
+    : public PartialComponentStorageImpl<
+          PartialComponentStorage<BindConstInstance<fruit::Annotated<Annotation, C>, C1>>> {
 private:
-  PartialComponentStorage<PreviousBindings...>& previous_storage;
+  PartialComponentStorageBase& previous_storage;
   const C& instance;
 
 public:
-  PartialComponentStorage(PartialComponentStorage<PreviousBindings...>& previous_storage, const C& instance)
+  PartialComponentStorage(PartialComponentStorageBase& previous_storage, const C& instance)
       : previous_storage(previous_storage), instance(instance) {}
 
-  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) const {
+  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) {
     entries.push_back(
         InjectorStorage::createComponentStorageEntryForBindConstInstance<fruit::Annotated<Annotation, C>, C>(instance));
     previous_storage.addBindings(entries);
@@ -158,35 +170,18 @@ public:
   }
 };
 
-template <typename... Params, typename... PreviousBindings>
-class PartialComponentStorage<RegisterProvider<Params...>, PreviousBindings...> {
-private:
-  PartialComponentStorage<PreviousBindings...>& previous_storage;
-
-public:
-  PartialComponentStorage(PartialComponentStorage<PreviousBindings...>& previous_storage) // NOLINT(google-explicit-constructor)
-      : previous_storage(previous_storage) {}
-
-  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) const {
-    previous_storage.addBindings(entries);
-  }
-
-  std::size_t numBindings() const {
-    return previous_storage.numBindings();
-  }
-};
-
-template <typename C, typename... PreviousBindings>
-class PartialComponentStorage<AddInstanceMultibinding<C>, PreviousBindings...> {
+template <typename C>
+class PartialComponentStorage<AddInstanceMultibinding<C>>
+    : public PartialComponentStorageImpl<PartialComponentStorage<AddInstanceMultibinding<C>>> {
 private:
-  PartialComponentStorage<PreviousBindings...>& previous_storage;
+  PartialComponentStorageBase& previous_storage;
   C& instance;
 
 public:
-  PartialComponentStorage(PartialComponentStorage<PreviousBindings...>& previous_storage, C& instance)
+  PartialComponentStorage(PartialComponentStorageBase& previous_storage, C& instance)
       : previous_storage(previous_storage), instance(instance) {}
 
-  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) const {
+  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) {
     entries.push_back(InjectorStorage::createComponentStorageEntryForInstanceMultibinding<C, C>(instance));
     entries.push_back(InjectorStorage::createComponentStorageEntryForMultibindingVectorCreator<C>());
     previous_storage.addBindings(entries);
@@ -197,17 +192,19 @@ public:
   }
 };
 
-template <typename C, typename Annotation, typename... PreviousBindings>
-class PartialComponentStorage<AddInstanceMultibinding<fruit::Annotated<Annotation, C>>, PreviousBindings...> {
+template <typename C, typename Annotation>
+class PartialComponentStorage<AddInstanceMultibinding<fruit::Annotated<Annotation, C>>>
+    : public PartialComponentStorageImpl<
+          PartialComponentStorage<AddInstanceMultibinding<fruit::Annotated<Annotation, C>>>> {
 private:
-  PartialComponentStorage<PreviousBindings...>& previous_storage;
+  PartialComponentStorageBase& previous_storage;
   C& instance;
 
 public:
-  PartialComponentStorage(PartialComponentStorage<PreviousBindings...>& previous_storage, C& instance)
+  PartialComponentStorage(PartialComponentStorageBase& previous_storage, C& instance)
       : previous_storage(previous_storage), instance(instance) {}
 
-  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) const {
+  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) {
     entries.push_back(
         InjectorStorage::createComponentStorageEntryForInstanceMultibinding<fruit::Annotated<Annotation, C>, C>(
             instance));
@@ -221,17 +218,18 @@ public:
   }
 };
 
-template <typename C, typename... PreviousBindings>
-class PartialComponentStorage<AddInstanceVectorMultibindings<C>, PreviousBindings...> {
+template <typename C>
+class PartialComponentStorage<AddInstanceVectorMultibindings<C>>
+    : public PartialComponentStorageImpl<PartialComponentStorage<AddInstanceVectorMultibindings<C>>> {
 private:
-  PartialComponentStorage<PreviousBindings...>& previous_storage;
+  PartialComponentStorageBase& previous_storage;
   std::vector<C>& instances;
 
 public:
-  PartialComponentStorage(PartialComponentStorage<PreviousBindings...>& previous_storage, std::vector<C>& instances)
+  PartialComponentStorage(PartialComponentStorageBase& previous_storage, std::vector<C>& instances)
       : previous_storage(previous_storage), instances(instances) {}
 
-  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) const {
+  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) {
     for (auto i = instances.rbegin(), i_end = instances.rend(); i != i_end; ++i) {
       // TODO: consider optimizing this so that we need just 1 MULTIBINDING_VECTOR_CREATOR entry (removing the
       // assumption that each multibinding entry is always preceded by that).
@@ -246,17 +244,19 @@ public:
   }
 };
 
-template <typename C, typename Annotation, typename... PreviousBindings>
-class PartialComponentStorage<AddInstanceVectorMultibindings<fruit::Annotated<Annotation, C>>, PreviousBindings...> {
+template <typename C, typename Annotation>
+class PartialComponentStorage<AddInstanceVectorMultibindings<fruit::Annotated<Annotation, C>>>
+    : public PartialComponentStorageImpl<
+          PartialComponentStorage<AddInstanceVectorMultibindings<fruit::Annotated<Annotation, C>>>> {
 private:
-  PartialComponentStorage<PreviousBindings...>& previous_storage;
+  PartialComponentStorageBase& previous_storage;
   std::vector<C>& instances;
 
 public:
-  PartialComponentStorage(PartialComponentStorage<PreviousBindings...>& previous_storage, std::vector<C>& instances)
+  PartialComponentStorage(PartialComponentStorageBase& previous_storage, std::vector<C>& instances)
       : previous_storage(previous_storage), instances(instances) {}
 
-  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) const {
+  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) {
     for (auto i = instances.rbegin(), i_end = instances.rend(); i != i_end; ++i) {
       // TODO: consider optimizing this so that we need just 1 MULTIBINDING_VECTOR_CREATOR entry (removing the
       // assumption that each multibinding entry is always preceded by that).
@@ -273,72 +273,19 @@ public:
   }
 };
 
-template <typename I, typename C, typename... PreviousBindings>
-class PartialComponentStorage<AddMultibinding<I, C>, PreviousBindings...> {
-private:
-  PartialComponentStorage<PreviousBindings...>& previous_storage;
-
-public:
-  PartialComponentStorage(PartialComponentStorage<PreviousBindings...>& previous_storage) // NOLINT(google-explicit-constructor)
-      : previous_storage(previous_storage) {}
-
-  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) const {
-    previous_storage.addBindings(entries);
-  }
-
-  std::size_t numBindings() const {
-    return previous_storage.numBindings();
-  }
-};
-
-template <typename... Params, typename... PreviousBindings>
-class PartialComponentStorage<AddMultibindingProvider<Params...>, PreviousBindings...> {
-private:
-  PartialComponentStorage<PreviousBindings...>& previous_storage;
-
-public:
-  PartialComponentStorage(PartialComponentStorage<PreviousBindings...>& previous_storage) // NOLINT(google-explicit-constructor)
-      : previous_storage(previous_storage) {}
-
-  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) const {
-    previous_storage.addBindings(entries);
-  }
-
-  std::size_t numBindings() const {
-    return previous_storage.numBindings();
-  }
-};
-
-template <typename DecoratedSignature, typename Lambda, typename... PreviousBindings>
-class PartialComponentStorage<RegisterFactory<DecoratedSignature, Lambda>, PreviousBindings...> {
+template <typename OtherComponent>
+class PartialComponentStorage<InstallComponent<OtherComponent()>>
+    : public PartialComponentStorageImpl<PartialComponentStorage<InstallComponent<OtherComponent()>>> {
 private:
-  PartialComponentStorage<PreviousBindings...>& previous_storage;
-
-public:
-  PartialComponentStorage(PartialComponentStorage<PreviousBindings...>& previous_storage) // NOLINT(google-explicit-constructor)
-      : previous_storage(previous_storage) {}
-
-  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) const {
-    previous_storage.addBindings(entries);
-  }
-
-  std::size_t numBindings() const {
-    return previous_storage.numBindings();
-  }
-};
-
-template <typename OtherComponent, typename... PreviousBindings>
-class PartialComponentStorage<InstallComponent<OtherComponent()>, PreviousBindings...> {
-private:
-  PartialComponentStorage<PreviousBindings...>& previous_storage;
+  PartialComponentStorageBase& previous_storage;
   OtherComponent (*fun)();
 
 public:
-  PartialComponentStorage(PartialComponentStorage<PreviousBindings...>& previous_storage, OtherComponent (*fun1)(),
+  PartialComponentStorage(PartialComponentStorageBase& previous_storage, OtherComponent (*fun1)(),
                           std::tuple<>)
       : previous_storage(previous_storage), fun(fun1) {}
 
-  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) const {
+  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) {
     entries.push_back(ComponentStorageEntry::LazyComponentWithNoArgs::create(fun));
     previous_storage.addBindings(entries);
   }
@@ -348,15 +295,16 @@ public:
   }
 };
 
-template <typename OtherComponent, typename... Args, typename... PreviousBindings>
-class PartialComponentStorage<InstallComponent<OtherComponent(Args...)>, PreviousBindings...> {
+template <typename OtherComponent, typename... Args>
+class PartialComponentStorage<InstallComponent<OtherComponent(Args...)>>
+    : public PartialComponentStorageImpl<PartialComponentStorage<InstallComponent<OtherComponent(Args...)>>> {
 private:
-  PartialComponentStorage<PreviousBindings...>& previous_storage;
+  PartialComponentStorageBase& previous_storage;
   OtherComponent (*fun)(Args...);
   std::tuple<Args...> args_tuple;
 
 public:
-  PartialComponentStorage(PartialComponentStorage<PreviousBindings...>& previous_storage,
+  PartialComponentStorage(PartialComponentStorageBase& previous_storage,
                           OtherComponent (*fun1)(Args...), std::tuple<Args...> args_tuple)
       : previous_storage(previous_storage), fun(fun1), args_tuple(std::move(args_tuple)) {}
 
@@ -405,14 +353,15 @@ void addAllComponentStorageEntries(FixedSizeVector<ComponentStorageEntry>& entri
       entries, component_functions_tuple);
 }
 
-template <typename... ComponentFunctions, typename... PreviousBindings>
-class PartialComponentStorage<InstallComponentFunctions<ComponentFunctions...>, PreviousBindings...> {
+template <typename... ComponentFunctions>
+class PartialComponentStorage<InstallComponentFunctions<ComponentFunctions...>>
+    : public PartialComponentStorageImpl<PartialComponentStorage<InstallComponentFunctions<ComponentFunctions...>>> {
 private:
-  PartialComponentStorage<PreviousBindings...>& previous_storage;
+  PartialComponentStorageBase& previous_storage;
   std::tuple<ComponentFunctions...> component_functions_tuple;
 
 public:
-  PartialComponentStorage(PartialComponentStorage<PreviousBindings...>& previous_storage,
+  PartialComponentStorage(PartialComponentStorageBase& previous_storage,
                           std::tuple<ComponentFunctions...> component_functions_tuple)
       : previous_storage(previous_storage), component_functions_tuple(std::move(component_functions_tuple)) {}
 
@@ -426,18 +375,19 @@ public:
   }
 };
 
-template <typename OtherComponent, typename... PreviousBindings>
-class PartialComponentStorage<PartialReplaceComponent<OtherComponent()>, PreviousBindings...> {
+template <typename OtherComponent>
+class PartialComponentStorage<PartialReplaceComponent<OtherComponent()>>
+    : public PartialComponentStorageImpl<PartialComponentStorage<PartialReplaceComponent<OtherComponent()>>> {
 private:
-  PartialComponentStorage<PreviousBindings...>& previous_storage;
+  PartialComponentStorageBase& previous_storage;
   OtherComponent (*fun)();
 
 public:
-  PartialComponentStorage(PartialComponentStorage<PreviousBindings...>& previous_storage, OtherComponent (*fun1)(),
+  PartialComponentStorage(PartialComponentStorageBase& previous_storage, OtherComponent (*fun1)(),
                           std::tuple<>)
       : previous_storage(previous_storage), fun(fun1) {}
 
-  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) const {
+  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) {
     entries.push_back(ComponentStorageEntry::LazyComponentWithNoArgs::createReplacedComponentEntry(fun));
     previous_storage.addBindings(entries);
   }
@@ -447,15 +397,17 @@ public:
   }
 };
 
-template <typename OtherComponent, typename... ReplacedFunArgs, typename... PreviousBindings>
-class PartialComponentStorage<PartialReplaceComponent<OtherComponent(ReplacedFunArgs...)>, PreviousBindings...> {
+template <typename OtherComponent, typename... ReplacedFunArgs>
+class PartialComponentStorage<PartialReplaceComponent<OtherComponent(ReplacedFunArgs...)>>
+    : public PartialComponentStorageImpl<
+          PartialComponentStorage<PartialReplaceComponent<OtherComponent(ReplacedFunArgs...)>>> {
 private:
-  PartialComponentStorage<PreviousBindings...>& previous_storage;
+  PartialComponentStorageBase& previous_storage;
   OtherComponent (*fun)(ReplacedFunArgs...);
   std::tuple<ReplacedFunArgs...> args_tuple;
 
 public:
-  PartialComponentStorage(PartialComponentStorage<PreviousBindings...>& previous_storage,
+  PartialComponentStorage(PartialComponentStorageBase& previous_storage,
                           OtherComponent (*fun1)(ReplacedFunArgs...), std::tuple<ReplacedFunArgs...> args_tuple)
       : previous_storage(previous_storage), fun(fun1), args_tuple(std::move(args_tuple)) {}
 
@@ -470,12 +422,13 @@ public:
   }
 };
 
-template <typename OtherComponent, typename... PreviousBindings, typename... ReplacedFunArgs>
-class PartialComponentStorage<ReplaceComponent<OtherComponent(ReplacedFunArgs...), OtherComponent()>,
-                              PreviousBindings...> {
+template <typename OtherComponent, typename... ReplacedFunArgs>
+class PartialComponentStorage<ReplaceComponent<OtherComponent(ReplacedFunArgs...), OtherComponent()>>
+    : public PartialComponentStorageImpl<
+          PartialComponentStorage<ReplaceComponent<OtherComponent(ReplacedFunArgs...), OtherComponent()>>> {
 private:
   using previous_storage_t =
-      PartialComponentStorage<PartialReplaceComponent<OtherComponent(ReplacedFunArgs...)>, PreviousBindings...>;
+      PartialComponentStorage<PartialReplaceComponent<OtherComponent(ReplacedFunArgs...)>>;
 
   previous_storage_t& previous_storage;
   OtherComponent (*fun)();
@@ -484,7 +437,7 @@ public:
   PartialComponentStorage(previous_storage_t& previous_storage, OtherComponent (*fun1)(), std::tuple<>)
       : previous_storage(previous_storage), fun(fun1) {}
 
-  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) const {
+  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) {
     entries.push_back(ComponentStorageEntry::LazyComponentWithNoArgs::createReplacementComponentEntry(fun));
     previous_storage.addBindings(entries);
   }
@@ -494,13 +447,14 @@ public:
   }
 };
 
-template <typename OtherComponent, typename... ReplacedFunArgs, typename... ReplacementFunArgs,
-          typename... PreviousBindings>
+template <typename OtherComponent, typename... ReplacedFunArgs, typename... ReplacementFunArgs>
 class PartialComponentStorage<
-    ReplaceComponent<OtherComponent(ReplacedFunArgs...), OtherComponent(ReplacementFunArgs...)>, PreviousBindings...> {
+    ReplaceComponent<OtherComponent(ReplacedFunArgs...), OtherComponent(ReplacementFunArgs...)>>
+    : public PartialComponentStorageImpl<PartialComponentStorage<
+          ReplaceComponent<OtherComponent(ReplacedFunArgs...), OtherComponent(ReplacementFunArgs...)>>> {
 private:
   using previous_storage_t =
-      PartialComponentStorage<PartialReplaceComponent<OtherComponent(ReplacedFunArgs...)>, PreviousBindings...>;
+      PartialComponentStorage<PartialReplaceComponent<OtherComponent(ReplacedFunArgs...)>>;
 
   previous_storage_t& previous_storage;
   OtherComponent (*fun)(ReplacementFunArgs...);
@@ -17,18 +17,79 @@
 #ifndef FRUIT_PARTIAL_COMPONENT_STORAGE_H
 #define FRUIT_PARTIAL_COMPONENT_STORAGE_H
 
+#include <fruit/impl/bindings.h>
+#include <fruit/impl/component_storage/component_storage_entry.h>
+#include <fruit/impl/data_structures/fixed_size_vector.h>
+
 #include <cstddef>
 
 namespace fruit {
 namespace impl {
 
 /**
- * This class stores the data in a PartialComponent<Bindings...>.
+ * The interface used by each PartialComponentStorage to access the storage of the previous PartialComponent.
+ * This dispatches through function pointers instead of virtual methods, so that the (many) PartialComponentStorage
+ * instantiations don't each need a vtable and RTTI data (that would also contain their long type names).
+ */
+class PartialComponentStorageBase {
+public:
+  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries);
+  std::size_t numBindings() const;
+
+protected:
+  using add_bindings_t = void (*)(PartialComponentStorageBase&, FixedSizeVector<ComponentStorageEntry>&);
+  using num_bindings_t = std::size_t (*)(const PartialComponentStorageBase&);
+
+  PartialComponentStorageBase(add_bindings_t add_bindings, num_bindings_t num_bindings);
+
+private:
+  add_bindings_t add_bindings;
+  num_bindings_t num_bindings;
+};
+
+/**
+ * Implements the operations of PartialComponentStorageBase by calling the corresponding methods of Derived.
+ */
+template <typename Derived>
+class PartialComponentStorageImpl : public PartialComponentStorageBase {
+protected:
+  PartialComponentStorageImpl();
+
+private:
+  static void addBindingsOf(PartialComponentStorageBase& storage, FixedSizeVector<ComponentStorageEntry>& entries);
+  static std::size_t numBindingsOf(const PartialComponentStorageBase& storage);
+};
+
+/**
+ * The storage for a binding that doesn't need to store any data (e.g. Bind<I, C>), since all its entries are added by
+ * the Component constructor.
+ * Using a single (non-template) class for all these bindings avoids instantiating a separate storage type for each.
+ */
+class PartialComponentStorageWithNoData : public PartialComponentStorageImpl<PartialComponentStorageWithNoData> {
+private:
+  PartialComponentStorageBase& previous_storage;
+
+public:
+  // NOLINTNEXTLINE(google-explicit-constructor)
+  PartialComponentStorageWithNoData(PartialComponentStorageBase& previous_storage);
+
+  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries);
+  std::size_t numBindings() const;
+};
+
+/**
+ * This class stores the data in a PartialComponent<Binding, PreviousBindings...>.
  * Instead of dynamically-allocating space for the elements (and then having to move the storage from each
  * PartialComponent class to the next) we only store a reference to the previous PartialComponent's storage
  * and the data needed for the binding (if any).
  * We rely on the fact that the previous PartialComponent objects will only be destroyed after the current
  * one.
+ *
+ * This is only instantiated with 0 or 1 bindings (the last one added), and the previous storage is only accessed
+ * through PartialComponentStorageBase. This way the size of these types (and of their symbols) doesn't grow with the
+ * number of bindings in the PartialComponent.
+ * Bindings that don't need to store any data use PartialComponentStorageWithNoData instead, see
+ * PartialComponentStorageFor.
  */
 template <typename... Bindings>
 class PartialComponentStorage; /* {
@@ -41,6 +102,56 @@ All specializations support the following methods:
 template <typename... Bindings>
 class PartialComponentStorage {};
 
+template <typename... Bindings>
+struct PartialComponentStorageForHelper {
+  using type = PartialComponentStorage<>;
+};
+
+template <typename Binding, typename... PreviousBindings>
+struct PartialComponentStorageForHelper<Binding, PreviousBindings...> {
+  using type = PartialComponentStorage<Binding>;
+};
+
+template <typename I, typename C, typename... PreviousBindings>
+struct PartialComponentStorageForHelper<Bind<I, C>, PreviousBindings...> {
+  using type = PartialComponentStorageWithNoData;
+};
+
+template <typename Signature, typename... PreviousBindings>
+struct PartialComponentStorageForHelper<RegisterConstructor<Signature>, PreviousBindings...> {
+  using type = PartialComponentStorageWithNoData;
+};
+
+template <typename... Params, typename... PreviousBindings>
+struct PartialComponentStorageForHelper<RegisterProvider<Params...>, PreviousBindings...> {
+  using type = PartialComponentStorageWithNoData;
+};
+
+template <typename I, typename C, typename... PreviousBindings>
+struct PartialComponentStorageForHelper<AddMultibinding<I, C>, PreviousBindings...> {
+  using type = PartialComponentStorageWithNoData;
+};
+
+template <typename... Params, typename... PreviousBindings>
+struct PartialComponentStorageForHelper<AddMultibindingProvider<Params...>, PreviousBindings...> {
+  using type = PartialComponentStorageWithNoData;
+};
+
+template <typename DecoratedSignature, typename Lambda, typename... PreviousBindings>
+struct PartialComponentStorageForHelper<RegisterFactory<DecoratedSignature, Lambda>, PreviousBindings...> {
+  using type = PartialComponentStorageWithNoData;
+};
+
+template <typename DecoratedSignature, typename Lambda, std::size_t max_cached_objects, typename... PreviousBindings>
+struct PartialComponentStorageForHelper<RegisterMemoizedFactory<DecoratedSignature, Lambda, max_cached_objects>,
+                                        PreviousBindings...> {
+  using type = PartialComponentStorageWithNoData;
+};
+
+// The type of the storage of a PartialComponent<Bindings...>.
+template <typename... Bindings>
+using PartialComponentStorageFor = typename PartialComponentStorageForHelper<Bindings...>::type;
+
 } // namespace impl
 } // namespace fruit
 
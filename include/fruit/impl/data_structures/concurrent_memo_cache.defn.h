@@ -0,0 +1,255 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_CONCURRENT_MEMO_CACHE_DEFN_H
+#define FRUIT_CONCURRENT_MEMO_CACHE_DEFN_H
+
+#include <fruit/impl/data_structures/hazard_pointers.h>
+#include <fruit/impl/fruit_assert.h>
+
+// Redundant, but makes KDevelop happy.
+#include <fruit/impl/data_structures/concurrent_memo_cache.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+namespace fruit {
+namespace impl {
+
+template <typename Key, typename Value, typename Hasher>
+constexpr std::size_t ConcurrentMemoCache<Key, Value, Hasher>::num_shards;
+
+template <typename Key, typename Value, typename Hasher>
+inline ConcurrentMemoCache<Key, Value, Hasher>::Table::Table(std::size_t num_slots)
+    : mask(num_slots - 1), slots(new std::atomic<Entry*>[num_slots]) {
+  for (std::size_t i = 0; i < num_slots; ++i) {
+    slots[i].store(nullptr);
+  }
+}
+
+template <typename Key, typename Value, typename Hasher>
+inline ConcurrentMemoCache<Key, Value, Hasher>::ConcurrentMemoCache(std::size_t max_size)
+    : max_entries_per_shard((max_size + num_shards - 1) / num_shards),
+      shards_memory(new char[num_shards * sizeof(Shard) + alignof(Shard) - 1]) {
+  std::uintptr_t address = reinterpret_cast<std::uintptr_t>(shards_memory.get());
+  shards = reinterpret_cast<Shard*>(shards_memory.get() + (alignof(Shard) - address % alignof(Shard)) % alignof(Shard));
+  for (std::size_t i = 0; i < num_shards; ++i) {
+    new (&shards[i]) Shard();
+    shards[i].table.store(new Table(8));
+    shards[i].num_used_slots = 0;
+  }
+}
+
+template <typename Key, typename Value, typename Hasher>
+inline ConcurrentMemoCache<Key, Value, Hasher>::~ConcurrentMemoCache() {
+  for (std::size_t i = 0; i < num_shards; ++i) {
+    Shard& shard = shards[i];
+    for (Entry* entry : shard.entries) {
+      delete entry;
+    }
+    for (Entry* entry : shard.retired_entries) {
+      delete entry;
+    }
+    for (Table* table : shard.retired_tables) {
+      delete table;
+    }
+    delete shard.table.load();
+    shard.~Shard();
+  }
+}
+
+template <typename Key, typename Value, typename Hasher>
+template <typename F>
+inline std::shared_ptr<Value> ConcurrentMemoCache<Key, Value, Hasher>::getOrCreate(const Key& key, F create) {
+  std::size_t hash = getHash(key);
+  Shard& shard = getShard(hash);
+  std::shared_ptr<Value> result = find(shard, hash, key);
+  if (result != nullptr) {
+    return result;
+  }
+
+  // This is not done while holding the mutex, since `create' might (directly or indirectly) use this cache again.
+  std::shared_ptr<Value> value = create();
+
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  Entry* existing_entry = findEntry(*shard.table.load(), hash, key);
+  if (existing_entry != nullptr) {
+    // Another thread inserted a value for this key in the meantime.
+    return existing_entry->value;
+  }
+  if (max_entries_per_shard != 0 && shard.entries.size() >= max_entries_per_shard) {
+    removeOldestEntry(shard);
+  }
+  std::size_t num_slots = shard.table.load()->mask + 1;
+  if ((shard.num_used_slots + 1) * 2 > num_slots) {
+    // If most used slots are tombstones, this just removes them.
+    std::size_t new_num_slots = 8;
+    while (new_num_slots < (shard.entries.size() + 1) * 4) {
+      new_num_slots *= 2;
+    }
+    rehash(shard, new_num_slots);
+  }
+  Entry* entry = new Entry{hash, key, value};
+  insertInTable(*shard.table.load(), entry);
+  ++shard.num_used_slots;
+  shard.entries.push_back(entry);
+  deleteUnprotectedRetired(shard);
+  return value;
+}
+
+template <typename Key, typename Value, typename Hasher>
+inline typename ConcurrentMemoCache<Key, Value, Hasher>::Entry* ConcurrentMemoCache<Key, Value, Hasher>::tombstone() {
+  // Only the address is used, this is never accessed.
+  static typename std::aligned_storage<sizeof(Entry), alignof(Entry)>::type storage;
+  return reinterpret_cast<Entry*>(&storage);
+}
+
+template <typename Key, typename Value, typename Hasher>
+inline std::size_t ConcurrentMemoCache<Key, Value, Hasher>::getHash(const Key& key) {
+  return Hasher()(key);
+}
+
+template <typename Key, typename Value, typename Hasher>
+inline typename ConcurrentMemoCache<Key, Value, Hasher>::Shard&
+ConcurrentMemoCache<Key, Value, Hasher>::getShard(std::size_t hash) {
+  return shards[hash % num_shards];
+}
+
+template <typename Key, typename Value, typename Hasher>
+inline std::shared_ptr<Value> ConcurrentMemoCache<Key, Value, Hasher>::find(Shard& shard, std::size_t hash,
+                                                                           const Key& key) {
+  // All the atomic operations here (and the ones that remove entries/tables) are sequentially consistent, as required
+  // by HazardPointers.
+  std::atomic<const void*>* hazard_pointers = HazardPointers::getThreadPointers();
+  std::shared_ptr<Value> result;
+  bool done = false;
+  while (!done) {
+    Table* table = shard.table.load();
+    hazard_pointers[0].store(table);
+    if (shard.table.load() != table) {
+      // A rehash replaced it in the meantime, so it might have been deleted already.
+      continue;
+    }
+    done = true;
+    for (std::size_t i = (hash / num_shards) & table->mask;; i = (i + 1) & table->mask) {
+      Entry* entry = table->slots[i].load();
+      if (entry == nullptr) {
+        break;
+      }
+      if (entry == tombstone()) {
+        continue;
+      }
+      hazard_pointers[1].store(entry);
+      // An entry is only deleted after it's removed from the current table, so if it's still there it's safe to use.
+      if (table->slots[i].load() != entry || shard.table.load() != table) {
+        done = false;
+        break;
+      }
+      if (entry->hash == hash && entry->key == key) {
+        result = entry->value;
+        break;
+      }
+    }
+  }
+  hazard_pointers[0].store(nullptr);
+  hazard_pointers[1].store(nullptr);
+  return result;
+}
+
+template <typename Key, typename Value, typename Hasher>
+inline typename ConcurrentMemoCache<Key, Value, Hasher>::Entry*
+ConcurrentMemoCache<Key, Value, Hasher>::findEntry(Table& table, std::size_t hash, const Key& key) {
+  for (std::size_t i = (hash / num_shards) & table.mask;; i = (i + 1) & table.mask) {
+    Entry* entry = table.slots[i].load();
+    if (entry == nullptr) {
+      return nullptr;
+    }
+    if (entry != tombstone() && entry->hash == hash && entry->key == key) {
+      return entry;
+    }
+  }
+}
+
+template <typename Key, typename Value, typename Hasher>
+inline void ConcurrentMemoCache<Key, Value, Hasher>::insertInTable(Table& table, Entry* entry) {
+  // Tombstones are not reused, so that the number of used slots can only be decreased by rehash().
+  std::size_t i = (entry->hash / num_shards) & table.mask;
+  while (table.slots[i].load() != nullptr) {
+    i = (i + 1) & table.mask;
+  }
+  table.slots[i].store(entry);
+}
+
+template <typename Key, typename Value, typename Hasher>
+inline void ConcurrentMemoCache<Key, Value, Hasher>::removeOldestEntry(Shard& shard) {
+  Entry* entry = shard.entries.front();
+  shard.entries.pop_front();
+  Table& table = *shard.table.load();
+  std::size_t i = (entry->hash / num_shards) & table.mask;
+  while (table.slots[i].load() != entry) {
+    i = (i + 1) & table.mask;
+  }
+  table.slots[i].store(tombstone());
+  shard.retired_entries.push_back(entry);
+}
+
+template <typename Key, typename Value, typename Hasher>
+inline void ConcurrentMemoCache<Key, Value, Hasher>::rehash(Shard& shard, std::size_t num_slots) {
+  Table* new_table = new Table(num_slots);
+  for (Entry* entry : shard.entries) {
+    insertInTable(*new_table, entry);
+  }
+  Table* old_table = shard.table.exchange(new_table);
+  shard.retired_tables.push_back(old_table);
+  shard.num_used_slots = shard.entries.size();
+}
+
+template <typename Key, typename Value, typename Hasher>
+template <typename T>
+inline void
+ConcurrentMemoCache<Key, Value, Hasher>::deleteUnprotected(std::vector<T*>& retired,
+                                                           const std::vector<const void*>& protected_pointers) {
+  std::size_t num_kept = 0;
+  for (T* p : retired) {
+    if (std::binary_search(protected_pointers.begin(), protected_pointers.end(), static_cast<const void*>(p))) {
+      retired[num_kept++] = p;
+    } else {
+      delete p;
+    }
+  }
+  retired.resize(num_kept);
+}
+
+template <typename Key, typename Value, typename Hasher>
+inline void ConcurrentMemoCache<Key, Value, Hasher>::deleteUnprotectedRetired(Shard& shard) {
+  if (shard.retired_entries.empty() && shard.retired_tables.empty()) {
+    return;
+  }
+  // Only the entries/tables that a lookup is currently reading are kept, so each shard keeps at most
+  // HazardPointers::num_pointers_per_thread of them for each thread.
+  std::vector<const void*> protected_pointers;
+  HazardPointers::getProtectedPointers(protected_pointers);
+  std::sort(protected_pointers.begin(), protected_pointers.end());
+  deleteUnprotected(shard.retired_entries, protected_pointers);
+  deleteUnprotected(shard.retired_tables, protected_pointers);
+}
+
+} // namespace impl
+} // namespace fruit
+
+#endif // FRUIT_CONCURRENT_MEMO_CACHE_DEFN_H
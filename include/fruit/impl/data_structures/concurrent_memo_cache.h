@@ -0,0 +1,131 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_CONCURRENT_MEMO_CACHE_H
+#define FRUIT_CONCURRENT_MEMO_CACHE_H
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace fruit {
+namespace impl {
+
+/**
+ * A map from Key to std::shared_ptr<Value> used to memoize the results of a function, that can be accessed
+ * concurrently by multiple threads.
+ *
+ * The map is split into shards (by hash), and each shard is an open-addressing hash table of atomic pointers to
+ * immutable entries. Lookups never lock and only write to the hazard pointers of the calling thread (see
+ * HazardPointers). Entries (and tables) that are removed are deleted by a later insertion in the same shard, unless a
+ * lookup is still reading them. Insertions lock a per-shard mutex.
+ *
+ * If max_size is not 0, each shard holds at most max_size/num_shards entries (rounded up), and inserting in a full
+ * shard evicts the entry of that shard that was inserted first.
+ *
+ * Hasher must be default-constructible and hash a Key into a std::size_t.
+ */
+template <typename Key, typename Value, typename Hasher>
+class ConcurrentMemoCache {
+public:
+  // max_size==0 means that the cache is unbounded.
+  explicit ConcurrentMemoCache(std::size_t max_size);
+
+  ConcurrentMemoCache(const ConcurrentMemoCache&) = delete;
+  ConcurrentMemoCache& operator=(const ConcurrentMemoCache&) = delete;
+
+  ~ConcurrentMemoCache();
+
+  // Returns the cached value for `key' if there is one, otherwise calls create() and caches the result.
+  // create() is called without holding any lock, so if multiple threads look for the same missing key concurrently
+  // create() might be called more than once; all callers get the value that was cached first.
+  template <typename F>
+  std::shared_ptr<Value> getOrCreate(const Key& key, F create);
+
+private:
+  static constexpr std::size_t num_shards = 16;
+
+  struct Entry {
+    std::size_t hash;
+    Key key;
+    std::shared_ptr<Value> value;
+  };
+
+  struct Table {
+    // The number of slots is a power of 2, and at most half of them are used (including tombstones), so that
+    // lookups always find an empty slot eventually.
+    std::size_t mask;
+    std::unique_ptr<std::atomic<Entry*>[]> slots;
+
+    explicit Table(std::size_t num_slots);
+  };
+
+  // Shards are in separate cache lines, so that insertions in a shard don't slow down lookups in other shards.
+  struct alignas(64) Shard {
+    std::atomic<Table*> table;
+
+    // Only used by insertions; the fields below are protected by this mutex.
+    std::mutex mutex;
+
+    // The number of non-empty slots of `table' (including tombstones).
+    std::size_t num_used_slots;
+
+    // The entries currently in `table', in insertion order.
+    std::deque<Entry*> entries;
+
+    // Entries and tables that were removed but might still be read by a lookup.
+    std::vector<Entry*> retired_entries;
+    std::vector<Table*> retired_tables;
+  };
+
+  std::size_t max_entries_per_shard;
+
+  // Shard is over-aligned, and operator new only guarantees alignof(std::max_align_t) before C++17, so the shards are
+  // constructed in this (larger) buffer instead.
+  std::unique_ptr<char[]> shards_memory;
+  Shard* shards;
+
+  // The value stored in the slots of removed entries.
+  static Entry* tombstone();
+
+  static std::size_t getHash(const Key& key);
+
+  Shard& getShard(std::size_t hash);
+
+  // Returns nullptr if there's no entry for `key'. Doesn't lock.
+  std::shared_ptr<Value> find(Shard& shard, std::size_t hash, const Key& key);
+
+  // These must be called with shard.mutex held.
+  Entry* findEntry(Table& table, std::size_t hash, const Key& key);
+  void insertInTable(Table& table, Entry* entry);
+  void removeOldestEntry(Shard& shard);
+  void rehash(Shard& shard, std::size_t num_slots);
+  void deleteUnprotectedRetired(Shard& shard);
+
+  // Deletes the elements of `retired' that are not in `protected_pointers' (that must be sorted), and removes them.
+  template <typename T>
+  static void deleteUnprotected(std::vector<T*>& retired, const std::vector<const void*>& protected_pointers);
+};
+
+} // namespace impl
+} // namespace fruit
+
+#include <fruit/impl/data_structures/concurrent_memo_cache.defn.h>
+
+#endif // FRUIT_CONCURRENT_MEMO_CACHE_H
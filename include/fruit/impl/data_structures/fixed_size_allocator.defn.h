@@ -62,6 +62,13 @@ inline std::size_t FixedSizeAllocator::FixedSizeAllocatorData::maximumRequiredSp
   return type.type_info->alignment() + type.type_info->size() - 1;
 }
 
+inline std::size_t FixedSizeAllocator::FixedSizeAllocatorData::getRequiredBufferSize() const {
+  // The alignof()-1 is for aligning the on_destruction entries at the beginning of the buffer and the +1 is because we
+  // waste the first byte of the object storage (storage_last_used points to the byte before the first usable one).
+  return alignof(std::pair<destroy_t, void*>) - 1 + num_types_to_destroy * sizeof(std::pair<destroy_t, void*>) +
+         total_size + 1;
+}
+
 template <typename AnnotatedT, typename... Args>
 FRUIT_ALWAYS_INLINE inline fruit::impl::meta::UnwrapType<
     fruit::impl::meta::Eval<fruit::impl::meta::RemoveAnnotations(fruit::impl::meta::Type<AnnotatedT>)>>*
@@ -88,21 +95,68 @@ FixedSizeAllocator::constructObject(Args&&... args) {
   // We still run this later though, since if T's constructor throws we don't want to
   // destruct this object in FixedSizeAllocator's destructor.
   if (!std::is_trivially_destructible<T>::value) {
-    on_destruction.push_back(std::pair<destroy_t, void*>{destroyObject<T>, x});
+    FruitAssert(on_destruction_end != on_destruction_end_of_storage);
+    *on_destruction_end = std::pair<destroy_t, void*>{destroyObject<T>, x};
+    ++on_destruction_end;
   }
   return x;
 }
 
 template <typename T>
 inline void FixedSizeAllocator::registerExternallyAllocatedObject(T* p) {
-  on_destruction.push_back(std::pair<destroy_t, void*>{destroyExternalObject<T>, p});
+  FruitAssert(on_destruction_end != on_destruction_end_of_storage);
+  *on_destruction_end = std::pair<destroy_t, void*>{destroyExternalObject<T>, p};
+  ++on_destruction_end;
+}
+
+inline std::size_t FixedSizeAllocator::numObjectsToDestroy() const {
+  return on_destruction_end - on_destruction_begin;
+}
+
+inline std::size_t FixedSizeAllocator::numUsedBytes() const {
+  if (storage_begin == nullptr) {
+    return 0;
+  }
+  // storage_last_used points to the last used byte, not to the first unused one.
+  return storage_last_used + 1 - storage_begin;
 }
 
-inline FixedSizeAllocator::FixedSizeAllocator(const FixedSizeAllocatorData& allocator_data)
-    : on_destruction(allocator_data.num_types_to_destroy) {
-  // The +1 is because we waste the first byte (storage_last_used points to the beginning of storage).
-  storage_begin = new char[allocator_data.total_size + 1];
-  storage_last_used = storage_begin;
+inline void FixedSizeAllocator::destroyObjectAt(std::size_t index) {
+  FruitAssert(index < numObjectsToDestroy());
+  std::pair<destroy_t, void*>& p = on_destruction_begin[index];
+  p.first(p.second);
+}
+
+inline void FixedSizeAllocator::clearObjectsToDestroy() {
+  on_destruction_end = on_destruction_begin;
+}
+
+inline std::pair<FixedSizeAllocator::destroy_t, void*> FixedSizeAllocator::releaseObjectAt(std::size_t index) {
+  FruitAssert(index < numObjectsToDestroy());
+  std::pair<destroy_t, void*> result = on_destruction_begin[index];
+  on_destruction_begin[index] = std::pair<destroy_t, void*>{destroyNothing, nullptr};
+  return result;
+}
+
+inline FixedSizeAllocator::FixedSizeAllocator(const FixedSizeAllocatorData& allocator_data, void* buffer,
+                                              std::size_t buffer_size) {
+  std::size_t required_buffer_size = allocator_data.getRequiredBufferSize();
+  // Only used in assertions.
+  (void)buffer_size;
+  if (buffer != nullptr) {
+    FruitAssert(buffer_size >= required_buffer_size);
+    storage_begin = static_cast<char*>(buffer);
+    owns_storage = false;
+  } else {
+    storage_begin = new char[required_buffer_size];
+    owns_storage = true;
+  }
+  std::size_t misalignment = std::uintptr_t(storage_begin) % alignof(std::pair<destroy_t, void*>);
+  std::size_t padding = misalignment == 0 ? 0 : alignof(std::pair<destroy_t, void*>) - misalignment;
+  on_destruction_begin = reinterpret_cast<std::pair<destroy_t, void*>*>(storage_begin + padding);
+  on_destruction_end = on_destruction_begin;
+  on_destruction_end_of_storage = on_destruction_begin + allocator_data.num_types_to_destroy;
+  storage_last_used = reinterpret_cast<char*>(on_destruction_end_of_storage);
 #if FRUIT_EXTRA_DEBUG
   remaining_types = allocator_data.types;
   std::cerr << "Constructing allocator for types:";
@@ -116,7 +170,11 @@ inline FixedSizeAllocator::FixedSizeAllocator(const FixedSizeAllocatorData& allo
 inline FixedSizeAllocator::FixedSizeAllocator(FixedSizeAllocator&& x) noexcept : FixedSizeAllocator() {
   std::swap(storage_begin, x.storage_begin);
   std::swap(storage_last_used, x.storage_last_used);
-  std::swap(on_destruction, x.on_destruction);
+  std::swap(owns_storage, x.owns_storage);
+  std::swap(shared_storage, x.shared_storage);
+  std::swap(on_destruction_begin, x.on_destruction_begin);
+  std::swap(on_destruction_end, x.on_destruction_end);
+  std::swap(on_destruction_end_of_storage, x.on_destruction_end_of_storage);
 #if FRUIT_EXTRA_DEBUG
   std::swap(remaining_types, x.remaining_types);
 #endif
@@ -125,7 +183,11 @@ inline FixedSizeAllocator::FixedSizeAllocator(FixedSizeAllocator&& x) noexcept :
 inline FixedSizeAllocator& FixedSizeAllocator::operator=(FixedSizeAllocator&& x) noexcept {
   std::swap(storage_begin, x.storage_begin);
   std::swap(storage_last_used, x.storage_last_used);
-  std::swap(on_destruction, x.on_destruction);
+  std::swap(owns_storage, x.owns_storage);
+  std::swap(shared_storage, x.shared_storage);
+  std::swap(on_destruction_begin, x.on_destruction_begin);
+  std::swap(on_destruction_end, x.on_destruction_end);
+  std::swap(on_destruction_end_of_storage, x.on_destruction_end_of_storage);
 #if FRUIT_EXTRA_DEBUG
   std::swap(remaining_types, x.remaining_types);
 #endif
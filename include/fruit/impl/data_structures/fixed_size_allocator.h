@@ -17,10 +17,12 @@
 #ifndef FRUIT_FIXED_SIZE_ALLOCATOR_H
 #define FRUIT_FIXED_SIZE_ALLOCATOR_H
 
-#include <fruit/impl/data_structures/fixed_size_vector.h>
 #include <fruit/impl/meta/component.h>
 #include <fruit/impl/util/type_info.h>
 
+#include <memory>
+#include <utility>
+
 #if FRUIT_EXTRA_DEBUG
 #include <unordered_map>
 #endif
@@ -40,17 +42,28 @@ private:
   // A pointer to the last used byte in the allocated memory chunk starting at storage_begin.
   char* storage_last_used = nullptr;
 
-  // The chunk of memory that will be used for all allocations.
+  // The chunk of memory that will be used for all allocations. It starts with the on_destruction entries, followed by
+  // the memory for the objects.
   char* storage_begin = nullptr;
 
+  // Whether storage_begin was allocated by this object (and must be deallocated on destruction) or is a buffer that
+  // was provided by the caller (or is owned by shared_storage).
+  bool owns_storage = false;
+
+  // Only set after shareStorage() is called on an allocator that allocated storage_begin.
+  std::shared_ptr<char> shared_storage;
+
 #if FRUIT_EXTRA_DEBUG
   std::unordered_map<TypeId, std::size_t> remaining_types;
 #endif
 
-  // This vector contains the destroy operations that have to be performed at destruction, and
+  // This range contains the destroy operations that have to be performed at destruction, and
   // the pointers that they must be invoked with. Allows destruction in the correct order.
   // These must be called in reverse order.
-  FixedSizeVector<std::pair<destroy_t, void*>> on_destruction;
+  // The capacity is precomputed in FixedSizeAllocatorData, so this never needs to grow.
+  std::pair<destroy_t, void*>* on_destruction_begin = nullptr;
+  std::pair<destroy_t, void*>* on_destruction_end = nullptr;
+  std::pair<destroy_t, void*>* on_destruction_end_of_storage = nullptr;
 
   // Destroys an object previously created using constructObject().
   template <typename C>
@@ -60,6 +73,9 @@ private:
   template <typename C>
   static void destroyExternalObject(void* p);
 
+  // Used for the objects released with releaseObjectAt().
+  static void destroyNothing(void* p);
+
 public:
   // Data used to construct an allocator for a fixed set of types.
   class FixedSizeAllocatorData {
@@ -83,13 +99,21 @@ public:
     // resulting
     // allocator.
     void addExternallyAllocatedType(TypeId typeId);
+
+    // The size of the single block of memory needed by an allocator constructed from this object. A buffer of at least
+    // this size (with any alignment) can be passed to the FixedSizeAllocator constructor to avoid a heap allocation.
+    std::size_t getRequiredBufferSize() const;
   };
 
   // Constructs an empty allocator (no allocations are allowed).
   FixedSizeAllocator() = default;
 
   // Constructs an allocator for the type set in FixedSizeAllocatorData.
-  explicit FixedSizeAllocator(const FixedSizeAllocatorData& allocator_data);
+  // If `buffer' is not nullptr, all memory is taken from it (it must outlive this object) and no heap allocation is
+  // performed; in that case buffer_size must be at least allocator_data.getRequiredBufferSize(). Otherwise a single
+  // block is allocated instead.
+  explicit FixedSizeAllocator(const FixedSizeAllocatorData& allocator_data, void* buffer = nullptr,
+                              std::size_t buffer_size = 0);
 
   FixedSizeAllocator(FixedSizeAllocator&&) noexcept;
   FixedSizeAllocator& operator=(FixedSizeAllocator&&) noexcept;
@@ -110,6 +134,30 @@ public:
 
   template <typename T>
   void registerExternallyAllocatedObject(T* p);
+
+  // The number of objects (allocated or externally-allocated) that will be destroyed by this allocator, in the order in
+  // which they were registered.
+  std::size_t numObjectsToDestroy() const;
+
+  // The number of bytes of the memory block used so far (including the bytes reserved for the destruction entries and
+  // the alignment padding).
+  std::size_t numUsedBytes() const;
+
+  // Destroys the index-th object to destroy. This can be called concurrently for different indexes.
+  // After this, clearObjectsToDestroy() must be called before destroying the allocator.
+  void destroyObjectAt(std::size_t index);
+
+  // Forgets all objects to destroy, e.g. because they were already destroyed with destroyObjectAt().
+  void clearObjectsToDestroy();
+
+  // Returns the index-th object to destroy (with the function that destroys it), and makes this allocator no longer
+  // destroy it. The caller becomes responsible for destroying it, before the memory block of this allocator is
+  // deallocated (see shareStorage()).
+  std::pair<destroy_t, void*> releaseObjectAt(std::size_t index);
+
+  // Returns a shared_ptr that keeps the memory block of this allocator alive, even after this allocator is destroyed.
+  // Returns nullptr if the memory block was provided by the caller, since then the caller keeps it alive.
+  std::shared_ptr<char> shareStorage();
 };
 
 } // namespace impl
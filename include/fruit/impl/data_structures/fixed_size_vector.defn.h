@@ -63,6 +63,11 @@ inline std::size_t FixedSizeVector<T, Allocator>::size() const {
   return end() - begin();
 }
 
+template <typename T, typename Allocator>
+inline std::size_t FixedSizeVector<T, Allocator>::getCapacity() const {
+  return capacity;
+}
+
 template <typename T, typename Allocator>
 inline T& FixedSizeVector<T, Allocator>::operator[](std::size_t i) {
   FruitAssert(begin() + i < end());
@@ -60,6 +60,8 @@ public:
 
   std::size_t size() const;
 
+  std::size_t getCapacity() const;
+
   T& operator[](std::size_t i);
   const T& operator[](std::size_t i) const;
 
@@ -0,0 +1,54 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef FRUIT_HAZARD_POINTERS_H
+#define FRUIT_HAZARD_POINTERS_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace fruit {
+namespace impl {
+
+/**
+ * Process-wide hazard pointers, for data structures with lock-free readers (e.g. ConcurrentMemoCache).
+ *
+ * Before dereferencing a pointer to shared data, a reader stores it in one of its hazard pointers and then checks that
+ * the data is still reachable (otherwise it must not use it). A writer that unlinked some data can delete it once it's
+ * not in getProtectedPointers() anymore. So at most num_pointers_per_thread objects per thread can be waiting to be
+ * deleted, no matter how long a reader takes.
+ *
+ * The hazard pointers of a thread are in their own cache line, so readers don't contend with each other.
+ * All the operations on the shared data must be sequentially consistent.
+ */
+class HazardPointers {
+public:
+  static constexpr std::size_t num_pointers_per_thread = 2;
+
+  // Returns the num_pointers_per_thread hazard pointers of the calling thread. They're initially nullptr, and they must
+  // be reset to nullptr when the reader is done.
+  static std::atomic<const void*>* getThreadPointers();
+
+  // Appends to `result' the non-null hazard pointers of all threads.
+  static void getProtectedPointers(std::vector<const void*>& result);
+};
+
+} // namespace impl
+} // namespace fruit
+
+#endif // FRUIT_HAZARD_POINTERS_H
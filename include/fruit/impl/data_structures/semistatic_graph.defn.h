@@ -87,6 +87,23 @@ SemistaticGraph<NodeId, Node>::node_iterator::neighborsBegin() {
   return edge_iterator{reinterpret_cast<InternalNodeId*>(itr->edges_begin)};
 }
 
+template <typename NodeId, typename Node>
+inline std::size_t SemistaticGraph<NodeId, Node>::node_iterator::numNeighbors() {
+  FruitAssert(itr->edges_begin != 0);
+  FruitAssert(itr->edges_begin != 1);
+  return reinterpret_cast<InternalNodeId*>(itr->edges_begin)[-1].id / 2;
+}
+
+template <typename NodeId, typename Node>
+inline bool SemistaticGraph<NodeId, Node>::node_iterator::isLazyNeighbor(std::size_t i) {
+  FruitAssert(itr->edges_begin != 0);
+  FruitAssert(itr->edges_begin != 1);
+  InternalNodeId* edges = reinterpret_cast<InternalNodeId*>(itr->edges_begin);
+  std::size_t header = edges[-1].id;
+  FruitAssert(i < header / 2);
+  return (header % 2) != 0 && edges[header / 2 + i].id != 0;
+}
+
 template <typename NodeId, typename Node>
 inline SemistaticGraph<NodeId, Node>::edge_iterator::edge_iterator(InternalNodeId* itr) : itr(itr) {}
 
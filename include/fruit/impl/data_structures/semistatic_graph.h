@@ -90,9 +90,19 @@ private:
   // Stores vectors of edges as contiguous chunks of node IDs.
   // The NodeData elements in `nodes' contain indexes into this vector (stored as already multiplied by
   // sizeof(NodeData)).
+  // Each chunk is preceded by an element whose id is (number of edges) * 2 + (1 if some edges are lazy), and if some
+  // edges are lazy it's followed by an element for each edge, whose id is 1 for lazy edges and 0 for the others.
   // The first element is unused.
   FixedSizeVector<InternalNodeId> edges_storage;
 
+  // Appends the edges of the node *i to edges_storage, and returns the value of edges_begin for that node.
+  template <typename NodeIter>
+  std::uintptr_t addEdges(NodeIter i);
+
+  // The number of elements of edges_storage used by the node *i (assuming that it's not terminal).
+  template <typename NodeIter>
+  static std::size_t getNumEdgesStorageElements(NodeIter i);
+
 #if FRUIT_EXTRA_DEBUG
   template <typename NodeIter>
   void printGraph(NodeIter first, NodeIter last);
@@ -124,10 +134,16 @@ public:
     void setTerminal();
 
     // Assumes !isTerminal().
-    // neighborsEnd() is NOT provided/stored for efficiency, the client code is expected to know the number of
-    // neighbors.
+    // neighborsEnd() is NOT provided for efficiency, the client code is expected to know the number of neighbors (or
+    // to call numNeighbors()).
     edge_iterator neighborsBegin();
 
+    // Assumes !isTerminal().
+    std::size_t numNeighbors();
+
+    // Whether the i-th neighbor was marked as lazy when the graph was constructed. Assumes !isTerminal().
+    bool isLazyNeighbor(std::size_t i);
+
     bool operator==(const node_iterator&) const;
   };
 
@@ -180,6 +196,9 @@ public:
    * - x.isTerminal(), returning a bool
    * - x.getEdgesBegin() and x.getEdgesEnd(), that if !x.isTerminal() define a range of values of type NodeId
    *   (the outgoing edges).
+   * - x.getLazyEdgesBegin(), that if !x.isTerminal() returns either nullptr (if no edge is lazy) or a pointer to an
+   *   array of bools with an element for each edge, that is true for the lazy edges. The graph only stores this
+   *   information, see node_iterator::isLazyNeighbor().
    *
    * This constructor is *not* defined in semistatic_graph.templates.h, but only in semistatic_graph.cc.
    * All instantiations must have a matching instantiation in semistatic_graph.cc.
@@ -226,6 +245,22 @@ public:
   node_iterator find(NodeId nodeId);
   const_node_iterator find(NodeId nodeId) const;
 
+  // Calls f(nodeId, node_iterator) for each node of the graph, in an unspecified order. Nodes that are only referenced
+  // by an edge (and that were never added to the graph) are skipped.
+  // This is defined in semistatic_graph.templates.h.
+  template <typename F>
+  void forEachNode(F f);
+
+  /**
+   * Frees the edges and replaces the lookup table with one that only contains the nodes in [first, last) (that must be
+   * in the graph), to save memory once no more nodes will be looked up or constructed.
+   * After this, at(), find() and forEachNode() only see the nodes in [first, last), and neighborsBegin() must not be
+   * called on any node. The nodes stay at the same addresses, so existing node_iterators remain valid.
+   *
+   * The MemoryPool is only used during this call.
+   */
+  void compact(const NodeId* first, const NodeId* last, MemoryPool& memory_pool);
+
 #if FRUIT_EXTRA_DEBUG
   // Emits a runtime error if some node was not created but there is an edge pointing to it.
   void checkFullyConstructed();
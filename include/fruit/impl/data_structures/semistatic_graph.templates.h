@@ -79,6 +79,36 @@ void SemistaticGraph<NodeId, Node>::printGraph(NodeIter first, NodeIter last) {
 }
 #endif // FRUIT_EXTRA_DEBUG
 
+template <typename NodeId, typename Node>
+template <typename NodeIter>
+std::size_t SemistaticGraph<NodeId, Node>::getNumEdgesStorageElements(NodeIter i) {
+  std::size_t num_edges = i->getEdgesEnd() - i->getEdgesBegin();
+  if (i->getLazyEdgesBegin() == nullptr) {
+    return 1 + num_edges;
+  } else {
+    return 1 + 2 * num_edges;
+  }
+}
+
+template <typename NodeId, typename Node>
+template <typename NodeIter>
+std::uintptr_t SemistaticGraph<NodeId, Node>::addEdges(NodeIter i) {
+  std::size_t num_edges = i->getEdgesEnd() - i->getEdgesBegin();
+  const bool* lazy_edges_begin = i->getLazyEdgesBegin();
+  edges_storage.push_back(InternalNodeId{num_edges * 2 + (lazy_edges_begin == nullptr ? 0 : 1)});
+  std::uintptr_t edges_begin = reinterpret_cast<std::uintptr_t>(edges_storage.data() + edges_storage.size());
+  for (auto j = i->getEdgesBegin(); j != i->getEdgesEnd(); ++j) {
+    InternalNodeId other_node_id = node_index_map.at(*j);
+    edges_storage.push_back(other_node_id);
+  }
+  if (lazy_edges_begin != nullptr) {
+    for (std::size_t j = 0; j < num_edges; ++j) {
+      edges_storage.push_back(InternalNodeId{lazy_edges_begin[j] ? std::size_t(1) : std::size_t(0)});
+    }
+  }
+  return edges_begin;
+}
+
 template <typename NodeId, typename Node>
 template <typename NodeIter>
 SemistaticGraph<NodeId, Node>::SemistaticGraph(NodeIter first, NodeIter last, MemoryPool& memory_pool) {
@@ -90,8 +120,8 @@ SemistaticGraph<NodeId, Node>::SemistaticGraph(NodeIter first, NodeIter last, Me
     if (!i->isTerminal()) {
       for (auto j = i->getEdgesBegin(); j != i->getEdgesEnd(); ++j) {
         node_ids.insert(*j);
-        ++num_edges;
       }
+      num_edges += getNumEdgesStorageElements(i);
     }
   }
 
@@ -123,11 +153,7 @@ SemistaticGraph<NodeId, Node>::SemistaticGraph(NodeIter first, NodeIter last, Me
     if (i->isTerminal()) {
       nodeData.edges_begin = 0;
     } else {
-      nodeData.edges_begin = reinterpret_cast<std::uintptr_t>(edges_storage.data() + edges_storage.size());
-      for (auto j = i->getEdgesBegin(); j != i->getEdgesEnd(); ++j) {
-        InternalNodeId other_node_id = node_index_map.at(*j);
-        edges_storage.push_back(other_node_id);
-      }
+      nodeData.edges_begin = addEdges(i);
     }
   }
 
@@ -161,8 +187,8 @@ SemistaticGraph<NodeId, Node>::SemistaticGraph(const SemistaticGraph& x, NodeIte
         if (x.node_index_map.find(*j) == nullptr) {
           node_ids.push_back(std::make_pair(*j, InternalNodeId()));
         }
-        ++num_new_edges;
       }
+      num_new_edges += getNumEdgesStorageElements(i);
     }
   }
 
@@ -200,11 +226,7 @@ SemistaticGraph<NodeId, Node>::SemistaticGraph(const SemistaticGraph& x, NodeIte
     if (i->isTerminal()) {
       nodeData.edges_begin = 0;
     } else {
-      nodeData.edges_begin = reinterpret_cast<std::uintptr_t>(edges_storage.data() + edges_storage.size());
-      for (auto j = i->getEdgesBegin(); j != i->getEdgesEnd(); ++j) {
-        InternalNodeId otherNodeId = node_index_map.at(*j);
-        edges_storage.push_back(otherNodeId);
-      }
+      nodeData.edges_begin = addEdges(i);
     }
   }
 
@@ -213,6 +235,33 @@ SemistaticGraph<NodeId, Node>::SemistaticGraph(const SemistaticGraph& x, NodeIte
 #endif
 }
 
+template <typename NodeId, typename Node>
+template <typename F>
+void SemistaticGraph<NodeId, Node>::forEachNode(F f) {
+  node_index_map.forEach([this, &f](NodeId node_id, InternalNodeId internal_node_id) {
+    NodeData* p = nodeAtId(internal_node_id);
+    if (p->edges_begin != 1) {
+      f(node_id, node_iterator{p});
+    }
+  });
+}
+
+template <typename NodeId, typename Node>
+void SemistaticGraph<NodeId, Node>::compact(const NodeId* first, const NodeId* last, MemoryPool& memory_pool) {
+  using kept_nodes_elem_t = std::pair<NodeId, InternalNodeId>;
+  using kept_nodes_t = std::vector<kept_nodes_elem_t, ArenaAllocator<kept_nodes_elem_t>>;
+  kept_nodes_t kept_nodes = kept_nodes_t(ArenaAllocator<kept_nodes_elem_t>(memory_pool));
+  for (const NodeId* i = first; i != last; ++i) {
+    kept_nodes.push_back(std::make_pair(*i, node_index_map.at(*i)));
+  }
+  std::sort(kept_nodes.begin(), kept_nodes.end());
+  kept_nodes.erase(std::unique(kept_nodes.begin(), kept_nodes.end()), kept_nodes.end());
+
+  node_index_map = SemistaticMap<NodeId, InternalNodeId>(kept_nodes.begin(), kept_nodes.end(), kept_nodes.size(),
+                                                         memory_pool);
+  edges_storage = FixedSizeVector<InternalNodeId>();
+}
+
 #if FRUIT_EXTRA_DEBUG
 template <typename NodeId, typename Node>
 void SemistaticGraph<NodeId, Node>::checkFullyConstructed() {
@@ -32,6 +32,12 @@ inline typename SemistaticMap<Key, Value>::Unsigned SemistaticMap<Key, Value>::H
 
 template <typename Key, typename Value>
 inline typename SemistaticMap<Key, Value>::Unsigned SemistaticMap<Key, Value>::hash(const Key& key) const {
+  return hash(hash_function, key);
+}
+
+template <typename Key, typename Value>
+inline typename SemistaticMap<Key, Value>::Unsigned SemistaticMap<Key, Value>::hash(const HashFunction& hash_function,
+                                                                                    const Key& key) {
   return hash_function.hash(std::hash<typename std::remove_cv<Key>::type>()(key));
 }
 
@@ -34,8 +34,9 @@ namespace impl {
  * - Key must be default constructible and trivially copyable
  * - Value must be default constructible and trivially copyable
  *
- * Also, while insertion of elements after construction is supported, inserting more than O(1) elements
- * after construction will raise the cost of any further lookups to more than O(1).
+ * Elements can also be added after construction (by constructing an extended copy of a map); lookups stay O(1) no
+ * matter how many elements are added, since the ones that don't fit in the existing buckets are stored in a second
+ * level with its own hash function.
  */
 template <typename Key, typename Value>
 class SemistaticMap {
@@ -75,8 +76,30 @@ private:
   FixedSizeVector<CandidateValuesRange> lookup_table;
   FixedSizeVector<value_type> values;
 
+  // The elements added after construction that would have made a bucket of lookup_table longer than beta. These are
+  // stored in a separate level with its own hash function (and with less than beta elements in each bucket, like the
+  // buckets of lookup_table at construction), so that a lookup looks at O(beta) candidates no matter how many elements
+  // were added. Empty if there are no such elements.
+  HashFunction overflow_hash_function;
+  FixedSizeVector<CandidateValuesRange> overflow_lookup_table;
+  FixedSizeVector<value_type> overflow_values;
+
   Unsigned hash(const Key& key) const;
 
+  static Unsigned hash(const HashFunction& hash_function, const Key& key);
+
+  // Picks a hash function for the `num_values' elements in [values_begin, values_end) such that each bucket has less
+  // than beta elements, and stores the elements grouped by bucket in `values'.
+  template <typename Iter>
+  static void buildLevel(Iter values_begin, Iter values_end, std::size_t num_values, MemoryPool& memory_pool,
+                         HashFunction& hash_function, FixedSizeVector<CandidateValuesRange>& lookup_table,
+                         FixedSizeVector<value_type>& values);
+
+  // Returns the element with the specified key if it's in the level with the specified hash function and lookup table,
+  // otherwise nullptr.
+  static const value_type* findInLevel(const HashFunction& hash_function,
+                                       const FixedSizeVector<CandidateValuesRange>& lookup_table, Key key);
+
   // Inserts a range [elems_begin, elems_end) of new (key,value) pairs with hash h. The keys must not exist in the map.
   // Before calling this, ensure that the capacity of `values' is sufficient to contain the new values without
   // re-allocating.
@@ -97,8 +120,9 @@ public:
   // Creates a shallow copy of `map' with the additional elements in new_elements.
   // The keys in new_elements must be unique and must not be present in `map'.
   // The new map will share data with `map', so must be destroyed before `map' is destroyed.
-  // NOTE: If more than O(1) elements are added, calls to at() and find() on the result will *not* be O(1).
-  // This is O(new_elements.size()*log(new_elements.size())).
+  // The new elements that don't fit in the buckets of `map' (and the ones in the second level of `map', if any) are
+  // stored in a second level.
+  // This is O(new_elements.size()*log(new_elements.size()) + (number of elements in the second level)).
   SemistaticMap(const SemistaticMap<Key, Value>& map,
                 std::vector<value_type, ArenaAllocator<value_type>>&& new_elements);
 
@@ -117,6 +141,11 @@ public:
   // Prefer using at() when possible, this is slightly slower.
   // Returns nullptr if the key was not found.
   const Value* find(Key key) const;
+
+  // Calls f(key, value) for each element of the map, in an unspecified order.
+  // This is O(size()) but also visits all buckets, so it's meant for diagnostics, not for lookups.
+  template <typename F>
+  void forEach(F f) const;
 };
 
 } // namespace impl
@@ -42,6 +42,15 @@ template <typename Key, typename Value>
 template <typename Iter>
 SemistaticMap<Key, Value>::SemistaticMap(
     Iter values_begin, Iter values_end, std::size_t num_values, MemoryPool& memory_pool) {
+  buildLevel(values_begin, values_end, num_values, memory_pool, hash_function, lookup_table, values);
+}
+
+template <typename Key, typename Value>
+template <typename Iter>
+void SemistaticMap<Key, Value>::buildLevel(Iter values_begin, Iter values_end, std::size_t num_values,
+                                           MemoryPool& memory_pool, HashFunction& hash_function,
+                                           FixedSizeVector<CandidateValuesRange>& lookup_table,
+                                           FixedSizeVector<value_type>& values) {
   NumBits num_bits = pickNumBits(num_values);
   std::size_t num_buckets = size_t(1) << num_bits;
 
@@ -59,7 +68,7 @@ SemistaticMap<Key, Value>::SemistaticMap(
     hash_function.a = random_distribution(random_generator);
 
     for (Iter itr = values_begin; !(itr == values_end); ++itr) {
-      Unsigned& this_count = count[hash((*itr).first)];
+      Unsigned& this_count = count[hash(hash_function, (*itr).first)];
       ++this_count;
       if (this_count == beta) {
         goto pick_another;
@@ -84,7 +93,7 @@ SemistaticMap<Key, Value>::SemistaticMap(
 
   Iter itr = values_begin;
   for (std::size_t i = 0; i < num_values; ++i, ++itr) {
-    value_type*& first_value_ptr = lookup_table[hash((*itr).first)].begin;
+    value_type*& first_value_ptr = lookup_table[hash(hash_function, (*itr).first)].begin;
     --first_value_ptr;
     FruitAssert(values.data() <= first_value_ptr);
     FruitAssert(first_value_ptr < values.data() + values.size());
@@ -101,35 +110,59 @@ SemistaticMap<Key, Value>::SemistaticMap(const SemistaticMap<Key, Value>& map,
   std::sort(new_elements.begin(), new_elements.end(),
             [this](const value_type& x, const value_type& y) { return hash(x.first) < hash(y.first); });
 
-  std::size_t num_additional_values = new_elements.size();
-  // Add the space needed to store copies of the old buckets.
-  for (auto itr = new_elements.begin(), itr_end = new_elements.end(); itr != itr_end; /* no increment */) {
-    Unsigned h = hash(itr->first);
-    auto p = map.lookup_table[h];
-    num_additional_values += (p.end - p.begin);
-    for (; itr != itr_end && hash(itr->first) == h; ++itr) {
+  // The second level is always rebuilt from scratch, so it also contains the elements of the second level of `map'.
+  std::vector<value_type, ArenaAllocator<value_type>> overflow_elements(map.overflow_values.begin(),
+                                                                       map.overflow_values.end(),
+                                                                       new_elements.get_allocator());
+
+  // Returns true if the new elements [first, last) (that all have hash h) fit in the bucket h, i.e. if that bucket
+  // would have at most beta elements after inserting them.
+  auto fitsInBucket = [&map](Unsigned h, const value_type* first, const value_type* last) {
+    return std::size_t(map.lookup_table[h].end - map.lookup_table[h].begin) + (last - first) <= beta;
+  };
+
+  std::size_t num_additional_values = 0;
+  if (!new_elements.empty()) {
+    // The check is to workaround a bug in the STL shipped with GCC <4.8.2, where calling data() on an
+    // empty vector causes undefined behavior (https://gcc.gnu.org/bugzilla/show_bug.cgi?id=59829).
+    for (const value_type *itr = new_elements.data(), *itr_end = new_elements.data() + new_elements.size();
+         itr != itr_end;
+         /* no increment */) {
+      Unsigned h = hash(itr->first);
+      const value_type* first = itr;
+      for (; itr != itr_end && hash(itr->first) == h; ++itr) {
+      }
+      if (fitsInBucket(h, first, itr)) {
+        // Add the space needed to store copies of the old bucket too.
+        num_additional_values += (map.lookup_table[h].end - map.lookup_table[h].begin) + (itr - first);
+      } else {
+        overflow_elements.insert(overflow_elements.end(), first, itr);
+      }
     }
   }
 
   values = FixedSizeVector<value_type>(num_additional_values);
 
   // Now actually perform the insertions.
-
-  if (new_elements.empty()) {
-    // This is to workaround a bug in the STL shipped with GCC <4.8.2, where calling data() on an
-    // empty vector causes undefined behavior (https://gcc.gnu.org/bugzilla/show_bug.cgi?id=59829).
-    return;
-  }
-  for (value_type *itr = new_elements.data(), *itr_end = new_elements.data() + new_elements.size(); itr != itr_end;
-       /* no increment */) {
-    Unsigned h = hash(itr->first);
-    auto p = map.lookup_table[h];
-    num_additional_values += (p.end - p.begin);
-    value_type* first = itr;
-    for (; itr != itr_end && hash(itr->first) == h; ++itr) {
+  if (!new_elements.empty()) {
+    for (const value_type *itr = new_elements.data(), *itr_end = new_elements.data() + new_elements.size();
+         itr != itr_end;
+         /* no increment */) {
+      Unsigned h = hash(itr->first);
+      const value_type* first = itr;
+      for (; itr != itr_end && hash(itr->first) == h; ++itr) {
+      }
+      if (fitsInBucket(h, first, itr)) {
+        insert(h, first, itr);
+      }
     }
-    value_type* last = itr;
-    insert(h, first, last);
+  }
+
+  if (!overflow_elements.empty()) {
+    // This is only used for temporary data, so it's fine to use a separate pool.
+    MemoryPool memory_pool;
+    buildLevel(overflow_elements.begin(), overflow_elements.end(), overflow_elements.size(), memory_pool,
+               overflow_hash_function, overflow_lookup_table, overflow_values);
   }
 }
 
@@ -157,8 +190,26 @@ void SemistaticMap<Key, Value>::insert(std::size_t h, const value_type* elems_be
   // too slow.
 }
 
+template <typename Key, typename Value>
+inline const typename SemistaticMap<Key, Value>::value_type*
+SemistaticMap<Key, Value>::findInLevel(const HashFunction& hash_function,
+                                       const FixedSizeVector<CandidateValuesRange>& lookup_table, Key key) {
+  Unsigned h = hash(hash_function, key);
+  for (const value_type *p = lookup_table[h].begin, *p_end = lookup_table[h].end; p != p_end; ++p) {
+    if (p->first == key) {
+      return p;
+    }
+  }
+  return nullptr;
+}
+
 template <typename Key, typename Value>
 const Value& SemistaticMap<Key, Value>::at(Key key) const {
+  if (overflow_lookup_table.size() != 0) {
+    const Value* value = find(key);
+    FruitAssert(value != nullptr);
+    return *value;
+  }
   Unsigned h = hash(key);
   for (const value_type* p = lookup_table[h].begin; /* p!=lookup_table[h].end but no need to check */; ++p) {
     FruitAssert(p != lookup_table[h].end);
@@ -170,13 +221,26 @@ const Value& SemistaticMap<Key, Value>::at(Key key) const {
 
 template <typename Key, typename Value>
 const Value* SemistaticMap<Key, Value>::find(Key key) const {
-  Unsigned h = hash(key);
-  for (const value_type *p = lookup_table[h].begin, *p_end = lookup_table[h].end; p != p_end; ++p) {
-    if (p->first == key) {
-      return &(p->second);
+  const value_type* elem = findInLevel(hash_function, lookup_table, key);
+  if (elem == nullptr && overflow_lookup_table.size() != 0) {
+    elem = findInLevel(overflow_hash_function, overflow_lookup_table, key);
+  }
+  return elem == nullptr ? nullptr : &(elem->second);
+}
+
+template <typename Key, typename Value>
+template <typename F>
+void SemistaticMap<Key, Value>::forEach(F f) const {
+  // Each key is in exactly one bucket (the values that are no longer pointed to by the lookup table after an insert()
+  // are not visited).
+  for (const CandidateValuesRange& range : lookup_table) {
+    for (const value_type* p = range.begin; p != range.end; ++p) {
+      f(p->first, p->second);
     }
   }
-  return nullptr;
+  for (const value_type& elem : overflow_values) {
+    f(elem.first, elem.second);
+  }
 }
 
 template <typename Key, typename Value>
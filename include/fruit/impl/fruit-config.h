@@ -77,6 +77,13 @@
 #define FRUIT_DEPRECATED_DEFINITION(...) __VA_ARGS__
 #endif
 
+#if FRUIT_HAS_TYPEID && !FRUIT_HAS_CONSTEXPR_TYPEID
+// getTypeId() needs a function-local static in this case, so it can't be constexpr.
+#define FRUIT_TYPE_ID_CONSTEXPR
+#else
+#define FRUIT_TYPE_ID_CONSTEXPR constexpr
+#endif
+
 #if FRUIT_HAS_MSVC_ASSUME
 #define FRUIT_UNREACHABLE                                                                                              \
   FruitAssert(false);                                                                                                  \
@@ -39,6 +39,18 @@ class ComponentInterfaceImpl;
 template <typename Component, typename... Args>
 class LazyComponentImpl;
 
+template <typename AnnotatedSignature, typename Lambda>
+struct ThreadLocalProviderHelper;
+
+template <typename Lambda>
+struct ThreadLocalProviderForLambdaHelper;
+
+template <typename AnnotatedSignature, typename Lambda>
+struct PerCpuProviderHelper;
+
+template <typename Lambda>
+struct PerCpuProviderForLambdaHelper;
+
 namespace meta {
 template <typename... PreviousBindings>
 struct OpForComponent;
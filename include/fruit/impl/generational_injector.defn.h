@@ -0,0 +1,79 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_GENERATIONAL_INJECTOR_DEFN_H
+#define FRUIT_GENERATIONAL_INJECTOR_DEFN_H
+
+// Redundant, but makes KDevelop happy.
+#include <fruit/generational_injector.h>
+
+#include <atomic>
+#include <utility>
+
+namespace fruit {
+
+template <typename... P>
+template <typename... FormalArgs, typename... Args>
+inline GenerationalInjector<P...>::GenerationalInjector(Component<P...> (*getComponent)(FormalArgs...),
+                                                        Args&&... args) {
+  publish(std::shared_ptr<Injector<P...>>(new Injector<P...>(getComponent, std::forward<Args>(args)...)));
+}
+
+template <typename... P>
+template <typename... NormalizedComponentParams, typename... ComponentParams, typename... FormalArgs,
+          typename... Args>
+inline GenerationalInjector<P...>::GenerationalInjector(
+    const NormalizedComponent<NormalizedComponentParams...>& normalized_component,
+    Component<ComponentParams...> (*getComponent)(FormalArgs...), Args&&... args) {
+  publish(std::shared_ptr<Injector<P...>>(
+      new Injector<P...>(normalized_component, getComponent, std::forward<Args>(args)...)));
+}
+
+template <typename... P>
+inline std::shared_ptr<Injector<P...>> GenerationalInjector<P...>::current() const {
+  return std::atomic_load(&current_injector);
+}
+
+template <typename... P>
+template <typename... FormalArgs, typename... Args>
+inline void GenerationalInjector<P...>::reload(Component<P...> (*getComponent)(FormalArgs...), Args&&... args) {
+  publish(std::shared_ptr<Injector<P...>>(new Injector<P...>(getComponent, std::forward<Args>(args)...)));
+}
+
+template <typename... P>
+template <typename... NormalizedComponentParams, typename... ComponentParams, typename... FormalArgs,
+          typename... Args>
+inline void
+GenerationalInjector<P...>::reload(const NormalizedComponent<NormalizedComponentParams...>& normalized_component,
+                                   Component<ComponentParams...> (*getComponent)(FormalArgs...), Args&&... args) {
+  publish(std::shared_ptr<Injector<P...>>(
+      new Injector<P...>(normalized_component, getComponent, std::forward<Args>(args)...)));
+}
+
+template <typename... P>
+inline void GenerationalInjector<P...>::publish(std::shared_ptr<Injector<P...>> next) {
+  std::lock_guard<std::mutex> lock(reload_mutex);
+  next->storage->enableGenerationTracking();
+  std::shared_ptr<Injector<P...>> previous = std::atomic_load(&current_injector);
+  if (previous != nullptr) {
+    next->storage->reuseObjectsFrom(*previous->storage);
+  }
+  std::atomic_store(&current_injector, std::move(next));
+}
+
+} // namespace fruit
+
+#endif // FRUIT_GENERATIONAL_INJECTOR_DEFN_H
@@ -190,6 +190,29 @@ struct TypesInInjectorProvidedAsConstOnlyError {
       "[Normalized]Component<T>).");
 };
 
+template <typename... TypesNotProvided>
+struct TypesInNormalizedComponentSliceNotProvidedError {
+  static_assert(AlwaysFalse<TypesNotProvided...>::value,
+                "The types in TypesNotProvided are declared as provided by the sliced NormalizedComponent, but the "
+                "NormalizedComponent that it's sliced from doesn't provide them.");
+};
+
+template <typename... TypesProvidedAsConstOnly>
+struct TypesInNormalizedComponentSliceProvidedAsConstOnlyError {
+  static_assert(
+      AlwaysFalse<TypesProvidedAsConstOnly...>::value,
+      "The types in TypesProvidedAsConstOnly are declared as non-const provided types by the sliced "
+      "NormalizedComponent, but the NormalizedComponent that it's sliced from provides them as const only. You should "
+      "mark them as const in the slice (e.g., switching from NormalizedComponent<T> to NormalizedComponent<const T>).");
+};
+
+template <typename... MissingRequirements>
+struct NormalizedComponentSliceWithMissingRequirementsError {
+  static_assert(AlwaysFalse<MissingRequirements...>::value,
+                "The types in MissingRequirements are required by the NormalizedComponent that the slice is created "
+                "from, so the sliced NormalizedComponent must also declare them as required (with Required<...>).");
+};
+
 template <typename T>
 struct TypeNotProvidedError {
   static_assert(AlwaysFalse<T>::value,
@@ -384,6 +407,13 @@ struct IncorrectArgTypePassedToInstallComponentFuntionsError {
         "argument with type Arg was passed instead.");
 };
 
+template <typename T>
+struct PerCpuProviderReturningPointerError {
+  static_assert(AlwaysFalse<T>::value,
+                "registerPerCpuProvider() was called with a lambda that returns a pointer to T, but the per-CPU "
+                "instances are stored inline in cache-line-aligned slots, so the lambda must return a T by value.");
+};
+
 struct LambdaWithCapturesErrorTag {
   template <typename Lambda>
   using apply = LambdaWithCapturesError<Lambda>;
@@ -484,6 +514,21 @@ struct TypesInInjectorProvidedAsConstOnlyErrorTag {
   using apply = TypesInInjectorProvidedAsConstOnlyError<TypesProvidedAsConstOnly...>;
 };
 
+struct TypesInNormalizedComponentSliceNotProvidedErrorTag {
+  template <typename... TypesNotProvided>
+  using apply = TypesInNormalizedComponentSliceNotProvidedError<TypesNotProvided...>;
+};
+
+struct TypesInNormalizedComponentSliceProvidedAsConstOnlyErrorTag {
+  template <typename... TypesProvidedAsConstOnly>
+  using apply = TypesInNormalizedComponentSliceProvidedAsConstOnlyError<TypesProvidedAsConstOnly...>;
+};
+
+struct NormalizedComponentSliceWithMissingRequirementsErrorTag {
+  template <typename... MissingRequirements>
+  using apply = NormalizedComponentSliceWithMissingRequirementsError<MissingRequirements...>;
+};
+
 struct FunctorUsedAsProviderErrorTag {
   template <typename ProviderType>
   using apply = FunctorUsedAsProviderError<ProviderType>;
@@ -599,6 +644,11 @@ struct IncorrectArgTypePassedToInstallComponentFuntionsErrorTag {
   using apply = IncorrectArgTypePassedToInstallComponentFuntionsError<Arg>;
 };
 
+struct PerCpuProviderReturningPointerErrorTag {
+  template <typename T>
+  using apply = PerCpuProviderReturningPointerError<T>;
+};
+
 } // namespace impl
 } // namespace fruit
 
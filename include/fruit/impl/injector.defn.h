@@ -26,7 +26,19 @@ namespace fruit {
 
 template <typename... P>
 template <typename... FormalArgs, typename... Args>
-inline Injector<P...>::Injector(Component<P...> (*getComponent)(FormalArgs...), Args&&... args) {
+inline Injector<P...>::Injector(Component<P...> (*getComponent)(FormalArgs...), Args&&... args)
+    : Injector(fruit::impl::InjectorStorage::ThreadingPolicy::THREAD_SAFE, getComponent, std::forward<Args>(args)...) {}
+
+template <typename... P>
+template <typename... FormalArgs, typename... Args>
+inline Injector<P...>::Injector(SingleThreaded, Component<P...> (*getComponent)(FormalArgs...), Args&&... args)
+    : Injector(fruit::impl::InjectorStorage::ThreadingPolicy::SINGLE_THREADED, getComponent,
+               std::forward<Args>(args)...) {}
+
+template <typename... P>
+template <typename... FormalArgs, typename... Args>
+inline Injector<P...>::Injector(fruit::impl::InjectorStorage::ThreadingPolicy threading_policy,
+                                Component<P...> (*getComponent)(FormalArgs...), Args&&... args) {
   Component<P...> component = fruit::createComponent().install(getComponent, std::forward<Args>(args)...);
 
   fruit::impl::MemoryPool memory_pool;
@@ -35,7 +47,7 @@ inline Injector<P...>::Injector(Component<P...> (*getComponent)(FormalArgs...),
       exposed_types_t(std::initializer_list<fruit::impl::TypeId>{fruit::impl::getTypeId<P>()...},
                       fruit::impl::ArenaAllocator<fruit::impl::TypeId>(memory_pool));
   storage = std::unique_ptr<fruit::impl::InjectorStorage>(
-      new fruit::impl::InjectorStorage(std::move(component.storage), exposed_types, memory_pool));
+      new fruit::impl::InjectorStorage(std::move(component.storage), exposed_types, memory_pool, threading_policy));
 }
 
 namespace impl {
@@ -45,6 +57,8 @@ template <typename... P>
 struct InjectorImplHelper {
 
   // This performs all checks needed in the constructor of Injector that takes NormalizedComponent.
+  // The conditions only use cheap predicates (IsEmptySet, IsContained); the sets listed in the error messages are only
+  // computed in the branch of the check that fails.
   template <typename NormalizedComp, typename Comp>
   struct CheckConstructionFromNormalizedComponent {
     using Op = InstallComponent(Comp, NormalizedComp);
@@ -59,7 +73,7 @@ struct InjectorImplHelper {
         Not(IsEmptySet(GetComponentRsSuperset(Comp))),
         ConstructErrorWithArgVector(ComponentWithRequirementsInInjectorErrorTag,
                                     SetToVector(GetComponentRsSuperset(Comp))),
-        If(Not(IsEmptySet(MergedCompRs)),
+        If(Not(IsContained(GetComponentRsSuperset(MergedComp), GetComponentPs(MergedComp))),
            ConstructErrorWithArgVector(UnsatisfiedRequirementsInNormalizedComponentErrorTag, SetToVector(MergedCompRs)),
            If(Not(IsContained(VectorToSetUnchecked(RemoveConstFromTypes(Vector<Type<P>...>)),
                               GetComponentPs(MergedComp))),
@@ -92,12 +106,44 @@ struct InjectorImplHelper {
 template <typename... P>
 template <typename... NormalizedComponentParams, typename... ComponentParams, typename... FormalArgs, typename... Args>
 inline Injector<P...>::Injector(const NormalizedComponent<NormalizedComponentParams...>& normalized_component,
+                                Component<ComponentParams...> (*getComponent)(FormalArgs...), Args&&... args)
+    : Injector(fruit::impl::InjectorStorage::ThreadingPolicy::THREAD_SAFE, InjectorBuffer{nullptr, 0},
+               normalized_component, getComponent, std::forward<Args>(args)...) {}
+
+template <typename... P>
+template <typename... NormalizedComponentParams, typename... ComponentParams, typename... FormalArgs, typename... Args>
+inline Injector<P...>::Injector(SingleThreaded,
+                                const NormalizedComponent<NormalizedComponentParams...>& normalized_component,
+                                Component<ComponentParams...> (*getComponent)(FormalArgs...), Args&&... args)
+    : Injector(fruit::impl::InjectorStorage::ThreadingPolicy::SINGLE_THREADED, InjectorBuffer{nullptr, 0},
+               normalized_component, getComponent, std::forward<Args>(args)...) {}
+
+template <typename... P>
+template <typename... NormalizedComponentParams, typename... ComponentParams, typename... FormalArgs, typename... Args>
+inline Injector<P...>::Injector(InjectorBuffer buffer,
+                                const NormalizedComponent<NormalizedComponentParams...>& normalized_component,
+                                Component<ComponentParams...> (*getComponent)(FormalArgs...), Args&&... args)
+    : Injector(fruit::impl::InjectorStorage::ThreadingPolicy::THREAD_SAFE, buffer, normalized_component, getComponent,
+               std::forward<Args>(args)...) {}
+
+template <typename... P>
+template <typename... NormalizedComponentParams, typename... ComponentParams, typename... FormalArgs, typename... Args>
+inline Injector<P...>::Injector(SingleThreaded, InjectorBuffer buffer,
+                                const NormalizedComponent<NormalizedComponentParams...>& normalized_component,
+                                Component<ComponentParams...> (*getComponent)(FormalArgs...), Args&&... args)
+    : Injector(fruit::impl::InjectorStorage::ThreadingPolicy::SINGLE_THREADED, buffer, normalized_component,
+               getComponent, std::forward<Args>(args)...) {}
+
+template <typename... P>
+template <typename... NormalizedComponentParams, typename... ComponentParams, typename... FormalArgs, typename... Args>
+inline Injector<P...>::Injector(fruit::impl::InjectorStorage::ThreadingPolicy threading_policy, InjectorBuffer buffer,
+                                const NormalizedComponent<NormalizedComponentParams...>& normalized_component,
                                 Component<ComponentParams...> (*getComponent)(FormalArgs...), Args&&... args) {
   Component<ComponentParams...> component = fruit::createComponent().install(getComponent, std::forward<Args>(args)...);
 
   fruit::impl::MemoryPool memory_pool;
   storage = std::unique_ptr<fruit::impl::InjectorStorage>(new fruit::impl::InjectorStorage(
-      *(normalized_component.storage.storage), std::move(component.storage), memory_pool));
+      *(normalized_component.storage.storage), std::move(component.storage), memory_pool, threading_policy, buffer));
 
   using NormalizedComp =
       fruit::impl::meta::ConstructComponentImpl(fruit::impl::meta::Type<NormalizedComponentParams>...);
@@ -148,6 +194,59 @@ FRUIT_DEPRECATED_DEFINITION(inline void Injector<P...>::eagerlyInjectAll()) {
   storage->eagerlyInjectMultibindings();
 }
 
+template <typename... P>
+template <typename Rep, typename Period>
+inline EagerInjectionProgress Injector<P...>::eagerlyInjectSome(std::chrono::duration<Rep, Period> time_budget) {
+  using Clock = std::chrono::steady_clock;
+  // The last element is not an exposed type, it's there to avoid a zero-length array when P is empty.
+  static const fruit::impl::TypeId exposed_types[] = {
+      fruit::impl::getTypeId<fruit::impl::InjectorStorage::NormalizeType<P>>()..., fruit::impl::TypeId{nullptr}};
+  return storage->eagerlyInjectSome(exposed_types, sizeof...(P),
+                                    Clock::now() + std::chrono::duration_cast<Clock::duration>(time_budget));
+}
+
+template <typename... P>
+template <typename AnnotatedC>
+inline void Injector<P...>::eagerlyInjectType(fruit::impl::InjectorStorage& storage) {
+  storage.template get<fruit::impl::meta::UnwrapType<
+      fruit::impl::meta::Eval<fruit::impl::meta::AddPointerInAnnotatedType(fruit::impl::meta::Type<AnnotatedC>)>>>();
+}
+
+template <typename... P>
+inline void Injector<P...>::enableConcurrentDestruction(std::size_t num_threads) {
+  storage->enableConcurrentDestruction(num_threads);
+}
+
+template <typename... P>
+inline void Injector<P...>::enableAllocationTracking(std::size_t (*get_allocated_bytes)()) {
+  storage->enableAllocationTracking(get_allocated_bytes);
+}
+
+template <typename... P>
+inline std::vector<TypeAllocationStats> Injector<P...>::getTopAllocatingTypes(std::size_t max_num_types) {
+  return storage->getTopAllocatingTypes(max_num_types);
+}
+
+template <typename... P>
+inline void Injector<P...>::enableStatsExport(const std::string& segment_name) {
+  storage->enableStatsExport(segment_name);
+}
+
+template <typename... P>
+inline std::size_t Injector<P...>::getRequiredBufferSize() {
+  return storage->getRequiredBufferSize();
+}
+
+template <typename... P>
+inline void Injector<P...>::compact() {
+  // The last elements are not types, they're there to avoid zero-length arrays when P is empty.
+  static void (*const type_steps[])(fruit::impl::InjectorStorage&) = {&Injector::template eagerlyInjectType<P>...,
+                                                                      nullptr};
+  static const fruit::impl::TypeId exposed_types[] = {
+      fruit::impl::getTypeId<fruit::impl::InjectorStorage::NormalizeType<P>>()..., fruit::impl::TypeId{nullptr}};
+  storage->compact(type_steps, exposed_types, sizeof...(P));
+}
+
 } // namespace fruit
 
 #endif // FRUIT_INJECTOR_DEFN_H
@@ -0,0 +1,85 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_ALLOCATION_TRACKER_H
+#define FRUIT_ALLOCATION_TRACKER_H
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+namespace fruit {
+namespace impl {
+
+/**
+ * Attributes the heap memory allocated while constructing each binding/multibinding to that binding/multibinding.
+ *
+ * The memory is measured with a user-provided function that returns the number of bytes allocated so far (e.g. by the
+ * current thread) and that is typically backed by a malloc hook or by the statistics of the memory allocator. The
+ * memory allocated while constructing a dependency of an object (including through a Provider) is only attributed to
+ * the dependency, not to the object.
+ */
+class AllocationTracker {
+public:
+  using get_allocated_bytes_t = std::size_t (*)();
+
+  // `get_allocated_bytes' must return the total number of bytes allocated so far. The result must never decrease.
+  explicit AllocationTracker(get_allocated_bytes_t get_allocated_bytes);
+
+  // Must be called before constructing a binding/multibinding, with a matching call to endConstruction() (or
+  // abortConstruction()) afterwards.
+  void beginConstruction();
+
+  // `key' identifies the binding/multibinding that was just constructed.
+  void endConstruction(const void* key);
+
+  // Called instead of endConstruction() if the construction failed (e.g. the provider threw). The memory allocated
+  // since the matching beginConstruction() is not attributed to anything.
+  void abortConstruction();
+
+  // The memory allocated between these two calls is not attributed to the construction in progress (if any). Used
+  // around the bookkeeping of the other instrumentation of the injector.
+  void pauseCounting();
+  void resumeCounting();
+
+  // The number of bytes attributed to each binding/multibinding constructed so far.
+  const std::unordered_map<const void*, std::size_t>& getAllocatedBytesByKey() const;
+
+private:
+  struct Frame {
+    // The result of get_allocated_bytes() when the construction started.
+    std::size_t allocated_bytes_at_begin;
+
+    // The bytes allocated since the construction started that must not be attributed to this construction (because
+    // they were allocated by nested constructions or by this class).
+    std::size_t excluded_bytes;
+  };
+
+  get_allocated_bytes_t get_allocated_bytes;
+
+  // One element for each construction in progress.
+  std::vector<Frame> construction_stack;
+
+  std::unordered_map<const void*, std::size_t> allocated_bytes_by_key;
+
+  // The result of get_allocated_bytes() at the last pauseCounting() call.
+  std::size_t allocated_bytes_at_pause = 0;
+};
+
+} // namespace impl
+} // namespace fruit
+
+#endif // FRUIT_ALLOCATION_TRACKER_H
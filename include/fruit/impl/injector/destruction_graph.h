@@ -0,0 +1,97 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_DESTRUCTION_GRAPH_H
+#define FRUIT_DESTRUCTION_GRAPH_H
+
+#include <fruit/impl/data_structures/fixed_size_allocator.h>
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+namespace fruit {
+namespace impl {
+
+/**
+ * Records which injected objects were used to construct each injected object, so that the objects in a
+ * FixedSizeAllocator can be destroyed concurrently while still destroying each object before its dependencies.
+ *
+ * Each binding (or multibinding) that gets constructed becomes a node in this graph. A node owns the objects that were
+ * registered in the allocator by its own construction (usually 0 or 1) and has an edge to each node that was used
+ * while constructing it. Nodes that don't own any object are still kept, so that dependencies through them (e.g.
+ * through an interface binding) are preserved.
+ *
+ * Objects constructed by different top-level requests (i.e. different calls to Injector::get() or Provider::get()
+ * outside of any injection) are still destroyed in reverse order of construction, since objects constructed later
+ * might have been obtained through a Provider by an object constructed earlier.
+ */
+class DestructionGraph {
+public:
+  // `num_threads' is the maximum number of threads (including the calling one) used in destroyObjects().
+  explicit DestructionGraph(std::size_t num_threads);
+
+  // Must be called before constructing a binding/multibinding, with a matching call to endConstruction() (or
+  // abortConstruction()) afterwards.
+  void beginConstruction();
+
+  // `key' identifies the binding/multibinding that was just constructed, so that addDependency() can refer to it.
+  // `num_objects_to_destroy' is the allocator's numObjectsToDestroy() after the construction.
+  void endConstruction(const void* key, std::size_t num_objects_to_destroy);
+
+  // Called instead of endConstruction() if the construction failed (e.g. the provider threw). Discards the dependencies
+  // recorded since the matching beginConstruction().
+  void abortConstruction();
+
+  // Records that the (already constructed) binding/multibinding identified by `key' is used by the object currently
+  // being constructed (if any). Keys that were never passed to endConstruction() are ignored.
+  void addDependency(const void* key);
+
+  // Destroys all objects registered in `allocator', and then clears its destruction list.
+  void destroyObjects(FixedSizeAllocator& allocator);
+
+private:
+  static constexpr std::size_t no_node = static_cast<std::size_t>(-1);
+
+  struct Node {
+    // The objects owned by this node are the ones with index in [objects_begin, objects_end) in the allocator.
+    std::size_t objects_begin;
+    std::size_t objects_end;
+
+    // Indexes (in `nodes') of the nodes that must be destroyed after this one.
+    std::vector<std::size_t> dependencies;
+  };
+
+  std::size_t num_threads;
+
+  std::vector<Node> nodes;
+
+  std::unordered_map<const void*, std::size_t> node_index_by_key;
+
+  // One element for each construction in progress, with the dependencies collected so far.
+  std::vector<std::vector<std::size_t>> construction_stack;
+
+  // The objects with index lower than this are already owned by some node.
+  std::size_t num_claimed_objects = 0;
+
+  // The node constructed by the last top-level request, or no_node if there were no top-level requests yet.
+  std::size_t last_toplevel_node = no_node;
+};
+
+} // namespace impl
+} // namespace fruit
+
+#endif // FRUIT_DESTRUCTION_GRAPH_H
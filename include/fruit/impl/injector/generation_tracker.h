@@ -0,0 +1,133 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_GENERATION_TRACKER_H
+#define FRUIT_GENERATION_TRACKER_H
+
+#include <fruit/impl/component_storage/component_storage_entry.h>
+#include <fruit/impl/data_structures/fixed_size_allocator.h>
+
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace fruit {
+namespace impl {
+
+/**
+ * An object constructed by a generation and reused by later generations. Once an object is reused, it's no longer
+ * destroyed by the allocator of the generation that constructed it; instead, that generation and all the generations
+ * that reuse the object share the ownership of the corresponding ReusedObject, and the object is destroyed when the
+ * last of them is destroyed.
+ */
+struct ReusedObject {
+  // Keeps alive the memory block of the allocator that constructed the objects, if they're stored there. This is
+  // declared first so that it's released after the objects are destroyed.
+  std::shared_ptr<char> storage;
+
+  // The ReusedObjects used to construct this one. These are released after destroying this object, so objects are
+  // still destroyed before their dependencies.
+  std::vector<std::shared_ptr<ReusedObject>> dependencies;
+
+  // The objects to destroy (usually 0 or 1), in the order in which they were registered in the allocator.
+  std::vector<std::pair<FixedSizeAllocator::destroy_t, void*>> objects_to_destroy;
+
+  ReusedObject() = default;
+  ReusedObject(const ReusedObject&) = delete;
+  ReusedObject& operator=(const ReusedObject&) = delete;
+
+  // Destroys the objects in objects_to_destroy, in reverse order.
+  ~ReusedObject();
+};
+
+/**
+ * Records how each object of an injector (one generation of a GenerationalInjector) was constructed, so that the next
+ * generation can tell which objects it can reuse instead of constructing them again.
+ *
+ * For each constructed binding this stores the function that constructed it and the bindings it was constructed from.
+ * Objects that obtained a Provider during their construction are never reused, since they might use it later to get
+ * objects from this generation.
+ */
+class GenerationTracker {
+public:
+  using create_t = ComponentStorageEntry::BindingForObjectToConstruct::create_t;
+
+  struct ConstructedBinding {
+    // The function that constructed the object.
+    create_t create;
+
+    // The keys of the bindings used to construct the object.
+    std::vector<const void*> deps;
+
+    // The objects that the construction registered in the allocator are the ones with index in
+    // [objects_begin, objects_end). This doesn't include the objects registered by the dependencies constructed in the
+    // meantime.
+    std::size_t objects_begin;
+    std::size_t objects_end;
+
+    // False if the object obtained a Provider while it was being constructed.
+    bool is_reusable;
+
+    // Set if the object was reused from a previous generation, or once it's reused by the next generation. From then
+    // on this owns the object, instead of the allocator.
+    std::shared_ptr<ReusedObject> reused_object;
+  };
+
+  // Must be called before constructing a binding/multibinding, with a matching call to endConstruction(),
+  // endMultibindingConstruction() or abortConstruction() afterwards.
+  void beginConstruction();
+
+  // Records that the (already constructed) binding identified by `key' is used by the object currently being
+  // constructed (if any).
+  void addDependency(const void* key);
+
+  // Records that the object currently being constructed (if any) obtained a Provider.
+  void markNotReusable();
+
+  // `key' identifies the binding that was just constructed using `create'.
+  // `num_objects_to_destroy' is the allocator's numObjectsToDestroy() after the construction.
+  void endConstruction(const void* key, create_t create, std::size_t num_objects_to_destroy);
+
+  // Multibindings are never reused, so this just discards what was recorded since the matching beginConstruction().
+  void endMultibindingConstruction(std::size_t num_objects_to_destroy);
+
+  // Called instead of endConstruction() if the construction failed (e.g. the provider threw). Discards what was
+  // recorded since the matching beginConstruction().
+  void abortConstruction();
+
+  // Records that the binding identified by `key' was not constructed, but reused from a previous generation.
+  void addReusedBinding(const void* key, ConstructedBinding binding);
+
+  // Returns nullptr if the binding identified by `key' was not constructed (or reused) by this injector.
+  ConstructedBinding* find(const void* key);
+  const ConstructedBinding* find(const void* key) const;
+
+private:
+  // One element for each construction in progress, with the dependencies collected so far.
+  std::vector<ConstructedBinding> construction_stack;
+
+  // The objects registered in the allocator with index lower than this are already owned by some binding.
+  std::size_t num_claimed_objects = 0;
+
+  std::unordered_map<const void*, ConstructedBinding> constructed_bindings;
+};
+
+} // namespace impl
+} // namespace fruit
+
+#endif // FRUIT_GENERATION_TRACKER_H
@@ -0,0 +1,106 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_INJECTOR_STATS_EXPORTER_H
+#define FRUIT_INJECTOR_STATS_EXPORTER_H
+
+#include <fruit/impl/injector/injector_stats_segment.h>
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace fruit {
+namespace impl {
+
+/**
+ * Publishes the stats of an injector in a shared memory segment with the layout described in InjectorStatsSegment, so
+ * that they can be read by another process without synchronizing with the injector.
+ *
+ * All methods must only be called while holding the injector's lock (or from the only thread that uses the injector),
+ * so each counter has a single writer and is updated with relaxed loads and stores instead of atomic read-modify-write
+ * operations.
+ */
+class InjectorStatsExporter {
+public:
+  struct BindingSlotInfo {
+    std::string type_name;
+    bool is_multibinding;
+  };
+
+  // Creates the shared memory segment `segment_name' with a slot for each element of `binding_slots'.
+  // `slot_index_by_key' maps the binding/multibinding keys passed to endConstruction() to indexes in `binding_slots'.
+  // Calls InjectorStorage::fatal() if the segment can't be created, including when a segment with that name already
+  // exists.
+  InjectorStatsExporter(const std::string& segment_name, const std::vector<BindingSlotInfo>& binding_slots,
+                        std::unordered_map<const void*, std::size_t> slot_index_by_key, std::size_t arena_used_bytes,
+                        std::size_t arena_capacity_bytes);
+
+  InjectorStatsExporter(const InjectorStatsExporter&) = delete;
+  InjectorStatsExporter& operator=(const InjectorStatsExporter&) = delete;
+
+  // Unmaps the segment and removes it (unless it was already removed and replaced by someone else); readers that
+  // already mapped it can keep reading it.
+  ~InjectorStatsExporter();
+
+  // Must be called before constructing a binding/multibinding, with a matching call to endConstruction() (or
+  // abortConstruction()) afterwards.
+  void beginConstruction();
+
+  // `key' identifies the binding/multibinding that was just constructed.
+  void endConstruction(const void* key, std::size_t arena_used_bytes);
+
+  // Called instead of endConstruction() if the construction failed (e.g. the provider threw). Nothing is recorded for
+  // it, but its time is still excluded from the enclosing construction (if any).
+  void abortConstruction();
+
+  // Records an acquisition of the injector's lock. Called after acquiring it.
+  void recordLockAcquisition();
+
+  // Records that an acquisition of the injector's lock had to wait for `wait_time' because another thread held it.
+  // Called after acquiring it.
+  void recordLockWait(std::chrono::steady_clock::duration wait_time);
+
+private:
+  struct Frame {
+    std::chrono::steady_clock::time_point begin;
+
+    // The time spent in nested constructions, that must not be attributed to this construction.
+    std::chrono::steady_clock::duration excluded_time;
+  };
+
+  std::string segment_name;
+  std::size_t segment_size;
+
+  // Identify the segment that we created, so that we don't remove a different one with the same name.
+  std::uint64_t segment_device = 0;
+  std::uint64_t segment_inode = 0;
+
+  InjectorStatsSegment::Header* header;
+  InjectorStatsSegment::BindingSlot* binding_slots;
+
+  std::unordered_map<const void*, std::size_t> slot_index_by_key;
+
+  // One element for each construction in progress.
+  std::vector<Frame> construction_stack;
+};
+
+} // namespace impl
+} // namespace fruit
+
+#endif // FRUIT_INJECTOR_STATS_EXPORTER_H
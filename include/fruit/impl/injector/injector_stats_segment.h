@@ -0,0 +1,103 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_INJECTOR_STATS_SEGMENT_H
+#define FRUIT_INJECTOR_STATS_SEGMENT_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace fruit {
+namespace impl {
+
+/**
+ * The layout of the shared memory segment written by Injector::enableStatsExport().
+ *
+ * The segment is a Header followed by Header::num_binding_slots BindingSlot objects. The layout only depends on this
+ * file (not on the types injected), so that it can be read by a separate process (e.g. extras/stats_reader) that
+ * doesn't link Fruit.
+ *
+ * All counters are only ever updated with relaxed atomic operations, so a reader might see a slightly inconsistent
+ * snapshot (e.g. a construction counted in the header but not yet in its binding slot). Readers must check that
+ * `magic' is InjectorStatsSegment::magic_value (loading it with acquire semantics) before reading anything else, and
+ * that `version' is a version they support.
+ */
+struct InjectorStatsSegment {
+  // "FRUITSTS" in ASCII.
+  static constexpr std::uint64_t magic_value = 0x5354535449555246ULL;
+
+  // Incremented on any change to the layout below.
+  static constexpr std::uint32_t current_version = 1;
+
+  static constexpr std::size_t type_name_size = 112;
+
+  struct Header {
+    // Stored (with release semantics) after all the other fields have been initialized.
+    std::atomic<std::uint64_t> magic;
+    std::uint32_t version;
+    std::uint32_t num_binding_slots;
+
+    // The process that exports the stats.
+    std::uint64_t pid;
+
+    // The number of objects constructed so far (for bindings and multibindings).
+    std::atomic<std::uint64_t> num_constructions;
+
+    // The number of times the injector's lock was acquired, and how many of those had to wait for another thread.
+    std::atomic<std::uint64_t> num_lock_acquisitions;
+    std::atomic<std::uint64_t> num_lock_waits;
+    std::atomic<std::uint64_t> lock_wait_nanos;
+
+    // How much of the memory block that stores the injected objects is used, and its size.
+    std::atomic<std::uint64_t> arena_used_bytes;
+    std::atomic<std::uint64_t> arena_capacity_bytes;
+  };
+
+  struct BindingSlot {
+    std::atomic<std::uint64_t> num_constructions;
+
+    // The time spent constructing the objects of this binding, excluding the time spent constructing their
+    // dependencies.
+    std::atomic<std::uint64_t> construction_nanos;
+
+    // 1 if this slot counts all the multibindings for a type, 0 if it counts the (non-multi)binding for a type.
+    std::uint8_t is_multibinding;
+
+    // The name of the bound type, NUL-terminated (and possibly truncated).
+    char type_name[type_name_size - 1];
+  };
+
+  static std::size_t getSegmentSize(std::size_t num_binding_slots) {
+    return sizeof(Header) + num_binding_slots * sizeof(BindingSlot);
+  }
+
+  static BindingSlot* getBindingSlots(Header* header) {
+    return reinterpret_cast<BindingSlot*>(header + 1);
+  }
+
+  static const BindingSlot* getBindingSlots(const Header* header) {
+    return reinterpret_cast<const BindingSlot*>(header + 1);
+  }
+};
+
+static_assert(sizeof(InjectorStatsSegment::Header) % alignof(InjectorStatsSegment::BindingSlot) == 0,
+              "The binding slots must be aligned");
+
+} // namespace impl
+} // namespace fruit
+
+#endif // FRUIT_INJECTOR_STATS_SEGMENT_H
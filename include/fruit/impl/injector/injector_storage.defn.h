@@ -96,6 +96,13 @@ inline const TypeId* InjectorStorage::BindingDataNodeIter::getEdgesEnd() {
   return itr->binding_for_object_to_construct.deps->deps + itr->binding_for_object_to_construct.deps->num_deps;
 }
 
+inline const bool* InjectorStorage::BindingDataNodeIter::getLazyEdgesBegin() {
+  FruitAssert(itr->kind == ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_ALLOCATION ||
+              itr->kind == ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION ||
+              itr->kind == ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_WITH_UNKNOWN_ALLOCATION);
+  return itr->binding_for_object_to_construct.deps->lazy_deps;
+}
+
 template <typename AnnotatedT>
 struct GetFirstStage;
 
@@ -157,6 +164,14 @@ struct GetFirstStage<const C&> {
 template <typename C>
 struct GetFirstStage<Provider<C>> {
   Provider<C> operator()(InjectorStorage& injector, InjectorStorage::Graph::node_iterator node_itr) {
+    if (injector.destruction_graph != nullptr && node_itr.isTerminal()) {
+      // The provided object might be used in the destructor of the object being constructed.
+      injector.getPtrInternalInstrumented(node_itr);
+    }
+    if (injector.generation_tracker != nullptr) {
+      // The object being constructed might use this Provider later, so it must not be reused by the next generation.
+      injector.markNotReusableForNextGeneration();
+    }
     return Provider<C>(&injector, node_itr);
   }
 };
@@ -229,9 +244,22 @@ struct GetSecondStage<Provider<C>> {
 template <typename Annotation, typename T>
 struct GetSecondStage<fruit::Annotated<Annotation, T>> : public GetSecondStage<T> {};
 
+inline std::unique_lock<std::recursive_mutex> InjectorStorage::lockIfNeeded() {
+  if (threading_policy == ThreadingPolicy::SINGLE_THREADED) {
+#if FRUIT_EXTRA_DEBUG
+    FruitAssert(std::this_thread::get_id() == owner_thread_id);
+#endif
+    return std::unique_lock<std::recursive_mutex>();
+  }
+  if (stats_exporter != nullptr) {
+    return lockAndRecordStats();
+  }
+  return std::unique_lock<std::recursive_mutex>(mutex);
+}
+
 template <typename AnnotatedT>
 inline InjectorStorage::RemoveAnnotations<AnnotatedT> InjectorStorage::get() {
-  std::lock_guard<std::recursive_mutex> lock(mutex);
+  std::unique_lock<std::recursive_mutex> lock = lockIfNeeded();
   return GetSecondStage<AnnotatedT>()(GetFirstStage<AnnotatedT>()(*this, lazyGetPtr<NormalizeType<AnnotatedT>>()));
 }
 
@@ -239,7 +267,7 @@ template <typename T>
 inline T InjectorStorage::get(InjectorStorage::Graph::node_iterator node_iterator) {
   FruitStaticAssert(fruit::impl::meta::IsSame(fruit::impl::meta::Type<T>,
                                               fruit::impl::meta::RemoveAnnotations(fruit::impl::meta::Type<T>)));
-  std::lock_guard<std::recursive_mutex> lock(mutex);
+  std::unique_lock<std::recursive_mutex> lock = lockIfNeeded();
   return GetSecondStage<T>()(GetFirstStage<T>()(*this, node_iterator));
 }
 
@@ -269,7 +297,7 @@ inline const C* InjectorStorage::getPtr(Graph::node_iterator itr) {
 
 template <typename AnnotatedC>
 inline const InjectorStorage::RemoveAnnotations<AnnotatedC>* InjectorStorage::unsafeGet() {
-  std::lock_guard<std::recursive_mutex> lock(mutex);
+  std::unique_lock<std::recursive_mutex> lock = lockIfNeeded();
   using C = RemoveAnnotations<AnnotatedC>;
   const void* p = unsafeGetPtr(getTypeId<AnnotatedC>());
   return reinterpret_cast<const C*>(p);
@@ -289,7 +317,7 @@ inline const void* InjectorStorage::unsafeGetPtr(TypeId type) {
 
 template <typename AnnotatedC>
 inline const std::vector<InjectorStorage::RemoveAnnotations<AnnotatedC>*>& InjectorStorage::getMultibindings() {
-  std::lock_guard<std::recursive_mutex> lock(mutex);
+  std::unique_lock<std::recursive_mutex> lock = lockIfNeeded();
   using C = RemoveAnnotations<AnnotatedC>;
   void* p = getMultibindings(getTypeId<AnnotatedC>());
   if (p == nullptr) {
@@ -301,6 +329,9 @@ inline const std::vector<InjectorStorage::RemoveAnnotations<AnnotatedC>*>& Injec
 }
 
 inline const void* InjectorStorage::getPtrInternal(Graph::node_iterator node_itr) {
+  if (is_instrumented) {
+    return getPtrInternalInstrumented(node_itr);
+  }
   NormalizedBinding& normalized_binding = node_itr.getNode();
   if (!node_itr.isTerminal()) {
     normalized_binding.object = normalized_binding.create(*this, node_itr);
@@ -620,7 +651,8 @@ inline ComponentStorageEntry InjectorStorage::createComponentStorageEntryForProv
   result.type_id = getTypeId<AnnotatedC>();
   ComponentStorageEntry::BindingForObjectToConstruct& binding = result.binding_for_object_to_construct;
   binding.create = createInjectedObjectForProvider<C, T, AnnotatedSignature, Lambda>;
-  binding.deps = getBindingDeps<NormalizedSignatureArgs<AnnotatedSignature>>();
+  binding.deps =
+      getBindingDeps<NormalizedSignatureArgs<AnnotatedSignature>, LazySignatureArgs<AnnotatedSignature>>();
 #if FRUIT_EXTRA_DEBUG
   binding.is_nonconst = true;
 #endif
@@ -734,7 +766,8 @@ inline ComponentStorageEntry InjectorStorage::createComponentStorageEntryForCons
   result.type_id = getTypeId<AnnotatedC>();
   ComponentStorageEntry::BindingForObjectToConstruct& binding = result.binding_for_object_to_construct;
   binding.create = createInjectedObjectForConstructor<C, AnnotatedSignature>;
-  binding.deps = getBindingDeps<NormalizedSignatureArgs<AnnotatedSignature>>();
+  binding.deps =
+      getBindingDeps<NormalizedSignatureArgs<AnnotatedSignature>, LazySignatureArgs<AnnotatedSignature>>();
 #if FRUIT_EXTRA_DEBUG
   binding.is_nonconst = true;
 #endif
@@ -840,7 +873,8 @@ inline ComponentStorageEntry InjectorStorage::createComponentStorageEntryForMult
   result.type_id = getTypeId<AnnotatedC>();
   ComponentStorageEntry::MultibindingForObjectToConstruct& binding = result.multibinding_for_object_to_construct;
   binding.create = createInjectedObjectForMultibindingProvider<C, T, AnnotatedSignature, Lambda>;
-  binding.deps = getBindingDeps<NormalizedSignatureArgs<AnnotatedSignature>>();
+  binding.deps =
+      getBindingDeps<NormalizedSignatureArgs<AnnotatedSignature>, LazySignatureArgs<AnnotatedSignature>>();
   return result;
 }
 
@@ -18,10 +18,14 @@
 #define FRUIT_INJECTOR_STORAGE_H
 
 #include <fruit/fruit_forward_decls.h>
+#include <fruit/eager_injection_progress.h>
+#include <fruit/injector_buffer.h>
+#include <fruit/type_allocation_stats.h>
 #include <fruit/impl/data_structures/fixed_size_allocator.h>
 #include <fruit/impl/meta/component.h>
 #include <fruit/impl/normalized_component_storage/normalized_bindings.h>
 
+#include <chrono>
 #include <unordered_map>
 #include <vector>
 #include <mutex>
@@ -31,6 +35,12 @@
 namespace fruit {
 namespace impl {
 
+class AllocationTracker;
+class DestructionGraph;
+class GenerationTracker;
+struct ReusedObject;
+class InjectorStatsExporter;
+
 template <typename T>
 struct GetHelper;
 
@@ -49,6 +59,13 @@ public:
   //                                   std::vector<std::pair<TypeId, MultibindingData>>>;
   using Graph = SemistaticGraph<TypeId, NormalizedBinding>;
 
+  enum class ThreadingPolicy {
+    // The injector can be used concurrently from multiple threads, all accesses are synchronized using `mutex'.
+    THREAD_SAFE,
+    // The injector is only used from the thread that constructed it, so no locking is needed.
+    SINGLE_THREADED,
+  };
+
   template <typename AnnotatedT>
   using RemoveAnnotations = fruit::impl::meta::UnwrapType<
       fruit::impl::meta::Eval<fruit::impl::meta::RemoveAnnotations(fruit::impl::meta::Type<AnnotatedT>)>>;
@@ -79,6 +96,11 @@ public:
   using NormalizedSignatureArgs = fruit::impl::meta::Eval<fruit::impl::meta::NormalizeTypeVector(
       fruit::impl::meta::SignatureArgs(fruit::impl::meta::Type<Signature>))>;
 
+  // A meta::Vector with a meta::Bool for each element of NormalizedSignatureArgs<Signature>, true for the Provider<>s.
+  template <typename Signature>
+  using LazySignatureArgs = fruit::impl::meta::Eval<fruit::impl::meta::TransformVector(
+      fruit::impl::meta::SignatureArgs(fruit::impl::meta::Type<Signature>), fruit::impl::meta::IsProviderType)>;
+
   // Prints the specified error and calls exit(1).
   static void fatal(const std::string& error);
 
@@ -119,12 +141,37 @@ public:
   static ComponentStorageEntry createComponentStorageEntryForMultibindingProvider();
 
 private:
+  // The objects of this injector that are shared with other generations (see reuseObjectsFrom()), whether they were
+  // reused from a previous generation or reused by the next one. This is declared first so that these are released
+  // after the other objects of this injector are destroyed, since those might depend on them.
+  std::vector<std::shared_ptr<ReusedObject>> reused_objects;
+
   // The NormalizedComponentStorage owned by this object (if any).
   // Only used for the 1-argument constructor, otherwise it's nullptr.
   std::unique_ptr<NormalizedComponentStorage> normalized_component_storage_ptr;
 
   FixedSizeAllocator allocator;
 
+  // The size of the buffer that would have been needed to store all the memory of `allocator'.
+  std::size_t required_buffer_size;
+
+  // Only set if concurrent destruction was enabled with enableConcurrentDestruction(), otherwise it's nullptr.
+  // Records the dependencies between the constructed objects, so that they can be destroyed concurrently.
+  std::unique_ptr<DestructionGraph> destruction_graph;
+
+  // Only set if allocation tracking was enabled with enableAllocationTracking(), otherwise it's nullptr.
+  std::unique_ptr<AllocationTracker> allocation_tracker;
+
+  // Only set if generation tracking was enabled with enableGenerationTracking(), otherwise it's nullptr.
+  std::unique_ptr<GenerationTracker> generation_tracker;
+
+  // Only set if stats export was enabled with enableStatsExport(), otherwise it's nullptr.
+  std::unique_ptr<InjectorStatsExporter> stats_exporter;
+
+  // True if at least one of destruction_graph, allocation_tracker, generation_tracker and stats_exporter is set, so
+  // that getPtrInternal() only needs to check this.
+  bool is_instrumented = false;
+
   // A graph with injected types as nodes (each node stores the NormalizedBindingData for the type) and dependencies as
   // edges.
   // For types that have a constructed object already, the corresponding node is stored as terminal node.
@@ -135,12 +182,55 @@ private:
   std::unordered_map<TypeId, NormalizedMultibindingSet> multibindings;
 
   // This mutex is used to synchronize concurrent accesses to this InjectorStorage object.
+  // It's never locked if threading_policy is SINGLE_THREADED.
   std::recursive_mutex mutex;
 
+  ThreadingPolicy threading_policy;
+
+  // The number of steps of eagerlyInjectSome() completed so far.
+  std::size_t num_completed_eager_injection_steps = 0;
+
+  // The multibinding sets, in the order in which eagerlyInjectSome() injects them. Only populated by the first call
+  // to eagerlyInjectSome().
+  std::vector<NormalizedMultibindingSet*> eager_injection_multibinding_sets;
+
+  // A binding that eagerlyInjectSome() is injecting, and the index of the next neighbor (i.e. dependency) to inject.
+  struct EagerInjectionFrame {
+    Graph::node_iterator node;
+    std::size_t next_neighbor;
+  };
+
+  // The bindings that eagerlyInjectSome() is injecting in the current step. Each one is a dependency of the previous
+  // one, unless they're the dependencies of a multibinding.
+  std::vector<EagerInjectionFrame> eager_injection_stack;
+
+  // Whether the bindings needed by the current step (or, for multibinding set steps, by the current multibinding) were
+  // already pushed on eager_injection_stack.
+  bool is_eager_injection_step_started = false;
+
+  // In multibinding set steps, the index of the next multibinding to inject.
+  std::size_t next_eager_injection_multibinding = 0;
+
+  // True after compact() was called.
+  bool is_compacted = false;
+
+#if FRUIT_EXTRA_DEBUG
+  // The thread that constructed this object. Only used to check that single-threaded injectors are never accessed
+  // from other threads.
+  std::thread::id owner_thread_id;
+#endif
+
 private:
   template <typename AnnotatedC>
   static std::shared_ptr<char> createMultibindingVector(InjectorStorage& storage);
 
+  // Locks `mutex' (if needed according to threading_policy) until the returned object is destroyed.
+  std::unique_lock<std::recursive_mutex> lockIfNeeded();
+
+  // Equivalent to std::unique_lock<std::recursive_mutex>(mutex), but also records the acquisition (and the time spent
+  // waiting, if any) in stats_exporter, that must be non-null.
+  std::unique_lock<std::recursive_mutex> lockAndRecordStats();
+
   // If not bound, returns nullptr.
   NormalizedMultibindingSet* getNormalizedMultibindingSet(TypeId type);
 
@@ -155,6 +245,26 @@ private:
   // Similar to the previous, but takes a node_iterator. Use this when the node_iterator is known, it's faster.
   const void* getPtrInternal(Graph::node_iterator itr);
 
+  // Equivalent to getPtrInternal(), but also records the construction/dependency in destruction_graph,
+  // allocation_tracker, generation_tracker and stats_exporter (if non-null).
+  const void* getPtrInternalInstrumented(Graph::node_iterator itr);
+
+  // Records a construction in destruction_graph, allocation_tracker, generation_tracker and stats_exporter (if
+  // non-null), from its constructor to the call to end(). If end() is never called (e.g. because the provider threw),
+  // the destructor aborts the construction in all of them.
+  class InstrumentedConstruction;
+
+  // Records (in generation_tracker, that must be non-null) that the object currently being constructed obtained a
+  // Provider.
+  void markNotReusableForNextGeneration();
+
+  // Returns the ReusedObject that owns the object of the binding identified by `key', creating it (and making the
+  // allocator no longer destroy the object) if needed. Returns nullptr for bindInstance() bindings.
+  std::shared_ptr<ReusedObject> getOrCreateReusedObject(const void* key);
+
+  // Used as the create function of the bindings that weren't constructed when compact() was called.
+  static const void* createInjectedObjectAfterCompaction(InjectorStorage& injector, Graph::node_iterator node_itr);
+
   // getPtr(typeInfo) is equivalent to getPtr(lazyGetPtr(typeInfo)).
   Graph::node_iterator lazyGetPtr(TypeId type);
 
@@ -172,6 +282,12 @@ private:
   // Constructs any necessary instances, but NOT the instance set.
   void ensureConstructedMultibinding(NormalizedMultibindingSet& multibinding_set);
 
+  // Constructs a multibinding that was not constructed yet.
+  void constructMultibinding(NormalizedMultibinding& multibinding);
+
+  // Pushes `node' on eager_injection_stack, unless it's constructed already.
+  void pushEagerInjectionFrame(Graph::node_iterator node);
+
   template <typename T>
   friend struct GetFirstStage;
 
@@ -226,19 +342,23 @@ public:
     bool isTerminal();
     const TypeId* getEdgesBegin();
     const TypeId* getEdgesEnd();
+    const bool* getLazyEdgesBegin();
   };
 
   /**
    * The MemoryPool is only used during construction, the constructed object *can* outlive the memory pool.
    */
   InjectorStorage(ComponentStorage&& storage, const std::vector<TypeId, ArenaAllocator<TypeId>>& exposed_types,
-                  MemoryPool& memory_pool);
+                  MemoryPool& memory_pool, ThreadingPolicy threading_policy = ThreadingPolicy::THREAD_SAFE);
 
   /**
    * The MemoryPool is only used during construction, the constructed object *can* outlive the memory pool.
+   * If buffer.data is not nullptr, the injected objects and their destruction list are stored in `buffer' (that must
+   * outlive this object) instead of in a heap-allocated block. Calls fatal() if buffer.size is too small.
    */
   InjectorStorage(const NormalizedComponentStorage& normalized_storage, ComponentStorage&& storage,
-                  MemoryPool& memory_pool);
+                  MemoryPool& memory_pool, ThreadingPolicy threading_policy = ThreadingPolicy::THREAD_SAFE,
+                  InjectorBuffer buffer = InjectorBuffer{nullptr, 0});
 
   // This is just the default destructor, but we declare it here to avoid including
   // normalized_component_storage.h in fruit.h.
@@ -277,6 +397,44 @@ public:
   const std::vector<RemoveAnnotations<AnnotatedC>*>& getMultibindings();
 
   void eagerlyInjectMultibindings();
+
+  // See Injector::eagerlyInjectSome(). `exposed_types' points to the `num_exposed_types' (normalized) types exposed by
+  // the injector; they're the first steps, followed by one step for each multibinding set.
+  EagerInjectionProgress eagerlyInjectSome(const TypeId* exposed_types, std::size_t num_exposed_types,
+                                           std::chrono::steady_clock::time_point deadline);
+
+  // Makes the destructor destroy the injected objects using up to `num_threads' threads, still destroying each object
+  // before the objects it was constructed from. Must be called before any object is injected.
+  void enableConcurrentDestruction(std::size_t num_threads);
+
+  // See Injector::enableAllocationTracking().
+  void enableAllocationTracking(std::size_t (*get_allocated_bytes)());
+
+  // See Injector::getTopAllocatingTypes().
+  std::vector<TypeAllocationStats> getTopAllocatingTypes(std::size_t max_num_types);
+
+  // See Injector::enableStatsExport().
+  void enableStatsExport(const std::string& segment_name);
+
+  // See Injector::getRequiredBufferSize().
+  std::size_t getRequiredBufferSize();
+
+  // See Injector::compact(). `type_steps' points to `num_exposed_types' functions that inject the types exposed by the
+  // injector (as in eagerlyInjectSome()) and `exposed_types' to the corresponding normalized types.
+  void compact(void (*const* type_steps)(InjectorStorage&), const TypeId* exposed_types,
+               std::size_t num_exposed_types);
+
+  // Makes this injector record how each object is constructed, so that it can be passed to reuseObjectsFrom() when
+  // constructing the next generation. Must be called before any object is injected.
+  void enableGenerationTracking();
+
+  // Reuses the objects of `previous_generation' whose binding (and the bindings of all their transitive dependencies)
+  // is the same in this injector, instead of constructing them again. Both injectors must have generation tracking
+  // enabled, and this must be called before any object is injected in this injector.
+  // `previous_generation' doesn't need to outlive this injector: the reused objects are owned by both injectors (and by
+  // any other generation that reuses them), while the other objects of `previous_generation' are still destroyed with
+  // it.
+  void reuseObjectsFrom(InjectorStorage& previous_generation);
 };
 
 } // namespace impl
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_PER_CPU_SHARDS_H
+#define FRUIT_PER_CPU_SHARDS_H
+
+#include <cstddef>
+#include <functional>
+
+namespace fruit {
+namespace impl {
+
+/**
+ * Stores one object for each CPU, each in its own cache line(s) so that objects of different CPUs never share a cache
+ * line.
+ *
+ * All objects are constructed by the constructor (in shard order) and destroyed by the destructor (in reverse order).
+ */
+class PerCpuShards {
+public:
+  // Constructs an object in the (uninitialized, suitably aligned) memory passed as argument.
+  using construct_t = std::function<void(void*)>;
+  using destroy_t = void (*)(void*);
+
+  // The alignment (and the granularity of the size) of the memory used for each shard. This is 2 cache lines instead of
+  // 1 since on some CPUs the prefetcher fetches pairs of adjacent cache lines.
+  static constexpr std::size_t shard_alignment = 128;
+
+  PerCpuShards(std::size_t object_size, std::size_t object_alignment, const construct_t& construct, destroy_t destroy);
+
+  PerCpuShards(const PerCpuShards&) = delete;
+  PerCpuShards& operator=(const PerCpuShards&) = delete;
+
+  ~PerCpuShards();
+
+  // The object for the CPU that the calling thread is running on. The thread might be migrated to another CPU right
+  // after this returns, so other threads might be using the same object concurrently.
+  void* getCurrent();
+
+  // The object of the index-th shard, for index < numShards().
+  void* getShard(std::size_t index);
+
+  std::size_t numShards() const;
+
+private:
+  // Returns the index of the shard for the CPU that the calling thread is running on.
+  std::size_t getCurrentShardIndex() const;
+
+  std::size_t num_shards;
+  std::size_t shard_size;
+  destroy_t destroy;
+
+  // The memory allocated for the shards, that might start before the first shard because of the alignment.
+  char* memory;
+
+  // The first shard, aligned to max(shard_alignment, object_alignment).
+  char* shards_begin;
+};
+
+} // namespace impl
+} // namespace fruit
+
+#endif // FRUIT_PER_CPU_SHARDS_H
@@ -0,0 +1,69 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_THREAD_LOCAL_SLOT_H
+#define FRUIT_THREAD_LOCAL_SLOT_H
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+namespace fruit {
+namespace impl {
+
+/**
+ * Stores a separate object for each thread that calls get().
+ *
+ * The object for a thread is constructed by the first get() call in that thread, and it's destroyed when that thread
+ * exits or when the ThreadLocalSlot is destroyed, whichever comes first. Only the first get() call in each thread
+ * takes a lock, later calls just look up the object in a per-thread vector (indexed by a per-slot index).
+ */
+class ThreadLocalSlot {
+public:
+  using create_t = std::function<void*()>;
+  using destroy_t = void (*)(void*);
+
+  // Data shared between the slot and the per-thread storage of the threads that used it (if any).
+  struct ControlBlock;
+
+  ThreadLocalSlot(create_t create, destroy_t destroy);
+
+  ThreadLocalSlot(const ThreadLocalSlot&) = delete;
+  ThreadLocalSlot& operator=(const ThreadLocalSlot&) = delete;
+
+  // Destroys the objects of all threads that still have one.
+  ~ThreadLocalSlot();
+
+  // Returns the object for the calling thread, constructing it if necessary.
+  void* get();
+
+private:
+  // Called by get() when the calling thread has no object yet.
+  void* constructForCurrentThread();
+
+  // The index of this slot in the per-thread vectors. Indexes are reused after a slot is destroyed.
+  std::size_t index;
+
+  // Also used to tell apart the entries of this slot from the entries of a previous slot with the same index.
+  std::shared_ptr<ControlBlock> control_block;
+
+  create_t create;
+};
+
+} // namespace impl
+} // namespace fruit
+
+#endif // FRUIT_THREAD_LOCAL_SLOT_H
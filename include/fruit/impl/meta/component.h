@@ -29,6 +29,7 @@
 #include <fruit/impl/meta/proof_trees.h>
 #include <fruit/impl/meta/set.h>
 #include <fruit/impl/meta/signatures.h>
+#include <fruit/impl/meta/triplet.h>
 #include <fruit/impl/meta/wrappers.h>
 
 #include <memory>
@@ -176,6 +177,28 @@ struct NormalizeType {
   };
 };
 
+// Returns Bool<true> if T is a (possibly annotated) Provider, i.e. if injecting T doesn't construct the object of type
+// NormalizeType(T).
+struct IsProviderType {
+  template <typename T>
+  struct apply;
+
+  template <typename T>
+  struct apply<Type<T>> {
+    using type = Bool<false>;
+  };
+
+  template <typename T>
+  struct apply<Type<Provider<T>>> {
+    using type = Bool<true>;
+  };
+
+  template <typename Annotation, typename T>
+  struct apply<Type<fruit::Annotated<Annotation, T>>> {
+    using type = IsProviderType(Type<T>);
+  };
+};
+
 struct NormalizeUntilStable {
   template <typename T>
   struct apply {
@@ -465,6 +488,37 @@ struct NumAssistedBefore {
   };
 };
 
+// Returns a Vector with an element for each type in V (the args in the signature of an assisted factory), saying where
+// the factory's lambda gets that arg from: Pair<Bool<true>, Int<n>> for the n-th Assisted<> arg (that the caller of the
+// factory provides) and Pair<Bool<false>, Int<n>> for the n-th non-Assisted<> arg (that is injected).
+// This visits V just once, unlike calling NumAssistedBefore for each index.
+struct AssistedFactoryArgSources {
+  template <typename V>
+  struct apply {
+    struct Helper {
+      // CurrentResult is a Triplet<Sources, NumAssistedArgs, NumInjectedArgs> for the args visited so far.
+      template <typename CurrentResult, typename T>
+      struct apply;
+
+      // Non-assisted case
+      template <typename... Sources, int num_assisted, int num_injected, typename T>
+      struct apply<Triplet<Vector<Sources...>, Int<num_assisted>, Int<num_injected>>, T> {
+        using type = Triplet<Vector<Sources..., Pair<Bool<false>, Int<num_injected>>>, Int<num_assisted>,
+                             Int<num_injected + 1>>;
+      };
+
+      // Assisted case
+      template <typename... Sources, int num_assisted, int num_injected, typename T>
+      struct apply<Triplet<Vector<Sources...>, Int<num_assisted>, Int<num_injected>>, Type<Assisted<T>>> {
+        using type = Triplet<Vector<Sources..., Pair<Bool<true>, Int<num_assisted>>>, Int<num_assisted + 1>,
+                             Int<num_injected>>;
+      };
+    };
+
+    using type = GetFirst(FoldVector(V, Helper, Triplet<Vector<>, Int<0>, Int<0>>));
+  };
+};
+
 // Checks whether C is auto-injectable thanks to an Inject typedef.
 struct HasInjectAnnotation {
   template <typename C>
@@ -905,6 +959,20 @@ struct AddRequirements {
   };
 };
 
+#if !FRUIT_NO_LOOP_CHECK
+// The Deps of a Comp never contain a loop: each functor that adds dependencies uses this to check the result, as soon
+// as the dependencies are added. Since there was no loop before, any loop must go through one of the types in Ths
+// (the types whose dependencies were just added), so only the part of Deps reachable from those is visited.
+// Returns Comp, or an error if there's a loop.
+struct CheckNoLoopInDepsFrom {
+  template <typename Comp, typename Ths>
+  struct apply {
+    using Loop = ProofForestFindLoopFromThs(typename Comp::Deps, Ths);
+    using type = If(IsNone(Loop), Comp, ConstructErrorWithArgVector(SelfLoopErrorTag, Loop));
+  };
+};
+#endif // !FRUIT_NO_LOOP_CHECK
+
 // Similar to AddProvidedType, but doesn't report an error if a Bind<C, CImpl> was present.
 struct AddProvidedTypeIgnoringInterfaceBindings {
   template <typename Comp, typename C, typename IsNonConst, typename CRequirements, typename CNonConstRequirements>
@@ -917,8 +985,18 @@ struct AddProvidedTypeIgnoringInterfaceBindings {
         PushFront(typename Comp::Deps, Pair<C, CRequirements>),
 #endif
         typename Comp::InterfaceBindings, typename Comp::DeferredBindingFunctors);
+#if !FRUIT_NO_LOOP_CHECK
+    // A new loop would have to go through C, and C had no dependencies before. So unless C depends on itself, there
+    // can only be a loop if C was already required by another type and C depends on an already-provided type. This
+    // is rarely the case, so usually we don't even need to look at Deps.
+    using Comp2 = If(Or(IsInSet(C, CRequirements),
+                        And(IsInSet(C, typename Comp::RsSuperset), Not(IsDisjoint(CRequirements, typename Comp::Ps)))),
+                     CheckNoLoopInDepsFrom(Comp1, Vector<C>), Comp1);
+#else
+    using Comp2 = Comp1;
+#endif
     using type = If(IsInSet(C, typename Comp::Ps), ConstructError(TypeAlreadyBoundErrorTag, C),
-                    PropagateError(CheckTypesNotProvidedAsConst(Comp, CNonConstRequirements), Comp1));
+                    PropagateError(CheckTypesNotProvidedAsConst(Comp, CNonConstRequirements), Comp2));
   };
 };
 
@@ -948,14 +1026,6 @@ struct AddDeferredBinding {
   };
 };
 
-struct CheckNoLoopInDeps {
-  template <typename Comp>
-  struct apply {
-    using Loop = ProofForestFindLoop(typename Comp::Deps);
-    using type = If(IsNone(Loop), Bool<true>, ConstructErrorWithArgVector(SelfLoopErrorTag, Loop));
-  };
-};
-
 #if FRUIT_EXTRA_DEBUG || FRUIT_IN_META_TEST
 struct CheckComponentEntails {
   template <typename Comp, typename EntailedComp>
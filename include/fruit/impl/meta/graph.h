@@ -35,9 +35,12 @@ using GraphFindNeighbors = FindInImmutableMap;
 using GraphContainsNode = ImmutableMapContainsKey;
 
 // Returns a loop in the given graph as a Vector<N1, ..., Nk> such that the graph contains a loop
-// N1->...->Nk->N1, or None if there are no loops.
-struct GraphFindLoop {
-  template <typename G>
+// N1->...->Nk->N1, or None if there are no loops reachable from the nodes in the StartNodes vector.
+// Only the nodes reachable from StartNodes are visited, so when some edges are added to a graph with no loops this
+// can be used to check that there are still no loops by starting only from the sources of the new edges (since any
+// new loop must contain at least one of them).
+struct GraphFindLoopFromNodes {
+  template <typename G, typename StartNodes>
   struct apply {
     using ImmutableG = VectorToImmutableMap(G);
 
@@ -99,7 +102,16 @@ struct GraphFindLoop {
       };
     };
 
-    using type = GetSecond(FoldVector(GetMapKeys(G), VisitStartingAtNode, Pair<EmptySet, None>));
+    using type = GetSecond(FoldVector(StartNodes, VisitStartingAtNode, Pair<EmptySet, None>));
+  };
+};
+
+// Returns a loop in the given graph as a Vector<N1, ..., Nk> such that the graph contains a loop
+// N1->...->Nk->N1, or None if there are no loops.
+struct GraphFindLoop {
+  template <typename G>
+  struct apply {
+    using type = GraphFindLoopFromNodes(G, GetMapKeys(G));
   };
 };
 
@@ -52,6 +52,11 @@ using ProofForestFindHps = GraphFindNeighbors;
 // if there is no such loop, returns None.
 using ProofForestFindLoop = GraphFindLoop;
 
+// ProofForestFindLoopFromThs(F, Ths) returns a loop as ProofForestFindLoop does, but only looks for loops that can be
+// reached from the theses in the Ths vector. This is enough to check a forest after adding proofs for Ths to a forest
+// with no loops, and only visits the part of the forest reachable from Ths.
+using ProofForestFindLoopFromThs = GraphFindLoopFromNodes;
+
 #else // FRUIT_NO_LOOP_CHECK
 
 struct ProofForestFindLoop {
@@ -33,6 +33,41 @@ inline NormalizedComponent<Params...>::NormalizedComponent(Component<Params...>
                                         .storage),
                           fruit::impl::MemoryPool()) {}
 
+namespace impl {
+namespace meta {
+
+// This performs all checks needed in the constructor of NormalizedComponent that slices another NormalizedComponent.
+template <typename SliceComp, typename ParentComp>
+struct CheckNormalizedComponentSlice {
+  using ParentRs = SetDifference(GetComponentRsSuperset(ParentComp), GetComponentPs(ParentComp));
+  using SliceNonConstPs = SetIntersection(GetComponentNonConstRsPs(SliceComp), GetComponentPs(SliceComp));
+
+  using type = Eval<If(
+      Not(IsContained(GetComponentPs(SliceComp), GetComponentPs(ParentComp))),
+      ConstructErrorWithArgVector(TypesInNormalizedComponentSliceNotProvidedErrorTag,
+                                  SetToVector(SetDifference(GetComponentPs(SliceComp), GetComponentPs(ParentComp)))),
+      If(Not(IsContained(SliceNonConstPs, GetComponentNonConstRsPs(ParentComp))),
+         ConstructErrorWithArgVector(TypesInNormalizedComponentSliceProvidedAsConstOnlyErrorTag,
+                                     SetToVector(SetDifference(SliceNonConstPs, GetComponentNonConstRsPs(ParentComp)))),
+         If(Not(IsContained(ParentRs, GetComponentRsSuperset(SliceComp))),
+            ConstructErrorWithArgVector(NormalizedComponentSliceWithMissingRequirementsErrorTag,
+                                        SetToVector(SetDifference(ParentRs, GetComponentRsSuperset(SliceComp)))),
+            None)))>;
+};
+
+} // namespace meta
+} // namespace impl
+
+template <typename... Params>
+template <typename... ParentParams>
+inline NormalizedComponent<Params...>::NormalizedComponent(const NormalizedComponent<ParentParams...>& parent)
+    : NormalizedComponent(parent.storage, fruit::impl::MemoryPool()) {
+  using SliceComp = fruit::impl::meta::ConstructComponentImpl(fruit::impl::meta::Type<Params>...);
+  using ParentComp = fruit::impl::meta::ConstructComponentImpl(fruit::impl::meta::Type<ParentParams>...);
+  using E = typename fruit::impl::meta::CheckNormalizedComponentSlice<SliceComp, ParentComp>::type;
+  (void)typename fruit::impl::meta::CheckIfError<E>::type();
+}
+
 template <typename... Params>
 inline NormalizedComponent<Params...>::NormalizedComponent(fruit::impl::ComponentStorage&& storage,
                                                            fruit::impl::MemoryPool memory_pool)
@@ -42,6 +77,15 @@ inline NormalizedComponent<Params...>::NormalizedComponent(fruit::impl::Componen
                       fruit::impl::meta::Type<Params>...)>::Ps)>>(memory_pool),
               memory_pool, fruit::impl::NormalizedComponentStorageHolder::WithUndoableCompression()) {}
 
+template <typename... Params>
+inline NormalizedComponent<Params...>::NormalizedComponent(
+    const fruit::impl::NormalizedComponentStorageHolder& parent_storage, fruit::impl::MemoryPool memory_pool)
+    : storage(parent_storage,
+              fruit::impl::getTypeIdsForList<typename fruit::impl::meta::Eval<fruit::impl::meta::SetToVector(
+                  typename fruit::impl::meta::Eval<fruit::impl::meta::ConstructComponentImpl(
+                      fruit::impl::meta::Type<Params>...)>::Ps)>>(memory_pool),
+              memory_pool) {}
+
 } // namespace fruit
 
 #endif // FRUIT_NORMALIZED_COMPONENT_INLINES_H
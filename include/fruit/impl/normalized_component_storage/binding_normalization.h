@@ -22,6 +22,7 @@
 #error "binding_normalization.h included in non-cpp file."
 #endif
 
+#include <fruit/impl/component_storage/component_storage.h>
 #include <fruit/impl/component_storage/component_storage_entry.h>
 #include <fruit/impl/data_structures/arena_allocator.h>
 #include <fruit/impl/data_structures/fixed_size_allocator.h>
@@ -272,6 +273,9 @@ private:
     HashMapWithArenaAllocator<TypeId, ComponentStorageEntry>& binding_data_map;
     BindingNormalizationFunctors<Functors...> functors;
 
+    // Lets the Component objects built by the expanded component functions reuse the same vector of entries.
+    ComponentStorage::EntryRecyclingScope entry_recycling_scope;
+
     // These are in reversed order (note that toplevel_entries must also be in reverse order).
     std::vector<ComponentStorageEntry, ArenaAllocator<ComponentStorageEntry>> entries_to_process;
 
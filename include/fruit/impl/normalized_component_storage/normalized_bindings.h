@@ -59,6 +59,9 @@ struct NormalizedMultibinding {
     // Valid iff is_constructed==false.
     ComponentStorageEntry::MultibindingForObjectToConstruct::create_t create;
   };
+
+  // The deps of `create', nullptr for multibindings that were constructed already when they were registered.
+  const BindingDeps* deps;
 };
 
 /** This stores all multibindings for a given type_id. */
@@ -123,6 +123,11 @@ private:
   LazyComponentWithNoArgsReplacementMap component_with_no_args_replacements;
   LazyComponentWithArgsReplacementMap component_with_args_replacements;
 
+  // The entries that `bindings' was constructed from (after binding compression), including the deps of each binding.
+  // These are only kept when constructing with WithUndoableCompression (or from another NormalizedComponentStorage), so
+  // that this object can later be sliced.
+  std::vector<ComponentStorageEntry> binding_entries;
+
   friend class InjectorStorage;
   friend class BindingNormalization;
 
@@ -155,6 +160,21 @@ public:
                              const std::vector<TypeId, ArenaAllocator<TypeId>>& exposed_types, MemoryPool& memory_pool,
                              WithPermanentCompression);
 
+  /**
+   * Constructs a slice of `parent', with only the bindings of `parent' that are reachable from `exposed_types'.
+   * Multibindings are not reachable from any type, so they're not kept. The component replacements of `parent' are
+   * kept. If this keeps all the bindings and multibindings of `parent', the components fully expanded in `parent' are
+   * also considered as such in this object and binding compression is kept; otherwise, none of them is (so they're
+   * expanded again if they're installed in an injector's component) and all binding compressions are undone.
+   *
+   * This reuses the normalized bindings of `parent' and doesn't call any component function. `parent' can be destroyed
+   * before this object.
+   *
+   * The MemoryPool is only used during construction, the constructed object *can* outlive the memory pool.
+   */
+  NormalizedComponentStorage(const NormalizedComponentStorage& parent,
+                             const std::vector<TypeId, ArenaAllocator<TypeId>>& exposed_types, MemoryPool& memory_pool);
+
   // We don't use the default destructor because that will require the inclusion of
   // the Boost's hashmap header. We define this in the cpp file instead.
   ~NormalizedComponentStorage() noexcept;
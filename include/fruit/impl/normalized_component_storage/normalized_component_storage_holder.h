@@ -55,6 +55,14 @@ public:
                                    const std::vector<TypeId, ArenaAllocator<TypeId>>& exposed_types,
                                    MemoryPool& memory_pool, WithUndoableCompression);
 
+  /**
+   * Holds a slice of parent's NormalizedComponentStorage, with only the bindings reachable from exposed_types.
+   * The MemoryPool is only used during construction, the constructed object *can* outlive the memory pool.
+   */
+  NormalizedComponentStorageHolder(const NormalizedComponentStorageHolder& parent,
+                                   const std::vector<TypeId, ArenaAllocator<TypeId>>& exposed_types,
+                                   MemoryPool& memory_pool);
+
   NormalizedComponentStorageHolder(NormalizedComponentStorage&&) = delete;
   NormalizedComponentStorageHolder(const NormalizedComponentStorage&) = delete;
 
@@ -0,0 +1,123 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_PER_CPU_DEFN_H
+#define FRUIT_PER_CPU_DEFN_H
+
+#include <fruit/impl/bindings.h>
+#include <fruit/impl/meta/component.h>
+#include <fruit/impl/meta_operation_wrappers.h>
+#include <fruit/impl/util/lambda_invoker.h>
+
+// Redundant, but makes KDevelop happy.
+#include <fruit/per_cpu.h>
+
+#include <new>
+#include <utility>
+
+namespace fruit {
+
+template <typename T>
+template <typename F>
+inline PerCpu<T>::PerCpu(F create)
+    : shards(new fruit::impl::PerCpuShards(sizeof(T), alignof(T), [&create](void* p) { new (p) T(create()); },
+                                           [](void* p) { static_cast<T*>(p)->~T(); })) {}
+
+template <typename T>
+inline T& PerCpu<T>::get() {
+  return *static_cast<T*>(shards->getCurrent());
+}
+
+template <typename T>
+inline T& PerCpu<T>::operator*() {
+  return get();
+}
+
+template <typename T>
+inline T* PerCpu<T>::operator->() {
+  return &get();
+}
+
+template <typename T>
+inline std::size_t PerCpu<T>::numShards() const {
+  return shards->numShards();
+}
+
+template <typename T>
+inline T& PerCpu<T>::getShard(std::size_t index) {
+  return *static_cast<T*>(shards->getShard(index));
+}
+
+template <typename T>
+template <typename F>
+inline void PerCpu<T>::forEachShard(F f) {
+  for (std::size_t i = 0; i < shards->numShards(); ++i) {
+    f(getShard(i));
+  }
+}
+
+namespace impl {
+
+// Wraps AnnotatedT's type in PerCpu<>, keeping the annotation (if any).
+template <typename AnnotatedT, typename T>
+struct AnnotatedPerCpuType {
+  using type = PerCpu<T>;
+};
+
+template <typename Annotation, typename AnnotatedT, typename T>
+struct AnnotatedPerCpuType<fruit::Annotated<Annotation, AnnotatedT>, T> {
+  using type = fruit::Annotated<Annotation, PerCpu<T>>;
+};
+
+template <typename AnnotatedT, typename... AnnotatedArgs, typename Lambda>
+struct PerCpuProviderHelper<AnnotatedT(AnnotatedArgs...), Lambda> {
+  // Unlike for ThreadLocal, this must be a value type (registerPerCpuProvider() reports an error for pointers).
+  using T = RemoveAnnotations<AnnotatedT>;
+
+  using Signature = typename AnnotatedPerCpuType<AnnotatedT, T>::type(AnnotatedArgs...);
+
+  // All the shards are constructed within the PerCpu constructor, so the lambda can just refer to the arguments.
+  // Each shard is constructed directly from the result of the lambda (see PerCpu's constructor), without moving it.
+  static PerCpu<T> provide(RemoveAnnotations<AnnotatedArgs>... args) {
+    return PerCpu<T>([&]() { return LambdaInvoker::invoke<Lambda>(args...); });
+  }
+
+  // The provider actually registered in the component. This runs only once per injector, and returns the PerCpu object
+  // shared by all threads. Like a captureless lambda, it's convertible to a function pointer.
+  struct Functor {
+    using FunctionPointer = PerCpu<T> (*)(RemoveAnnotations<AnnotatedArgs>...);
+
+    PerCpu<T> operator()(RemoveAnnotations<AnnotatedArgs>... args) const {
+      return provide(args...);
+    }
+
+    operator FunctionPointer() const {
+      return provide;
+    }
+  };
+
+  using Binding = RegisterProvider<Signature, Functor>;
+};
+
+template <typename Lambda>
+struct PerCpuProviderForLambdaHelper
+    : public PerCpuProviderHelper<meta::UnwrapType<meta::Eval<meta::FunctionSignature(meta::Type<Lambda>)>>, Lambda> {
+};
+
+} // namespace impl
+} // namespace fruit
+
+#endif // FRUIT_PER_CPU_DEFN_H
@@ -0,0 +1,129 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_THREAD_LOCAL_DEFN_H
+#define FRUIT_THREAD_LOCAL_DEFN_H
+
+#include <fruit/impl/bindings.h>
+#include <fruit/impl/meta/component.h>
+#include <fruit/impl/meta_operation_wrappers.h>
+#include <fruit/impl/util/lambda_invoker.h>
+
+// Redundant, but makes KDevelop happy.
+#include <fruit/thread_local.h>
+
+#include <type_traits>
+#include <utility>
+
+namespace fruit {
+
+template <typename T>
+inline ThreadLocal<T>::ThreadLocal(std::function<T*()> create)
+    : slot(new fruit::impl::ThreadLocalSlot([create]() -> void* { return create(); },
+                                            [](void* p) { delete static_cast<T*>(p); })) {}
+
+template <typename T>
+inline T& ThreadLocal<T>::get() {
+  return *static_cast<T*>(slot->get());
+}
+
+template <typename T>
+inline T& ThreadLocal<T>::operator*() {
+  return get();
+}
+
+template <typename T>
+inline T* ThreadLocal<T>::operator->() {
+  return &get();
+}
+
+namespace impl {
+
+// The type used to store a provider argument of type T until the provider is called in some thread.
+template <typename T>
+struct ThreadLocalProviderStoredArg {
+  using type = T;
+};
+
+template <typename T>
+struct ThreadLocalProviderStoredArg<T&> {
+  using type = std::reference_wrapper<T>;
+};
+
+// Wraps AnnotatedT's type in ThreadLocal<>, keeping the annotation (if any).
+template <typename AnnotatedT, typename T>
+struct AnnotatedThreadLocalType {
+  using type = ThreadLocal<T>;
+};
+
+template <typename Annotation, typename AnnotatedT, typename T>
+struct AnnotatedThreadLocalType<fruit::Annotated<Annotation, AnnotatedT>, T> {
+  using type = fruit::Annotated<Annotation, ThreadLocal<T>>;
+};
+
+template <typename AnnotatedT, typename... AnnotatedArgs, typename Lambda>
+struct ThreadLocalProviderHelper<AnnotatedT(AnnotatedArgs...), Lambda> {
+  // The lambda can return either a T or a T* (that will then be owned by the ThreadLocal).
+  using T = typename std::remove_pointer<RemoveAnnotations<AnnotatedT>>::type;
+
+  using Signature = typename AnnotatedThreadLocalType<AnnotatedT, T>::type(AnnotatedArgs...);
+
+  static T* moveToHeap(T&& x) {
+    return new T(std::move(x));
+  }
+
+  static T* moveToHeap(T* x) {
+    return x;
+  }
+
+  // Calls `Lambda' with the stored arguments; it runs once in each thread that uses the ThreadLocal.
+  static std::function<T*()>
+  makeCreateFunction(typename ThreadLocalProviderStoredArg<RemoveAnnotations<AnnotatedArgs>>::type... stored_args) {
+    return [stored_args...]() {
+      return moveToHeap(LambdaInvoker::invoke<Lambda>(static_cast<RemoveAnnotations<AnnotatedArgs>>(stored_args)...));
+    };
+  }
+
+  static ThreadLocal<T> provide(RemoveAnnotations<AnnotatedArgs>... args) {
+    return ThreadLocal<T>(makeCreateFunction(args...));
+  }
+
+  // The provider actually registered in the component. This runs only once per injector, and returns the ThreadLocal
+  // object shared by all threads. Like a captureless lambda, it's convertible to a function pointer.
+  struct Functor {
+    using FunctionPointer = ThreadLocal<T> (*)(RemoveAnnotations<AnnotatedArgs>...);
+
+    ThreadLocal<T> operator()(RemoveAnnotations<AnnotatedArgs>... args) const {
+      return provide(args...);
+    }
+
+    operator FunctionPointer() const {
+      return provide;
+    }
+  };
+
+  using Binding = RegisterProvider<Signature, Functor>;
+};
+
+template <typename Lambda>
+struct ThreadLocalProviderForLambdaHelper
+    : public ThreadLocalProviderHelper<meta::UnwrapType<meta::Eval<meta::FunctionSignature(meta::Type<Lambda>)>>,
+                                       Lambda> {};
+
+} // namespace impl
+} // namespace fruit
+
+#endif // FRUIT_THREAD_LOCAL_DEFN_H
@@ -59,6 +59,11 @@ inline std::size_t hashTuple(const std::tuple<Args...>& x) {
   return HashTupleHelper<std::tuple<Args...>, sizeof...(Args)>()(x);
 }
 
+template <typename... Args>
+inline std::size_t TupleHasher::operator()(const std::tuple<Args...>& x) const {
+  return hashTuple(x);
+}
+
 inline std::size_t combineHashes(std::size_t h1, std::size_t h2) {
   h1 ^= h2 + 0x9e3779b9 + (h1 << 6) + (h1 >> 2);
   return h1;
@@ -27,6 +27,12 @@ std::size_t hashTuple(const std::tuple<Args...>& x);
 
 std::size_t combineHashes(std::size_t h1, std::size_t h2);
 
+// A hasher for std::tuple objects, that uses hashTuple().
+struct TupleHasher {
+  template <typename... Args>
+  std::size_t operator()(const std::tuple<Args...>& x) const;
+};
+
 } // namespace impl
 } // namespace fruit
 
@@ -128,24 +128,41 @@ struct GetTypeInfoForType<fruit::Annotated<Annotation, T>> {
   };
 };
 
+#if FRUIT_HAS_TYPEID && !FRUIT_HAS_CONSTEXPR_TYPEID
+
 template <typename T>
 inline TypeId getTypeId() {
-#if FRUIT_HAS_TYPEID && !FRUIT_HAS_CONSTEXPR_TYPEID
   // We can't use constexpr here because TypeInfo contains a `const std::type_info&` and that's not constexpr with the
   // current compiler/STL.
   static TypeInfo info = GetTypeInfoForType<T>()();
+  return TypeId{&info};
+}
+
 #else
-  // Usual case. The `constexpr' ensures compile-time evaluation.
+
+// Usual case. This is a static data member (instead of a function-local static in getTypeId()) so that getTypeId()
+// can be constexpr.
+template <typename T>
+struct TypeInfoFor {
   static constexpr TypeInfo info = GetTypeInfoForType<T>()();
-#endif
-  return TypeId{&info};
+};
+
+template <typename T>
+constexpr TypeInfo TypeInfoFor<T>::info;
+
+template <typename T>
+inline constexpr TypeId getTypeId() {
+  return TypeId{&TypeInfoFor<T>::info};
 }
 
+#endif
+
 template <typename L>
 struct GetTypeIdsForListHelper;
 
+// The elements of the list are wrapped in Type<>, as in any other metaprogramming Vector.
 template <typename... Ts>
-struct GetTypeIdsForListHelper<fruit::impl::meta::Vector<Ts...>> {
+struct GetTypeIdsForListHelper<fruit::impl::meta::Vector<fruit::impl::meta::Type<Ts>...>> {
   std::vector<TypeId, ArenaAllocator<TypeId>> operator()(MemoryPool& memory_pool) {
     return std::vector<TypeId, ArenaAllocator<TypeId>>(std::initializer_list<TypeId>{getTypeId<Ts>()...}, ArenaAllocator<TypeId>{memory_pool});
   }
@@ -17,6 +17,7 @@
 #ifndef FRUIT_TYPE_INFO_H
 #define FRUIT_TYPE_INFO_H
 
+#include <fruit/impl/fruit-config.h>
 #include <fruit/impl/meta/vector.h>
 #include <fruit/impl/util/demangle_type_name.h>
 #include <typeinfo>
@@ -75,8 +76,9 @@ struct TypeId {
 // Multiple invocations for the same type return the same value.
 // This has special support for types of the form Annotated<SomeAnnotation, SomeType>, it reports
 // data for SomeType (except the name, that is "Annotated<SomeAnnotation, SomeType>").
+// When possible this is constexpr, so that tables of TypeIds (e.g. the ones in BindingDeps) are constant-initialized.
 template <typename T>
-TypeId getTypeId();
+FRUIT_TYPE_ID_CONSTEXPR TypeId getTypeId();
 
 // A convenience function that returns an std::vector of TypeId values for the given meta-vector of types.
 template <typename V>
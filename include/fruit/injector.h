@@ -21,10 +21,16 @@
 #include <fruit/impl/injection_errors.h>
 
 #include <fruit/component.h>
+#include <fruit/eager_injection_progress.h>
+#include <fruit/injector_buffer.h>
+#include <fruit/type_allocation_stats.h>
 #include <fruit/normalized_component.h>
 #include <fruit/provider.h>
 #include <fruit/impl/meta_operation_wrappers.h>
 
+#include <chrono>
+#include <string>
+
 namespace fruit {
 
 /**
@@ -125,6 +131,78 @@ public:
   Injector(NormalizedComponent<NormalizedComponentParams...>&& normalized_component,
            Component<ComponentParams...> (*)(FormalArgs...), Args&&... args) = delete;
 
+  /**
+   * These are equivalent to the constructors above, but they create a single-threaded injector.
+   *
+   * By default, all operations on an injector (and on the Provider objects obtained from it) are synchronized with a
+   * mutex, so that the injector can be shared between threads. A single-threaded injector skips all locking instead, so
+   * it must only be used from the thread that constructed it. This is useful e.g. for injectors that are created to
+   * handle a single request, when the request is handled by a single thread.
+   *
+   * When Fruit is compiled with FRUIT_EXTRA_DEBUG, using a single-threaded injector from a different thread triggers an
+   * assertion failure.
+   *
+   * Example usage:
+   *
+   * Injector<Foo, Bar> injector(fruit::SingleThreaded(), normalizedComponent, getRequestComponent, &request);
+   * Foo* foo = injector.get<Foo*>();
+   */
+  template <typename... FormalArgs, typename... Args>
+  Injector(SingleThreaded, Component<P...> (*)(FormalArgs...), Args&&... args);
+
+  template <typename... NormalizedComponentParams, typename... ComponentParams, typename... FormalArgs,
+            typename... Args>
+  Injector(SingleThreaded, const NormalizedComponent<NormalizedComponentParams...>& normalized_component,
+           Component<ComponentParams...> (*)(FormalArgs...), Args&&... args);
+
+  template <typename... NormalizedComponentParams, typename... ComponentParams, typename... FormalArgs,
+            typename... Args>
+  Injector(SingleThreaded, NormalizedComponent<NormalizedComponentParams...>&& normalized_component,
+           Component<ComponentParams...> (*)(FormalArgs...), Args&&... args) = delete;
+
+  /**
+   * These are equivalent to the constructors above that take a NormalizedComponent, but the injected objects (and the
+   * bookkeeping needed to destroy them) are stored in the caller-provided buffer instead of in a heap-allocated block.
+   * The buffer can be any chunk of memory (no alignment is required), e.g. memory from a per-request arena or an array
+   * on the stack, and must remain valid for the lifetime of the injector.
+   *
+   * Only the injected objects are stored in the buffer: the injector itself and its other data structures (its copy of
+   * the dependency graph and its multibindings) are still heap-allocated, so this saves some heap allocations but not
+   * all of them.
+   *
+   * It's a fatal error to pass a buffer that is too small. The required size depends on the NormalizedComponent and on
+   * the Component, and can be obtained by calling getRequiredBufferSize() on an injector constructed from them (with or
+   * without a buffer).
+   *
+   * Example usage:
+   *
+   * alignas(std::max_align_t) char buffer[4096];
+   * Injector<Foo, Bar> injector(fruit::InjectorBuffer{buffer, sizeof(buffer)}, normalizedComponent,
+   *                             getRequestComponent, &request);
+   * Foo* foo = injector.get<Foo*>();
+   */
+  template <typename... NormalizedComponentParams, typename... ComponentParams, typename... FormalArgs,
+            typename... Args>
+  Injector(InjectorBuffer buffer, const NormalizedComponent<NormalizedComponentParams...>& normalized_component,
+           Component<ComponentParams...> (*)(FormalArgs...), Args&&... args);
+
+  template <typename... NormalizedComponentParams, typename... ComponentParams, typename... FormalArgs,
+            typename... Args>
+  Injector(InjectorBuffer buffer, NormalizedComponent<NormalizedComponentParams...>&& normalized_component,
+           Component<ComponentParams...> (*)(FormalArgs...), Args&&... args) = delete;
+
+  template <typename... NormalizedComponentParams, typename... ComponentParams, typename... FormalArgs,
+            typename... Args>
+  Injector(SingleThreaded, InjectorBuffer buffer,
+           const NormalizedComponent<NormalizedComponentParams...>& normalized_component,
+           Component<ComponentParams...> (*)(FormalArgs...), Args&&... args);
+
+  template <typename... NormalizedComponentParams, typename... ComponentParams, typename... FormalArgs,
+            typename... Args>
+  Injector(SingleThreaded, InjectorBuffer buffer,
+           NormalizedComponent<NormalizedComponentParams...>&& normalized_component,
+           Component<ComponentParams...> (*)(FormalArgs...), Args&&... args) = delete;
+
   /**
    * Returns an instance of the specified type. For any class C in the Injector's template parameters, the following
    * variations are allowed:
@@ -219,7 +297,130 @@ public:
    */
   FRUIT_DEPRECATED_DECLARATION(void eagerlyInjectAll());
 
+  /**
+   * Performs part of the injections that eagerlyInjectAll() would perform, stopping once `time_budget' has elapsed.
+   * This is meant for single-threaded event loops that can't block for the whole eagerlyInjectAll(): call this
+   * repeatedly (e.g. once per loop iteration) until the returned progress isDone().
+   *
+   * The eager injection is split into steps: first one step for each type in P (in order), then one step for each
+   * multibinding set (sorted by type name). Each step injects everything needed by that type (that wasn't injected
+   * already) in dependency order, one object at a time, so the objects are always constructed in the same order; only
+   * the points where the construction is interrupted depend on timing. A call can stop in the middle of a step.
+   *
+   * The deadline is checked before constructing each object, so a call can exceed `time_budget' by the duration of
+   * a single constructor/provider (excluding the ones of its dependencies). Each call constructs at least one object
+   * (unless all steps are completed), so that repeated calls always make progress even with a zero time budget.
+   *
+   * Calling get() (or other methods) on this injector between calls is allowed; it just makes the corresponding steps
+   * faster.
+   */
+  template <typename Rep, typename Period>
+  EagerInjectionProgress eagerlyInjectSome(std::chrono::duration<Rep, Period> time_budget);
+
+  /**
+   * Makes this injector destroy the injected objects concurrently (using up to num_threads threads, including the one
+   * destroying the injector), instead of destroying them one at a time in reverse order of construction.
+   * This is useful when some destructors are slow (e.g. because they flush buffers or join threads).
+   *
+   * Each object is still destroyed before all objects that were injected into it (directly or through a Provider) and
+   * before all objects that were constructed by an earlier call to get() (on this injector or on a Provider).
+   * Objects whose destruction is not ordered by these rules might be destroyed concurrently, so their destructors must
+   * be safe to run concurrently.
+   *
+   * This must be called before getting any object from this injector, otherwise a fatal error is reported.
+   */
+  void enableConcurrentDestruction(std::size_t num_threads);
+
+  /**
+   * Makes this injector measure the heap memory allocated while constructing each injected object, so that the types
+   * whose construction allocates the most memory can be found with getTopAllocatingTypes().
+   *
+   * Fruit doesn't intercept allocations itself: get_allocated_bytes must return the total number of bytes allocated
+   * so far by the current thread (or by the process, if objects are never injected concurrently with other
+   * allocations), e.g. using a malloc hook or the statistics of the memory allocator. The result must never decrease.
+   *
+   * The memory allocated while constructing the dependencies of an object (including those obtained through a
+   * Provider during the construction) is only attributed to the dependencies. Objects stored in the injector's
+   * own memory (see getRequiredBufferSize()) are not heap-allocated individually, so only the memory allocated by their
+   * constructors/providers is counted.
+   *
+   * Only the objects constructed after this call are tracked. This can be called at most once on each injector.
+   */
+  void enableAllocationTracking(std::size_t (*get_allocated_bytes)());
+
+  /**
+   * Returns the (at most max_num_types) types whose construction allocated the most memory since
+   * enableAllocationTracking() was called, sorted by decreasing number of bytes. Types that didn't allocate memory
+   * (or that weren't constructed) are not included. The multibindings for a type are reported as a single element,
+   * separate from the (non-multi)binding for that type.
+   *
+   * This is meant for diagnostics; it's relatively slow since it looks at all bindings in the injector.
+   * It's a fatal error to call this if enableAllocationTracking() wasn't called.
+   */
+  std::vector<TypeAllocationStats> getTopAllocatingTypes(std::size_t max_num_types);
+
+  /**
+   * Makes this injector publish its stats in the POSIX shared memory segment `segment_name' (e.g.
+   * "/my_server_fruit_stats"), so that they can be monitored from another process on the same host (e.g. with the
+   * fruit_stats_reader tool in extras/stats_reader) without taking any lock in this process.
+   *
+   * The segment has a fixed layout (see fruit/impl/injector/injector_stats_segment.h) with:
+   * - the number of objects constructed so far;
+   * - the number of acquisitions of the injector's lock, how many of them had to wait and the total wait time;
+   * - how much of the injector's memory block for the injected objects (see getRequiredBufferSize()) is used;
+   * - for each binding (and for the multibindings of each type) the number of objects constructed and the time spent
+   *   constructing them, excluding the time spent constructing their dependencies.
+   * The counters are updated with relaxed atomic operations, so readers might see a slightly out-of-date snapshot.
+   *
+   * It's a fatal error if a segment with the same name already exists (e.g. because it's used by another injector, or
+   * it was left behind by a process that crashed). The segment is removed when the injector is destroyed.
+   * Only the objects constructed after this call are counted. This can be called at most once on each injector, and
+   * it must be called before the injector is used by other threads.
+   * It's a fatal error to call this on platforms without POSIX shared memory, or if the segment can't be created.
+   */
+  void enableStatsExport(const std::string& segment_name);
+
+  /**
+   * Returns the size of the buffer that an injector constructed from the same NormalizedComponent and Component (or
+   * from the same Component, if this injector wasn't constructed from a NormalizedComponent) needs to store the
+   * injected objects in a caller-provided buffer. See the constructors that take an InjectorBuffer.
+   */
+  std::size_t getRequiredBufferSize();
+
+  /**
+   * Releases the data structures that this injector only needs to construct objects, keeping only the injected objects
+   * (and what's needed to destroy them), the lookup of the types in P and the vectors returned by getMultibindings().
+   * This is meant for long-lived injectors: once everything they expose has been constructed, most of their memory is
+   * used by the bindings and the dependency graph, that are no longer needed.
+   *
+   * This first injects all the types in P and all multibindings (as eagerlyInjectAll() would), so it can be called at
+   * any time. Afterwards:
+   * - get() and getMultibindings() work as before (and never construct anything);
+   * - Providers that were obtained before this call (e.g. the ones injected in the objects of this injector) can only
+   *   be used to get objects that were already constructed; using them to get any other object is a fatal error. So
+   *   the objects that are only obtained lazily through a Provider must be constructed before calling this.
+   *
+   * Calling this again has no effect. It's a fatal error to call this on an injector with generation tracking enabled
+   * (see GenerationalInjector), or to call getTopAllocatingTypes() after this.
+   */
+  void compact();
+
 private:
+  // The constructors above delegate to these ones.
+  template <typename... FormalArgs, typename... Args>
+  Injector(fruit::impl::InjectorStorage::ThreadingPolicy threading_policy, Component<P...> (*)(FormalArgs...),
+           Args&&... args);
+
+  template <typename... NormalizedComponentParams, typename... ComponentParams, typename... FormalArgs,
+            typename... Args>
+  Injector(fruit::impl::InjectorStorage::ThreadingPolicy threading_policy, InjectorBuffer buffer,
+           const NormalizedComponent<NormalizedComponentParams...>& normalized_component,
+           Component<ComponentParams...> (*)(FormalArgs...), Args&&... args);
+
+  // Used in compact(): injects AnnotatedC (one of the types in P) in `storage'.
+  template <typename AnnotatedC>
+  static void eagerlyInjectType(fruit::impl::InjectorStorage& storage);
+
   using Check1 = typename fruit::impl::meta::CheckIfError<fruit::impl::meta::Eval<
       fruit::impl::meta::CheckNoRequiredTypesInInjectorArguments(fruit::impl::meta::Type<P>...)>>::type;
   // Force instantiation of Check1.
@@ -241,6 +442,9 @@ private:
 
   friend struct fruit::impl::InjectorAccessorForTests;
 
+  template <typename... Types>
+  friend class GenerationalInjector;
+
   std::unique_ptr<fruit::impl::InjectorStorage> storage;
 };
 
@@ -0,0 +1,36 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_INJECTOR_BUFFER_H
+#define FRUIT_INJECTOR_BUFFER_H
+
+#include <cstddef>
+
+namespace fruit {
+
+/**
+ * A caller-provided memory buffer that can be passed to the constructors of Injector that take a NormalizedComponent,
+ * to store the injected objects in it instead of in a heap-allocated block. It must be at least as big as
+ * Injector::getRequiredBufferSize(). See Injector for details.
+ */
+struct InjectorBuffer {
+  void* data;
+  std::size_t size;
+};
+
+} // namespace fruit
+
+#endif // FRUIT_INJECTOR_BUFFER_H
@@ -113,6 +113,36 @@ public:
   template <typename... FormalArgs, typename... Args>
   explicit NormalizedComponent(Component<Params...> (*)(FormalArgs...), Args&&... args);
 
+  /**
+   * Creates a slice of another NormalizedComponent: a NormalizedComponent with only the bindings of `parent' that are
+   * reachable from the types provided by this NormalizedComponent (i.e. the types in Params that are not in a
+   * Required<...>). Injectors created from the slice are smaller and faster to create than the ones created from
+   * `parent', so this is useful when different kinds of injectors only need different parts of a large
+   * NormalizedComponent. For example:
+   *
+   * fruit::NormalizedComponent<fruit::Required<Request>, FooHandler, BarHandler> normalized_component(
+   *     getHandlersComponent);
+   * fruit::NormalizedComponent<fruit::Required<Request>, FooHandler> foo_normalized_component(normalized_component);
+   *
+   * ...
+   * fruit::Injector<FooHandler> injector(foo_normalized_component, getRequestComponent, &request);
+   *
+   * This reuses the bindings already normalized in `parent' (component functions are not called again), and it's
+   * cheaper than constructing `parent'. The types provided by this NormalizedComponent must be provided by `parent',
+   * and the types required by `parent' must also be required by this NormalizedComponent.
+   *
+   * Differences from using `parent' directly:
+   * - Multibindings are not kept (they're not reachable from any type), so injectors created from the slice only have
+   *   the multibindings of the component passed to the Injector constructor.
+   * - Unless the slice keeps all the bindings and multibindings of `parent', the components installed in `parent' are
+   *   expanded again if the component passed to the Injector constructor installs them (while with `parent' they'd be
+   *   skipped). In that case the slice also doesn't perform binding compression.
+   *
+   * `parent' can be destroyed before this object. Like any other NormalizedComponent, the slice can be sliced further.
+   */
+  template <typename... ParentParams>
+  explicit NormalizedComponent(const NormalizedComponent<ParentParams...>& parent);
+
   NormalizedComponent(NormalizedComponent&& storage) noexcept : storage(std::move(storage.storage)) {}
   NormalizedComponent(const NormalizedComponent&) = delete;
 
@@ -122,6 +152,10 @@ public:
 private:
   NormalizedComponent(fruit::impl::ComponentStorage&& storage, fruit::impl::MemoryPool memory_pool);
 
+  // Creates a slice of parent_storage with only the bindings reachable from the types provided by this component.
+  NormalizedComponent(const fruit::impl::NormalizedComponentStorageHolder& parent_storage,
+                      fruit::impl::MemoryPool memory_pool);
+
   // This is held via a unique_ptr to avoid including normalized_component_storage.h
   // in fruit.h.
   fruit::impl::NormalizedComponentStorageHolder storage;
@@ -129,6 +163,9 @@ private:
   template <typename... OtherParams>
   friend class Injector;
 
+  template <typename... OtherParams>
+  friend class NormalizedComponent;
+
   using Comp = fruit::impl::meta::Eval<fruit::impl::meta::ConstructComponentImpl(fruit::impl::meta::Type<Params>...)>;
 
   using Check1 = typename fruit::impl::meta::CheckIfError<Comp>::type;
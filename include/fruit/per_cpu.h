@@ -0,0 +1,119 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_PER_CPU_H
+#define FRUIT_PER_CPU_H
+
+#include <fruit/fruit_forward_decls.h>
+#include <fruit/impl/injector/per_cpu_shards.h>
+
+#include <cstddef>
+#include <memory>
+
+namespace fruit {
+
+/**
+ * A PerCpu<T> holds a separate instance of T for each CPU, each in its own cache lines. get() returns the instance for
+ * the CPU that the calling thread is currently running on, so threads running on different CPUs (mostly) use different
+ * instances and don't contend on the same cache lines.
+ *
+ * This is useful for data that's updated very frequently by many threads and read rarely, e.g. counters or free lists:
+ * each thread updates the instance of its CPU, and readers aggregate the values of all instances using forEachShard().
+ *
+ * PerCpu<T> objects are usually injected from a binding registered with PartialComponent::registerPerCpuProvider(),
+ * for example:
+ *
+ * fruit::Component<RequestCounter> getRequestCounterComponent() {
+ *   return fruit::createComponent()
+ *       .registerPerCpuProvider([]() { return std::atomic<long>(0); });
+ * }
+ *
+ * class RequestCounter {
+ * public:
+ *   INJECT(RequestCounter(PerCpu<std::atomic<long>>* counts)) : counts(counts) {}
+ *
+ *   void increment() {
+ *     counts->get().fetch_add(1, std::memory_order_relaxed);
+ *   }
+ *
+ *   long total() {
+ *     long result = 0;
+ *     counts->forEachShard([&](std::atomic<long>& count) { result += count.load(std::memory_order_relaxed); });
+ *     return result;
+ *   }
+ *
+ * private:
+ *   PerCpu<std::atomic<long>>* counts;
+ * };
+ *
+ * Unlike ThreadLocal<T>, a PerCpu<T> doesn't give exclusive access to an instance: a thread can be migrated to another
+ * CPU at any time (even right after get() returns) and multiple threads can run on the same CPU one after the other,
+ * so T must still be safe to use concurrently (e.g. with atomic operations, or with a mutex that will be uncontended
+ * most of the time).
+ *
+ * All the instances are constructed when the PerCpu object is constructed, and destroyed with it (e.g. together with
+ * the injector that contains it). Each instance is constructed in place from the result of the provider, so T doesn't
+ * need to be movable. However, before C++17 a lambda can't return a non-movable T by value, so the example above
+ * (std::atomic<long> isn't movable) requires C++17; with C++11 and C++14, T must be MoveConstructible.
+ */
+template <typename T>
+class PerCpu {
+public:
+  /**
+   * Constructs a PerCpu that calls `create()' once for each CPU, constructing each instance in place as T(create()).
+   */
+  template <typename F>
+  explicit PerCpu(F create);
+
+  PerCpu(PerCpu&&) = default;
+  PerCpu& operator=(PerCpu&&) = default;
+
+  /**
+   * Returns the instance for the CPU that the calling thread is running on.
+   */
+  T& get();
+
+  /**
+   * These are equivalent to get(), they're provided for convenience.
+   */
+  T& operator*();
+  T* operator->();
+
+  /**
+   * The number of instances, i.e. the number of CPUs that the process might run on.
+   */
+  std::size_t numShards() const;
+
+  /**
+   * Returns the index-th instance. `index' must be less than numShards().
+   */
+  T& getShard(std::size_t index);
+
+  /**
+   * Calls f(instance) for each instance (of all CPUs), e.g. to aggregate per-CPU counters.
+   */
+  template <typename F>
+  void forEachShard(F f);
+
+private:
+  std::unique_ptr<fruit::impl::PerCpuShards> shards;
+};
+
+} // namespace fruit
+
+#include <fruit/impl/per_cpu.defn.h>
+
+#endif // FRUIT_PER_CPU_H
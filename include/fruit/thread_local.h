@@ -0,0 +1,85 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_THREAD_LOCAL_H
+#define FRUIT_THREAD_LOCAL_H
+
+#include <fruit/fruit_forward_decls.h>
+#include <fruit/impl/injector/thread_local_slot.h>
+
+#include <functional>
+#include <memory>
+
+namespace fruit {
+
+/**
+ * A ThreadLocal<T> holds a separate instance of T for each thread that calls get().
+ *
+ * The instance for a thread is constructed the first time that thread calls get(), and it's destroyed when the thread
+ * exits or when the ThreadLocal object is destroyed (e.g. together with the injector that contains it), whichever
+ * comes first. After the first call in a thread, get() doesn't take any lock.
+ *
+ * ThreadLocal<T> objects are usually injected from a binding registered with
+ * PartialComponent::registerThreadLocalProvider(), for example:
+ *
+ * class Worker {
+ * public:
+ *   INJECT(Worker(ThreadLocal<Parser>* parser)) : parser(parser) {}
+ *
+ *   void run(const std::string& s) {
+ *     // Each thread that calls run() uses its own Parser.
+ *     parser->get().parse(s);
+ *   }
+ *
+ * private:
+ *   ThreadLocal<Parser>* parser;
+ * };
+ *
+ * Note that the ThreadLocal object itself is shared by all threads (like any other injected object); only the T
+ * instances are per-thread.
+ */
+template <typename T>
+class ThreadLocal {
+public:
+  /**
+   * Constructs a ThreadLocal that will call `create' (in the calling thread) to construct the instance for each thread.
+   * `create' must return a pointer to a heap-allocated T, the ThreadLocal takes ownership of it.
+   */
+  explicit ThreadLocal(std::function<T*()> create);
+
+  ThreadLocal(ThreadLocal&&) = default;
+  ThreadLocal& operator=(ThreadLocal&&) = default;
+
+  /**
+   * Returns the instance for the calling thread, constructing it if this is the first call in this thread.
+   */
+  T& get();
+
+  /**
+   * These are equivalent to get(), they're provided for convenience.
+   */
+  T& operator*();
+  T* operator->();
+
+private:
+  std::unique_ptr<fruit::impl::ThreadLocalSlot> slot;
+};
+
+} // namespace fruit
+
+#include <fruit/impl/thread_local.defn.h>
+
+#endif // FRUIT_THREAD_LOCAL_H
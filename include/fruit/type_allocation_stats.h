@@ -0,0 +1,42 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_TYPE_ALLOCATION_STATS_H
+#define FRUIT_TYPE_ALLOCATION_STATS_H
+
+#include <cstddef>
+#include <string>
+
+namespace fruit {
+
+/**
+ * An element of the result of Injector::getTopAllocatingTypes(): the heap memory allocated while constructing the
+ * objects of a type, excluding the memory allocated while constructing their dependencies.
+ */
+struct TypeAllocationStats {
+  // The name of the type, as returned by std::type_info::name() (demangled if possible).
+  std::string type_name;
+
+  // True if these are the allocations of the multibindings for this type, false for the (non-multi)binding.
+  bool is_multibinding;
+
+  // The number of bytes allocated, as reported by the function passed to Injector::enableAllocationTracking().
+  std::size_t num_bytes;
+};
+
+} // namespace fruit
+
+#endif // FRUIT_TYPE_ALLOCATION_STATS_H
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define IN_FRUIT_CPP_FILE 1
+
+#include <fruit/impl/injector/allocation_tracker.h>
+
+#include <fruit/impl/fruit_assert.h>
+
+namespace fruit {
+namespace impl {
+
+AllocationTracker::AllocationTracker(get_allocated_bytes_t get_allocated_bytes)
+    : get_allocated_bytes(get_allocated_bytes) {}
+
+void AllocationTracker::beginConstruction() {
+  std::size_t allocated_bytes_before_push = get_allocated_bytes();
+  construction_stack.push_back(Frame{0, 0});
+  std::size_t allocated_bytes = get_allocated_bytes();
+  if (construction_stack.size() > 1) {
+    // The push_back() above might have allocated memory, but that's not part of the outer construction.
+    construction_stack[construction_stack.size() - 2].excluded_bytes += allocated_bytes - allocated_bytes_before_push;
+  }
+  construction_stack.back().allocated_bytes_at_begin = allocated_bytes;
+}
+
+void AllocationTracker::endConstruction(const void* key) {
+  FruitAssert(!construction_stack.empty());
+  std::size_t allocated_bytes = get_allocated_bytes();
+  Frame frame = construction_stack.back();
+  construction_stack.pop_back();
+  allocated_bytes_by_key[key] += allocated_bytes - frame.allocated_bytes_at_begin - frame.excluded_bytes;
+  if (!construction_stack.empty()) {
+    // This also excludes the memory allocated by the insertion in allocated_bytes_by_key above.
+    construction_stack.back().excluded_bytes += get_allocated_bytes() - frame.allocated_bytes_at_begin;
+  }
+}
+
+void AllocationTracker::abortConstruction() {
+  FruitAssert(!construction_stack.empty());
+  Frame frame = construction_stack.back();
+  construction_stack.pop_back();
+  if (!construction_stack.empty()) {
+    construction_stack.back().excluded_bytes += get_allocated_bytes() - frame.allocated_bytes_at_begin;
+  }
+}
+
+void AllocationTracker::pauseCounting() {
+  allocated_bytes_at_pause = get_allocated_bytes();
+}
+
+void AllocationTracker::resumeCounting() {
+  if (!construction_stack.empty()) {
+    construction_stack.back().excluded_bytes += get_allocated_bytes() - allocated_bytes_at_pause;
+  }
+}
+
+const std::unordered_map<const void*, std::size_t>& AllocationTracker::getAllocatedBytesByKey() const {
+  return allocated_bytes_by_key;
+}
+
+} // namespace impl
+} // namespace fruit
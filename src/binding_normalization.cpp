@@ -240,6 +240,7 @@ void BindingNormalization::addMultibindings(std::unordered_map<TypeId, Normalize
       NormalizedMultibinding normalized_multibinding;
       normalized_multibinding.is_constructed = true;
       normalized_multibinding.object = i->first.multibinding_for_constructed_object.object_ptr;
+      normalized_multibinding.deps = nullptr;
       b.elems.push_back(normalized_multibinding);
     } break;
 
@@ -248,6 +249,7 @@ void BindingNormalization::addMultibindings(std::unordered_map<TypeId, Normalize
       NormalizedMultibinding normalized_multibinding;
       normalized_multibinding.is_constructed = false;
       normalized_multibinding.create = i->first.multibinding_for_object_to_construct.create;
+      normalized_multibinding.deps = i->first.multibinding_for_object_to_construct.deps;
       b.elems.push_back(normalized_multibinding);
     } break;
 
@@ -256,6 +258,7 @@ void BindingNormalization::addMultibindings(std::unordered_map<TypeId, Normalize
       NormalizedMultibinding normalized_multibinding;
       normalized_multibinding.is_constructed = false;
       normalized_multibinding.create = i->first.multibinding_for_object_to_construct.create;
+      normalized_multibinding.deps = i->first.multibinding_for_object_to_construct.deps;
       b.elems.push_back(normalized_multibinding);
     } break;
 
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define IN_FRUIT_CPP_FILE 1
+
+#include <fruit/impl/component_storage/component_storage.h>
+
+#include <fruit/impl/component_storage/component_storage_entry.h>
+#include <fruit/impl/fruit_assert.h>
+
+#include <utility>
+
+namespace fruit {
+namespace impl {
+
+namespace {
+
+struct EntryRecyclingData {
+  // The number of EntryRecyclingScope objects alive in this thread.
+  std::size_t num_scopes = 0;
+
+  // An empty vector, kept for the next call to allocateEntries().
+  FixedSizeVector<ComponentStorageEntry> spare_entries;
+};
+
+thread_local EntryRecyclingData entry_recycling_data;
+
+} // namespace
+
+ComponentStorage::EntryRecyclingScope::EntryRecyclingScope() {
+  ++entry_recycling_data.num_scopes;
+}
+
+ComponentStorage::EntryRecyclingScope::~EntryRecyclingScope() {
+  FruitAssert(entry_recycling_data.num_scopes != 0);
+  if (--entry_recycling_data.num_scopes == 0) {
+    entry_recycling_data.spare_entries = FixedSizeVector<ComponentStorageEntry>();
+  }
+}
+
+FixedSizeVector<ComponentStorageEntry> ComponentStorage::allocateEntries(std::size_t num_entries) {
+  EntryRecyclingData& data = entry_recycling_data;
+  if (data.num_scopes != 0 && num_entries <= data.spare_entries.getCapacity()) {
+    return std::move(data.spare_entries);
+  }
+  return FixedSizeVector<ComponentStorageEntry>(num_entries);
+}
+
+void ComponentStorage::recycleEntries(FixedSizeVector<ComponentStorageEntry>&& entries) {
+  EntryRecyclingData& data = entry_recycling_data;
+  // Only the largest vector is kept, so that all components can eventually reuse it.
+  if (data.num_scopes != 0 && entries.getCapacity() > data.spare_entries.getCapacity()) {
+    entries.clear();
+    data.spare_entries = std::move(entries);
+  }
+}
+
+} // namespace impl
+} // namespace fruit
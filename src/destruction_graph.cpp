@@ -0,0 +1,148 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define IN_FRUIT_CPP_FILE 1
+
+#include <fruit/impl/injector/destruction_graph.h>
+
+#include <fruit/impl/fruit_assert.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace fruit {
+namespace impl {
+
+constexpr std::size_t DestructionGraph::no_node;
+
+DestructionGraph::DestructionGraph(std::size_t num_threads) : num_threads(num_threads) {}
+
+void DestructionGraph::beginConstruction() {
+  construction_stack.emplace_back();
+  if (last_toplevel_node != no_node) {
+    construction_stack.back().push_back(last_toplevel_node);
+  }
+}
+
+void DestructionGraph::endConstruction(const void* key, std::size_t num_objects_to_destroy) {
+  FruitAssert(!construction_stack.empty());
+  FruitAssert(num_objects_to_destroy >= num_claimed_objects);
+
+  std::size_t node_index = nodes.size();
+  // The objects registered by the dependencies constructed here have already been claimed by their own nodes, so any
+  // object that is still unclaimed was registered by this construction.
+  nodes.push_back(Node{num_claimed_objects, num_objects_to_destroy, std::move(construction_stack.back())});
+  num_claimed_objects = num_objects_to_destroy;
+  construction_stack.pop_back();
+
+  node_index_by_key[key] = node_index;
+
+  if (construction_stack.empty()) {
+    last_toplevel_node = node_index;
+  } else {
+    construction_stack.back().push_back(node_index);
+  }
+}
+
+void DestructionGraph::abortConstruction() {
+  FruitAssert(!construction_stack.empty());
+  construction_stack.pop_back();
+}
+
+void DestructionGraph::addDependency(const void* key) {
+  if (construction_stack.empty()) {
+    return;
+  }
+  auto itr = node_index_by_key.find(key);
+  if (itr != node_index_by_key.end()) {
+    construction_stack.back().push_back(itr->second);
+  }
+}
+
+void DestructionGraph::destroyObjects(FixedSizeAllocator& allocator) {
+  FruitAssert(construction_stack.empty());
+
+  // Objects not owned by any node (if any) were registered last, so we destroy them first, in reverse order.
+  for (std::size_t i = allocator.numObjectsToDestroy(); i > num_claimed_objects; --i) {
+    allocator.destroyObjectAt(i - 1);
+  }
+
+  // num_dependents[i] is the number of nodes that depend on nodes[i] and that haven't been destroyed yet.
+  // Duplicate edges are counted multiple times, that's fine since they're also removed multiple times.
+  std::vector<std::size_t> num_dependents(nodes.size(), 0);
+  for (const Node& node : nodes) {
+    for (std::size_t dependency : node.dependencies) {
+      ++num_dependents[dependency];
+    }
+  }
+
+  // The nodes that can be destroyed right away. Since nodes are appended after their dependencies, popping from the
+  // back destroys the objects in reverse construction order when num_threads==1.
+  std::vector<std::size_t> ready_nodes;
+  for (std::size_t i = 0; i < nodes.size(); ++i) {
+    if (num_dependents[i] == 0) {
+      ready_nodes.push_back(i);
+    }
+  }
+
+  std::mutex mutex;
+  std::condition_variable condition_variable;
+  std::size_t num_destroyed_nodes = 0;
+
+  auto worker = [&]() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+      condition_variable.wait(lock, [&]() { return !ready_nodes.empty() || num_destroyed_nodes == nodes.size(); });
+      if (ready_nodes.empty()) {
+        // All nodes have been destroyed.
+        return;
+      }
+      std::size_t node_index = ready_nodes.back();
+      ready_nodes.pop_back();
+      const Node& node = nodes[node_index];
+
+      lock.unlock();
+      for (std::size_t i = node.objects_end; i > node.objects_begin; --i) {
+        allocator.destroyObjectAt(i - 1);
+      }
+      lock.lock();
+
+      ++num_destroyed_nodes;
+      for (std::size_t dependency : node.dependencies) {
+        --num_dependents[dependency];
+        if (num_dependents[dependency] == 0) {
+          ready_nodes.push_back(dependency);
+        }
+      }
+      condition_variable.notify_all();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < num_threads && i < nodes.size(); ++i) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  allocator.clearObjectsToDestroy();
+}
+
+} // namespace impl
+} // namespace fruit
@@ -17,19 +17,30 @@
 #define IN_FRUIT_CPP_FILE 1
 
 #include <fruit/impl/data_structures/fixed_size_allocator.h>
-#include <fruit/impl/data_structures/fixed_size_vector.templates.h>
 
 namespace fruit {
 namespace impl {
 
 FixedSizeAllocator::~FixedSizeAllocator() {
   // Destroy all objects in reverse order.
-  std::pair<destroy_t, void*>* p = on_destruction.end();
-  while (p != on_destruction.begin()) {
+  std::pair<destroy_t, void*>* p = on_destruction_end;
+  while (p != on_destruction_begin) {
     --p;
     p->first(p->second);
   }
-  delete[] storage_begin;
+  if (owns_storage) {
+    delete[] storage_begin;
+  }
+}
+
+void FixedSizeAllocator::destroyNothing(void*) {}
+
+std::shared_ptr<char> FixedSizeAllocator::shareStorage() {
+  if (owns_storage) {
+    shared_storage = std::shared_ptr<char>(storage_begin, std::default_delete<char[]>());
+    owns_storage = false;
+  }
+  return shared_storage;
 }
 
 } // namespace impl
@@ -0,0 +1,98 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define IN_FRUIT_CPP_FILE 1
+
+#include <fruit/impl/injector/generation_tracker.h>
+
+#include <fruit/impl/fruit_assert.h>
+
+#include <utility>
+
+namespace fruit {
+namespace impl {
+
+ReusedObject::~ReusedObject() {
+  for (std::size_t i = objects_to_destroy.size(); i > 0; --i) {
+    objects_to_destroy[i - 1].first(objects_to_destroy[i - 1].second);
+  }
+}
+
+void GenerationTracker::beginConstruction() {
+  construction_stack.push_back(ConstructedBinding{nullptr, std::vector<const void*>(), 0, 0, true, nullptr});
+}
+
+void GenerationTracker::addDependency(const void* key) {
+  if (!construction_stack.empty()) {
+    construction_stack.back().deps.push_back(key);
+  }
+}
+
+void GenerationTracker::markNotReusable() {
+  if (!construction_stack.empty()) {
+    construction_stack.back().is_reusable = false;
+  }
+}
+
+void GenerationTracker::endConstruction(const void* key, create_t create, std::size_t num_objects_to_destroy) {
+  FruitAssert(!construction_stack.empty());
+  FruitAssert(num_objects_to_destroy >= num_claimed_objects);
+  ConstructedBinding binding = std::move(construction_stack.back());
+  construction_stack.pop_back();
+  binding.create = create;
+  // The objects registered by the dependencies constructed here have already been claimed by their own bindings, so
+  // any object that is still unclaimed was registered by this construction.
+  binding.objects_begin = num_claimed_objects;
+  binding.objects_end = num_objects_to_destroy;
+  num_claimed_objects = num_objects_to_destroy;
+  constructed_bindings[key] = std::move(binding);
+  addDependency(key);
+}
+
+void GenerationTracker::endMultibindingConstruction(std::size_t num_objects_to_destroy) {
+  FruitAssert(!construction_stack.empty());
+  construction_stack.pop_back();
+  // The multibinding owns these objects, so they must not be considered part of the enclosing construction (if any).
+  num_claimed_objects = num_objects_to_destroy;
+}
+
+void GenerationTracker::abortConstruction() {
+  FruitAssert(!construction_stack.empty());
+  construction_stack.pop_back();
+}
+
+void GenerationTracker::addReusedBinding(const void* key, ConstructedBinding binding) {
+  constructed_bindings[key] = std::move(binding);
+}
+
+GenerationTracker::ConstructedBinding* GenerationTracker::find(const void* key) {
+  auto itr = constructed_bindings.find(key);
+  if (itr == constructed_bindings.end()) {
+    return nullptr;
+  }
+  return &itr->second;
+}
+
+const GenerationTracker::ConstructedBinding* GenerationTracker::find(const void* key) const {
+  auto itr = constructed_bindings.find(key);
+  if (itr == constructed_bindings.end()) {
+    return nullptr;
+  }
+  return &itr->second;
+}
+
+} // namespace impl
+} // namespace fruit
@@ -0,0 +1,123 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#define IN_FRUIT_CPP_FILE 1
+
+#include <fruit/impl/data_structures/hazard_pointers.h>
+
+#include <cstdint>
+#include <mutex>
+#include <new>
+
+namespace fruit {
+namespace impl {
+
+constexpr std::size_t HazardPointers::num_pointers_per_thread;
+
+namespace {
+
+constexpr std::size_t cache_line_size = 64;
+
+struct alignas(cache_line_size) HazardRecord {
+  std::atomic<const void*> pointers[HazardPointers::num_pointers_per_thread];
+
+  // False if no thread owns this record, so that it can be reused. Protected by HazardRegistry::mutex.
+  bool in_use = true;
+
+  // The next record in HazardRegistry::records. Only written before this record is published.
+  HazardRecord* next = nullptr;
+
+  HazardRecord() {
+    for (std::atomic<const void*>& pointer : pointers) {
+      pointer.store(nullptr);
+    }
+  }
+};
+
+struct HazardRegistry {
+  // Only used to add, claim and release records, and by getProtectedPointers().
+  std::mutex mutex;
+
+  // A record for each thread that ever read (records of exited threads are reused). They're never deleted.
+  HazardRecord* records = nullptr;
+};
+
+// This is never destroyed, since threads might still use it while static objects are being destroyed.
+HazardRegistry& getHazardRegistry() {
+  static HazardRegistry* registry = new HazardRegistry();
+  return *registry;
+}
+
+HazardRecord* acquireHazardRecord() {
+  HazardRegistry& registry = getHazardRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  for (HazardRecord* record = registry.records; record != nullptr; record = record->next) {
+    if (!record->in_use) {
+      record->in_use = true;
+      return record;
+    }
+  }
+  // HazardRecord is over-aligned, and operator new only guarantees alignof(std::max_align_t) before C++17.
+  char* memory = new char[sizeof(HazardRecord) + cache_line_size - 1];
+  void* aligned_memory =
+      memory + (cache_line_size - reinterpret_cast<std::uintptr_t>(memory) % cache_line_size) % cache_line_size;
+  HazardRecord* record = new (aligned_memory) HazardRecord();
+  record->next = registry.records;
+  registry.records = record;
+  return record;
+}
+
+// Releases the record of a thread when it exits.
+struct ThreadHazardRecord {
+  HazardRecord* record = nullptr;
+
+  ~ThreadHazardRecord() {
+    if (record != nullptr) {
+      std::lock_guard<std::mutex> lock(getHazardRegistry().mutex);
+      record->in_use = false;
+    }
+  }
+};
+
+thread_local ThreadHazardRecord thread_hazard_record;
+
+} // namespace
+
+std::atomic<const void*>* HazardPointers::getThreadPointers() {
+  HazardRecord* record = thread_hazard_record.record;
+  if (record == nullptr) {
+    record = acquireHazardRecord();
+    thread_hazard_record.record = record;
+  }
+  return record->pointers;
+}
+
+void HazardPointers::getProtectedPointers(std::vector<const void*>& result) {
+  HazardRegistry& registry = getHazardRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  for (HazardRecord* record = registry.records; record != nullptr; record = record->next) {
+    for (std::atomic<const void*>& pointer : record->pointers) {
+      const void* p = pointer.load();
+      if (p != nullptr) {
+        result.push_back(p);
+      }
+    }
+  }
+}
+
+} // namespace impl
+} // namespace fruit
@@ -0,0 +1,179 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define IN_FRUIT_CPP_FILE 1
+
+#include <fruit/impl/injector/injector_stats_exporter.h>
+
+#include <fruit/impl/fruit_assert.h>
+#include <fruit/impl/injector/injector_storage.h>
+
+#include <cerrno>
+#include <cstring>
+#include <new>
+
+#if FRUIT_HAS_POSIX_SHARED_MEMORY
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fruit {
+namespace impl {
+
+constexpr std::uint64_t InjectorStatsSegment::magic_value;
+constexpr std::uint32_t InjectorStatsSegment::current_version;
+constexpr std::size_t InjectorStatsSegment::type_name_size;
+
+namespace {
+
+// All counters are only written by the thread that holds the injector's lock, so there's no need for an atomic
+// read-modify-write.
+void addRelaxed(std::atomic<std::uint64_t>& counter, std::uint64_t n) {
+  counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+} // namespace
+
+InjectorStatsExporter::InjectorStatsExporter(const std::string& segment_name,
+                                             const std::vector<BindingSlotInfo>& binding_slot_infos,
+                                             std::unordered_map<const void*, std::size_t> slot_index_by_key,
+                                             std::size_t arena_used_bytes, std::size_t arena_capacity_bytes)
+    : segment_name(segment_name), segment_size(InjectorStatsSegment::getSegmentSize(binding_slot_infos.size())),
+      header(nullptr), binding_slots(nullptr), slot_index_by_key(std::move(slot_index_by_key)) {
+#if FRUIT_HAS_POSIX_SHARED_MEMORY
+  if (!std::atomic<std::uint64_t>().is_lock_free()) {
+    InjectorStorage::fatal("enableStatsExport() requires lock-free 64-bit atomics, that this platform doesn't have.");
+  }
+  // O_EXCL ensures that we never write into (or later remove) a segment created by someone else, e.g. by another
+  // injector exporting its stats with the same name.
+  int fd = shm_open(segment_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+  if (fd < 0) {
+    if (errno == EEXIST) {
+      InjectorStorage::fatal("enableStatsExport() couldn't create the shared memory segment " + segment_name +
+                             " because it already exists. Use a different name for each injector, and remove the "
+                             "segments left behind by processes that crashed.");
+    }
+    InjectorStorage::fatal("enableStatsExport() couldn't create the shared memory segment " + segment_name + ": " +
+                           std::strerror(errno));
+  }
+  struct stat segment_stat;
+  if (fstat(fd, &segment_stat) != 0 || ftruncate(fd, segment_size) != 0) {
+    int error = errno;
+    close(fd);
+    shm_unlink(segment_name.c_str());
+    InjectorStorage::fatal("enableStatsExport() couldn't resize the shared memory segment " + segment_name + ": " +
+                           std::strerror(error));
+  }
+  segment_device = segment_stat.st_dev;
+  segment_inode = segment_stat.st_ino;
+  void* p = mmap(nullptr, segment_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  int error = errno;
+  close(fd);
+  if (p == MAP_FAILED) {
+    shm_unlink(segment_name.c_str());
+    InjectorStorage::fatal("enableStatsExport() couldn't map the shared memory segment " + segment_name + ": " +
+                           std::strerror(error));
+  }
+
+  // The memory was zeroed by ftruncate(), so the atomics only need to be constructed.
+  header = new (p) InjectorStatsSegment::Header();
+  header->version = InjectorStatsSegment::current_version;
+  header->num_binding_slots = binding_slot_infos.size();
+  header->pid = getpid();
+  header->arena_used_bytes.store(arena_used_bytes, std::memory_order_relaxed);
+  header->arena_capacity_bytes.store(arena_capacity_bytes, std::memory_order_relaxed);
+
+  binding_slots = InjectorStatsSegment::getBindingSlots(header);
+  for (std::size_t i = 0; i < binding_slot_infos.size(); ++i) {
+    InjectorStatsSegment::BindingSlot* slot = new (binding_slots + i) InjectorStatsSegment::BindingSlot();
+    slot->is_multibinding = binding_slot_infos[i].is_multibinding;
+    std::strncpy(slot->type_name, binding_slot_infos[i].type_name.c_str(), sizeof(slot->type_name) - 1);
+  }
+
+  header->magic.store(InjectorStatsSegment::magic_value, std::memory_order_release);
+#else
+  (void)arena_used_bytes;
+  (void)arena_capacity_bytes;
+  InjectorStorage::fatal("enableStatsExport() is not supported on this platform.");
+#endif
+}
+
+InjectorStatsExporter::~InjectorStatsExporter() {
+#if FRUIT_HAS_POSIX_SHARED_MEMORY
+  munmap(header, segment_size);
+  // The segment might have been removed (and a new one created with the same name) by someone else in the meantime,
+  // so we only remove it if it's still the one that we created.
+  int fd = shm_open(segment_name.c_str(), O_RDONLY, 0);
+  if (fd >= 0) {
+    struct stat segment_stat;
+    bool is_own_segment = fstat(fd, &segment_stat) == 0 && std::uint64_t(segment_stat.st_dev) == segment_device &&
+                          std::uint64_t(segment_stat.st_ino) == segment_inode;
+    close(fd);
+    if (is_own_segment) {
+      shm_unlink(segment_name.c_str());
+    }
+  }
+#endif
+}
+
+void InjectorStatsExporter::beginConstruction() {
+  construction_stack.push_back(
+      Frame{std::chrono::steady_clock::now(), std::chrono::steady_clock::duration::zero()});
+}
+
+void InjectorStatsExporter::endConstruction(const void* key, std::size_t arena_used_bytes) {
+  FruitAssert(!construction_stack.empty());
+  std::chrono::steady_clock::duration elapsed_time = std::chrono::steady_clock::now() - construction_stack.back().begin;
+  std::chrono::steady_clock::duration construction_time = elapsed_time - construction_stack.back().excluded_time;
+  construction_stack.pop_back();
+  if (!construction_stack.empty()) {
+    construction_stack.back().excluded_time += elapsed_time;
+  }
+
+  addRelaxed(header->num_constructions, 1);
+  header->arena_used_bytes.store(arena_used_bytes, std::memory_order_relaxed);
+
+  auto itr = slot_index_by_key.find(key);
+  if (itr != slot_index_by_key.end()) {
+    InjectorStatsSegment::BindingSlot& slot = binding_slots[itr->second];
+    addRelaxed(slot.num_constructions, 1);
+    addRelaxed(slot.construction_nanos,
+               std::chrono::duration_cast<std::chrono::nanoseconds>(construction_time).count());
+  }
+}
+
+void InjectorStatsExporter::abortConstruction() {
+  FruitAssert(!construction_stack.empty());
+  std::chrono::steady_clock::duration elapsed_time = std::chrono::steady_clock::now() - construction_stack.back().begin;
+  construction_stack.pop_back();
+  if (!construction_stack.empty()) {
+    construction_stack.back().excluded_time += elapsed_time;
+  }
+}
+
+void InjectorStatsExporter::recordLockAcquisition() {
+  addRelaxed(header->num_lock_acquisitions, 1);
+}
+
+void InjectorStatsExporter::recordLockWait(std::chrono::steady_clock::duration wait_time) {
+  addRelaxed(header->num_lock_waits, 1);
+  addRelaxed(header->lock_wait_nanos, std::chrono::duration_cast<std::chrono::nanoseconds>(wait_time).count());
+}
+
+} // namespace impl
+} // namespace fruit
@@ -21,10 +21,16 @@
 #include <fruit/impl/util/type_info.h>
 #include <iostream>
 #include <memory>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include <fruit/impl/component_storage/component_storage.h>
 #include <fruit/impl/data_structures/semistatic_graph.templates.h>
+#include <fruit/impl/injector/allocation_tracker.h>
+#include <fruit/impl/injector/destruction_graph.h>
+#include <fruit/impl/injector/generation_tracker.h>
+#include <fruit/impl/injector/injector_stats_exporter.h>
 #include <fruit/impl/injector/injector_storage.h>
 #include <fruit/impl/normalized_component_storage/binding_normalization.h>
 #include <fruit/impl/normalized_component_storage/binding_normalization.templates.h>
@@ -56,6 +62,9 @@ struct DummyNode {
   Id* getEdgesEnd() {
     return nullptr;
   }
+  const bool* getLazyEdgesBegin() {
+    return nullptr;
+  }
   Value getValue() {
     return Value();
   }
@@ -65,21 +74,25 @@ struct DummyNode {
 
 InjectorStorage::InjectorStorage(ComponentStorage&& component,
                                  const std::vector<TypeId, ArenaAllocator<TypeId>>& exposed_types,
-                                 MemoryPool& memory_pool)
+                                 MemoryPool& memory_pool, ThreadingPolicy threading_policy)
     : normalized_component_storage_ptr(new NormalizedComponentStorage(
           std::move(component), exposed_types, memory_pool, NormalizedComponentStorage::WithPermanentCompression())),
       allocator(normalized_component_storage_ptr->fixed_size_allocator_data),
+      required_buffer_size(normalized_component_storage_ptr->fixed_size_allocator_data.getRequiredBufferSize()),
       bindings(normalized_component_storage_ptr->bindings, (DummyNode<TypeId, NormalizedBinding>*)nullptr,
                (DummyNode<TypeId, NormalizedBinding>*)nullptr, memory_pool),
-      multibindings(std::move(normalized_component_storage_ptr->multibindings)) {
+      multibindings(std::move(normalized_component_storage_ptr->multibindings)), threading_policy(threading_policy) {
 
 #if FRUIT_EXTRA_DEBUG
+  owner_thread_id = std::this_thread::get_id();
   bindings.checkFullyConstructed();
 #endif
 }
 
 InjectorStorage::InjectorStorage(const NormalizedComponentStorage& normalized_component, ComponentStorage&& component,
-                                 MemoryPool& memory_pool) {
+                                 MemoryPool& memory_pool, ThreadingPolicy threading_policy,
+                                 InjectorBuffer buffer)
+    : threading_policy(threading_policy) {
 
   FixedSizeAllocator::FixedSizeAllocatorData fixed_size_allocator_data;
   using new_bindings_vector_t = std::vector<ComponentStorageEntry, ArenaAllocator<ComponentStorageEntry>>;
@@ -88,26 +101,488 @@ InjectorStorage::InjectorStorage(const NormalizedComponentStorage& normalized_co
   BindingNormalization::normalizeBindingsAndAddTo(std::move(component).release(), memory_pool, normalized_component,
                                                   fixed_size_allocator_data, new_bindings_vector, multibindings);
 
-  allocator = FixedSizeAllocator(fixed_size_allocator_data);
+  required_buffer_size = fixed_size_allocator_data.getRequiredBufferSize();
+  if (buffer.data != nullptr && buffer.size < required_buffer_size) {
+    fatal("The InjectorBuffer passed to the Injector constructor is too small: it has " + std::to_string(buffer.size) +
+          " bytes but this injector needs " + std::to_string(required_buffer_size) +
+          " bytes (see Injector::getRequiredBufferSize()).");
+  }
+  allocator = FixedSizeAllocator(fixed_size_allocator_data, buffer.data, buffer.size);
 
   bindings = Graph(normalized_component.bindings, BindingDataNodeIter{new_bindings_vector.begin()},
                    BindingDataNodeIter{new_bindings_vector.end()}, memory_pool);
 #if FRUIT_EXTRA_DEBUG
+  owner_thread_id = std::this_thread::get_id();
   bindings.checkFullyConstructed();
 #endif
 }
 
-InjectorStorage::~InjectorStorage() {}
+InjectorStorage::~InjectorStorage() {
+  if (destruction_graph != nullptr) {
+    destruction_graph->destroyObjects(allocator);
+  }
+}
+
+void InjectorStorage::enableConcurrentDestruction(std::size_t num_threads) {
+  std::unique_lock<std::recursive_mutex> lock = lockIfNeeded();
+  if (allocator.numObjectsToDestroy() != 0) {
+    fatal("enableConcurrentDestruction() must be called before injecting any object.");
+  }
+  destruction_graph.reset(new DestructionGraph(num_threads));
+  is_instrumented = true;
+}
+
+void InjectorStorage::enableAllocationTracking(std::size_t (*get_allocated_bytes)()) {
+  std::unique_lock<std::recursive_mutex> lock = lockIfNeeded();
+  if (allocation_tracker != nullptr) {
+    fatal("enableAllocationTracking() must be called at most once on each injector.");
+  }
+  allocation_tracker.reset(new AllocationTracker(get_allocated_bytes));
+  is_instrumented = true;
+}
+
+std::vector<TypeAllocationStats> InjectorStorage::getTopAllocatingTypes(std::size_t max_num_types) {
+  std::unique_lock<std::recursive_mutex> lock = lockIfNeeded();
+  if (allocation_tracker == nullptr) {
+    fatal("getTopAllocatingTypes() was called but allocation tracking was not enabled. Call "
+          "enableAllocationTracking() first.");
+  }
+  if (is_compacted) {
+    fatal("getTopAllocatingTypes() can't be called after compact(), that releases the bindings it needs.");
+  }
+  const std::unordered_map<const void*, std::size_t>& allocated_bytes_by_key =
+      allocation_tracker->getAllocatedBytesByKey();
+
+  // The keys are the addresses of the NormalizedBinding/NormalizedMultibinding objects, so we need to look at all
+  // bindings to find out the type of each key. This is slow, but it's fine since this is only used for diagnostics.
+  std::vector<TypeAllocationStats> result;
+  bindings.forEachNode([&](TypeId type_id, Graph::node_iterator node_itr) {
+    auto itr = allocated_bytes_by_key.find(&node_itr.getNode());
+    if (itr != allocated_bytes_by_key.end() && itr->second != 0) {
+      result.push_back(TypeAllocationStats{std::string(type_id), false, itr->second});
+    }
+  });
+  for (auto& typeInfoInfoPair : multibindings) {
+    std::size_t num_bytes = 0;
+    for (NormalizedMultibinding& multibinding : typeInfoInfoPair.second.elems) {
+      auto itr = allocated_bytes_by_key.find(&multibinding);
+      if (itr != allocated_bytes_by_key.end()) {
+        num_bytes += itr->second;
+      }
+    }
+    if (num_bytes != 0) {
+      result.push_back(TypeAllocationStats{std::string(typeInfoInfoPair.first), true, num_bytes});
+    }
+  }
+
+  std::sort(result.begin(), result.end(), [](const TypeAllocationStats& x, const TypeAllocationStats& y) {
+    if (x.num_bytes != y.num_bytes) {
+      return x.num_bytes > y.num_bytes;
+    }
+    if (x.type_name != y.type_name) {
+      return x.type_name < y.type_name;
+    }
+    return x.is_multibinding < y.is_multibinding;
+  });
+  if (result.size() > max_num_types) {
+    result.resize(max_num_types);
+  }
+  return result;
+}
+
+void InjectorStorage::enableStatsExport(const std::string& segment_name) {
+  std::unique_lock<std::recursive_mutex> lock = lockIfNeeded();
+  if (stats_exporter != nullptr) {
+    fatal("enableStatsExport() must be called at most once on each injector.");
+  }
+
+  // One slot for each binding and one for all the multibindings of each type, keyed (as in allocation_tracker) by the
+  // address of the NormalizedBinding/NormalizedMultibinding objects.
+  std::vector<InjectorStatsExporter::BindingSlotInfo> binding_slots;
+  std::unordered_map<const void*, std::size_t> slot_index_by_key;
+  bindings.forEachNode([&](TypeId type_id, Graph::node_iterator node_itr) {
+    slot_index_by_key[&node_itr.getNode()] = binding_slots.size();
+    binding_slots.push_back(InjectorStatsExporter::BindingSlotInfo{std::string(type_id), false});
+  });
+  for (auto& typeInfoInfoPair : multibindings) {
+    for (NormalizedMultibinding& multibinding : typeInfoInfoPair.second.elems) {
+      slot_index_by_key[&multibinding] = binding_slots.size();
+    }
+    binding_slots.push_back(InjectorStatsExporter::BindingSlotInfo{std::string(typeInfoInfoPair.first), true});
+  }
+
+  stats_exporter.reset(new InjectorStatsExporter(segment_name, binding_slots, std::move(slot_index_by_key),
+                                                 allocator.numUsedBytes(), required_buffer_size));
+  is_instrumented = true;
+}
+
+void InjectorStorage::compact(void (*const* type_steps)(InjectorStorage&), const TypeId* exposed_types,
+                              std::size_t num_exposed_types) {
+  std::unique_lock<std::recursive_mutex> lock = lockIfNeeded();
+  if (generation_tracker != nullptr) {
+    fatal("compact() can't be called on an injector with generation tracking enabled, since the next generation "
+          "needs all its bindings in reuseObjectsFrom().");
+  }
+  if (is_compacted) {
+    return;
+  }
+
+  for (std::size_t i = 0; i < num_exposed_types; ++i) {
+    type_steps[i](*this);
+  }
+  for (auto& typeInfoInfoPair : multibindings) {
+    typeInfoInfoPair.second.get_multibindings_vector(*this);
+  }
+
+  // The bindings that are still not constructed can only be reached through Providers obtained before this call. Their
+  // create functions would need the edges that we're about to free, so we replace them with one that reports an error.
+  bindings.forEachNode([](TypeId, Graph::node_iterator node_itr) {
+    if (!node_itr.isTerminal()) {
+      node_itr.getNode().create = createInjectedObjectAfterCompaction;
+    }
+  });
+
+  MemoryPool memory_pool;
+  bindings.compact(exposed_types, exposed_types + num_exposed_types, memory_pool);
+  if (normalized_component_storage_ptr != nullptr) {
+    // `bindings' was constructed as an extension of this graph, but it no longer refers to it after compact().
+    normalized_component_storage_ptr->bindings = Graph();
+  }
+
+  // The vectors of objects are cached in the `v' fields now, so the individual multibindings are no longer needed.
+  for (auto& typeInfoInfoPair : multibindings) {
+    std::vector<NormalizedMultibinding>().swap(typeInfoInfoPair.second.elems);
+  }
+  std::vector<NormalizedMultibindingSet*>().swap(eager_injection_multibinding_sets);
+  std::vector<EagerInjectionFrame>().swap(eager_injection_stack);
+
+  is_compacted = true;
+}
+
+const void* InjectorStorage::createInjectedObjectAfterCompaction(InjectorStorage&, Graph::node_iterator) {
+  fatal("attempted to construct an object using a Provider obtained before compact() was called on the injector. "
+        "Objects that can be reached through Providers must be constructed before calling compact().");
+  FRUIT_UNREACHABLE; // LCOV_EXCL_LINE
+}
+
+std::unique_lock<std::recursive_mutex> InjectorStorage::lockAndRecordStats() {
+  std::unique_lock<std::recursive_mutex> lock(mutex, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    std::chrono::steady_clock::time_point wait_begin = std::chrono::steady_clock::now();
+    lock.lock();
+    stats_exporter->recordLockWait(std::chrono::steady_clock::now() - wait_begin);
+  }
+  stats_exporter->recordLockAcquisition();
+  return lock;
+}
+
+std::size_t InjectorStorage::getRequiredBufferSize() {
+  return required_buffer_size;
+}
+
+void InjectorStorage::enableGenerationTracking() {
+  std::unique_lock<std::recursive_mutex> lock = lockIfNeeded();
+  if (allocator.numObjectsToDestroy() != 0) {
+    fatal("enableGenerationTracking() must be called before injecting any object.");
+  }
+  generation_tracker.reset(new GenerationTracker());
+  is_instrumented = true;
+}
+
+void InjectorStorage::markNotReusableForNextGeneration() {
+  generation_tracker->markNotReusable();
+}
+
+namespace {
+
+// Decides which objects of the previous generation can be reused by the next one. An object can be reused if the
+// next generation has the same binding for its type (same create function), and all its dependencies can be reused
+// too or are the same instance bound with bindInstance().
+class ReusableObjectFinder {
+public:
+  ReusableObjectFinder(InjectorStorage::Graph& bindings, InjectorStorage::Graph& previous_bindings,
+                       const GenerationTracker& previous_tracker)
+      : bindings(bindings), previous_bindings(previous_bindings), previous_tracker(previous_tracker) {
+    // The tracker refers to bindings by the address of their NormalizedBinding, so we need to look at all bindings to
+    // find out the type of each of them.
+    previous_bindings.forEachNode([this](TypeId type_id, InjectorStorage::Graph::node_iterator node_itr) {
+      previous_types.emplace(&node_itr.getNode(), type_id);
+    });
+  }
+
+  bool isReusable(TypeId type_id) {
+    auto itr = is_reusable_by_type.find(type_id);
+    if (itr != is_reusable_by_type.end()) {
+      return itr->second;
+    }
+    bool result = computeIsReusable(type_id);
+    is_reusable_by_type[type_id] = result;
+    return result;
+  }
+
+  // Returns the type of a dependency recorded by the previous generation's tracker.
+  TypeId getPreviousType(const void* key) {
+    return previous_types.at(key);
+  }
+
+private:
+  InjectorStorage::Graph& bindings;
+  InjectorStorage::Graph& previous_bindings;
+  const GenerationTracker& previous_tracker;
+  std::unordered_map<const void*, TypeId> previous_types;
+  std::unordered_map<TypeId, bool> is_reusable_by_type;
+
+  bool computeIsReusable(TypeId type_id) {
+    InjectorStorage::Graph::node_iterator node_itr = bindings.find(type_id);
+    InjectorStorage::Graph::node_iterator previous_node_itr = previous_bindings.find(type_id);
+    if (node_itr == bindings.end() || previous_node_itr == previous_bindings.end() ||
+        !previous_node_itr.isTerminal()) {
+      return false;
+    }
+    const GenerationTracker::ConstructedBinding* previous_binding =
+        previous_tracker.find(&previous_node_itr.getNode());
+
+    if (node_itr.isTerminal()) {
+      // A bindInstance() binding, it's the same only if the previous generation bound the same instance.
+      return previous_binding == nullptr && node_itr.getNode().object == previous_node_itr.getNode().object;
+    }
+
+    if (previous_binding == nullptr || !previous_binding->is_reusable ||
+        previous_binding->create != node_itr.getNode().create) {
+      return false;
+    }
+
+    // The create function is the same, so the binding has the same number of deps. We still check that the deps
+    // recorded in the previous generation are the edges of the node (in any order) in case the linker merged the create
+    // functions of different bindings with identical code.
+    std::size_t num_deps = previous_binding->deps.size();
+    InjectorStorage::Graph::node_iterator bindings_begin = bindings.begin();
+    for (const void* dep : previous_binding->deps) {
+      TypeId dep_type_id = getPreviousType(dep);
+      InjectorStorage::Graph::node_iterator dep_itr = bindings.find(dep_type_id);
+      if (dep_itr == bindings.end()) {
+        return false;
+      }
+      bool found = false;
+      for (std::size_t i = 0; i < num_deps && !found; ++i) {
+        found = node_itr.neighborsBegin().getNodeIterator(i, bindings_begin) == dep_itr;
+      }
+      if (!found || !isReusable(dep_type_id)) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+} // namespace
+
+std::shared_ptr<ReusedObject> InjectorStorage::getOrCreateReusedObject(const void* key) {
+  GenerationTracker::ConstructedBinding* binding = generation_tracker->find(key);
+  if (binding == nullptr) {
+    // A bindInstance() binding, the object is not owned by this injector.
+    return nullptr;
+  }
+  if (binding->reused_object != nullptr) {
+    return binding->reused_object;
+  }
+
+  std::shared_ptr<ReusedObject> reused_object = std::make_shared<ReusedObject>();
+  // A reused object can only depend on reused objects (or on instances bound with bindInstance()), so these are all
+  // reused too.
+  for (const void* dep : binding->deps) {
+    std::shared_ptr<ReusedObject> dep_reused_object = getOrCreateReusedObject(dep);
+    if (dep_reused_object != nullptr) {
+      reused_object->dependencies.push_back(std::move(dep_reused_object));
+    }
+  }
+  reused_object->storage = allocator.shareStorage();
+  for (std::size_t i = binding->objects_begin; i < binding->objects_end; ++i) {
+    reused_object->objects_to_destroy.push_back(allocator.releaseObjectAt(i));
+  }
+  binding->reused_object = reused_object;
+  // Objects constructed by this injector later on might depend on this one, so this injector keeps it alive too.
+  reused_objects.push_back(reused_object);
+  return reused_object;
+}
+
+void InjectorStorage::reuseObjectsFrom(InjectorStorage& previous_generation) {
+  std::unique_lock<std::recursive_mutex> lock = lockIfNeeded();
+  std::unique_lock<std::recursive_mutex> previous_lock = previous_generation.lockIfNeeded();
+  if (generation_tracker == nullptr || previous_generation.generation_tracker == nullptr) {
+    fatal("reuseObjectsFrom() requires generation tracking to be enabled on both injectors.");
+  }
+  if (allocator.numObjectsToDestroy() != 0) {
+    fatal("reuseObjectsFrom() must be called before injecting any object.");
+  }
+
+  ReusableObjectFinder finder(bindings, previous_generation.bindings, *previous_generation.generation_tracker);
+
+  // We find all reusable types first, since reusing an object changes the corresponding node into a terminal one.
+  std::vector<std::pair<TypeId, Graph::node_iterator>> reusable_nodes;
+  bindings.forEachNode([&](TypeId type_id, Graph::node_iterator node_itr) {
+    if (!node_itr.isTerminal() && finder.isReusable(type_id)) {
+      reusable_nodes.emplace_back(type_id, node_itr);
+    }
+  });
+
+  for (const std::pair<TypeId, Graph::node_iterator>& reusable_node : reusable_nodes) {
+    Graph::node_iterator node_itr = reusable_node.second;
+    Graph::node_iterator previous_node_itr = previous_generation.bindings.at(reusable_node.first);
+    const GenerationTracker::ConstructedBinding& previous_binding =
+        *previous_generation.generation_tracker->find(&previous_node_itr.getNode());
+
+    GenerationTracker::ConstructedBinding binding;
+    binding.create = previous_binding.create;
+    for (const void* dep : previous_binding.deps) {
+      binding.deps.push_back(&bindings.at(finder.getPreviousType(dep)).getNode());
+    }
+    binding.objects_begin = 0;
+    binding.objects_end = 0;
+    binding.is_reusable = true;
+    // From now on the object is owned by all the generations that use it, instead of by the allocator of the
+    // generation that constructed it. So the other objects of that generation can still be destroyed with it.
+    binding.reused_object = previous_generation.getOrCreateReusedObject(&previous_node_itr.getNode());
+    reused_objects.push_back(binding.reused_object);
+
+    node_itr.getNode().object = previous_node_itr.getNode().object;
+    node_itr.setTerminal();
+    generation_tracker->addReusedBinding(&node_itr.getNode(), std::move(binding));
+  }
+}
+
+class InjectorStorage::InstrumentedConstruction {
+public:
+  explicit InstrumentedConstruction(InjectorStorage& storage) : storage(storage) {
+    // The allocation tracker starts first and ends last, and it doesn't count the bookkeeping of the other
+    // instrumentation, so that it only attributes the memory allocated by the construction itself.
+    if (storage.allocation_tracker != nullptr) {
+      storage.allocation_tracker->beginConstruction();
+      storage.allocation_tracker->pauseCounting();
+    }
+    if (storage.destruction_graph != nullptr) {
+      storage.destruction_graph->beginConstruction();
+    }
+    if (storage.generation_tracker != nullptr) {
+      storage.generation_tracker->beginConstruction();
+    }
+    if (storage.stats_exporter != nullptr) {
+      storage.stats_exporter->beginConstruction();
+    }
+    if (storage.allocation_tracker != nullptr) {
+      storage.allocation_tracker->resumeCounting();
+    }
+  }
+
+  InstrumentedConstruction(const InstrumentedConstruction&) = delete;
+  InstrumentedConstruction& operator=(const InstrumentedConstruction&) = delete;
+
+  ~InstrumentedConstruction() {
+    if (is_ended) {
+      return;
+    }
+    if (storage.allocation_tracker != nullptr) {
+      storage.allocation_tracker->pauseCounting();
+    }
+    if (storage.stats_exporter != nullptr) {
+      storage.stats_exporter->abortConstruction();
+    }
+    if (storage.generation_tracker != nullptr) {
+      storage.generation_tracker->abortConstruction();
+    }
+    if (storage.destruction_graph != nullptr) {
+      storage.destruction_graph->abortConstruction();
+    }
+    if (storage.allocation_tracker != nullptr) {
+      storage.allocation_tracker->resumeCounting();
+      storage.allocation_tracker->abortConstruction();
+    }
+  }
+
+  void end(NormalizedBinding& normalized_binding, GenerationTracker::create_t create) {
+    is_ended = true;
+    if (storage.allocation_tracker != nullptr) {
+      storage.allocation_tracker->pauseCounting();
+    }
+    if (storage.stats_exporter != nullptr) {
+      storage.stats_exporter->endConstruction(&normalized_binding, storage.allocator.numUsedBytes());
+    }
+    if (storage.generation_tracker != nullptr) {
+      storage.generation_tracker->endConstruction(&normalized_binding, create,
+                                                  storage.allocator.numObjectsToDestroy());
+    }
+    if (storage.destruction_graph != nullptr) {
+      storage.destruction_graph->endConstruction(&normalized_binding, storage.allocator.numObjectsToDestroy());
+    }
+    if (storage.allocation_tracker != nullptr) {
+      storage.allocation_tracker->resumeCounting();
+      storage.allocation_tracker->endConstruction(&normalized_binding);
+    }
+  }
+
+  void end(NormalizedMultibinding& multibinding) {
+    is_ended = true;
+    if (storage.allocation_tracker != nullptr) {
+      storage.allocation_tracker->pauseCounting();
+    }
+    if (storage.stats_exporter != nullptr) {
+      storage.stats_exporter->endConstruction(&multibinding, storage.allocator.numUsedBytes());
+    }
+    if (storage.generation_tracker != nullptr) {
+      storage.generation_tracker->endMultibindingConstruction(storage.allocator.numObjectsToDestroy());
+    }
+    if (storage.destruction_graph != nullptr) {
+      storage.destruction_graph->endConstruction(&multibinding, storage.allocator.numObjectsToDestroy());
+    }
+    if (storage.allocation_tracker != nullptr) {
+      storage.allocation_tracker->resumeCounting();
+      storage.allocation_tracker->endConstruction(&multibinding);
+    }
+  }
+
+private:
+  InjectorStorage& storage;
+  bool is_ended = false;
+};
+
+const void* InjectorStorage::getPtrInternalInstrumented(Graph::node_iterator node_itr) {
+  NormalizedBinding& normalized_binding = node_itr.getNode();
+  if (node_itr.isTerminal()) {
+    if (destruction_graph != nullptr) {
+      destruction_graph->addDependency(&normalized_binding);
+    }
+    if (generation_tracker != nullptr) {
+      generation_tracker->addDependency(&normalized_binding);
+    }
+  } else {
+    // This is overwritten by the constructed object below.
+    GenerationTracker::create_t create = normalized_binding.create;
+    InstrumentedConstruction construction(*this);
+    normalized_binding.object = create(*this, node_itr);
+    FruitAssert(node_itr.isTerminal());
+    construction.end(normalized_binding, create);
+  }
+  return normalized_binding.object;
+}
 
 void InjectorStorage::ensureConstructedMultibinding(NormalizedMultibindingSet& multibinding_set) {
   for (NormalizedMultibinding& multibinding : multibinding_set.elems) {
     if (!multibinding.is_constructed) {
-      multibinding.object = multibinding.create(*this);
-      multibinding.is_constructed = true;
+      constructMultibinding(multibinding);
+    } else if (destruction_graph != nullptr) {
+      destruction_graph->addDependency(&multibinding);
     }
   }
 }
 
+void InjectorStorage::constructMultibinding(NormalizedMultibinding& multibinding) {
+  FruitAssert(!multibinding.is_constructed);
+  InstrumentedConstruction construction(*this);
+  multibinding.object = multibinding.create(*this);
+  multibinding.is_constructed = true;
+  construction.end(multibinding);
+}
+
 void* InjectorStorage::getMultibindings(TypeId typeInfo) {
   NormalizedMultibindingSet* multibinding_set = getNormalizedMultibindingSet(typeInfo);
   if (multibinding_set == nullptr) {
@@ -118,12 +593,112 @@ void* InjectorStorage::getMultibindings(TypeId typeInfo) {
 }
 
 void InjectorStorage::eagerlyInjectMultibindings() {
-  std::lock_guard<std::recursive_mutex> lock(mutex);
+  std::unique_lock<std::recursive_mutex> lock = lockIfNeeded();
   for (auto& typeInfoInfoPair : multibindings) {
     typeInfoInfoPair.second.get_multibindings_vector(*this);
   }
 }
 
+EagerInjectionProgress InjectorStorage::eagerlyInjectSome(const TypeId* exposed_types, std::size_t num_exposed_types,
+                                                          std::chrono::steady_clock::time_point deadline) {
+  std::unique_lock<std::recursive_mutex> lock = lockIfNeeded();
+
+  if (eager_injection_multibinding_sets.size() != multibindings.size()) {
+    // First call, sort the multibinding sets so that the order of construction doesn't depend on the hash of the
+    // TypeIds (i.e. on the addresses where the TypeInfo objects were loaded).
+    std::vector<std::pair<std::string, NormalizedMultibindingSet*>> named_multibinding_sets;
+    named_multibinding_sets.reserve(multibindings.size());
+    for (auto& typeInfoInfoPair : multibindings) {
+      named_multibinding_sets.emplace_back(std::string(typeInfoInfoPair.first), &typeInfoInfoPair.second);
+    }
+    std::sort(named_multibinding_sets.begin(), named_multibinding_sets.end());
+    eager_injection_multibinding_sets.clear();
+    for (auto& named_multibinding_set : named_multibinding_sets) {
+      eager_injection_multibinding_sets.push_back(named_multibinding_set.second);
+    }
+  }
+
+  std::size_t num_steps = num_exposed_types + eager_injection_multibinding_sets.size();
+  // The deadline is checked before constructing each object except the first one, so that each call makes progress.
+  bool constructed_any = false;
+  auto isOverBudget = [&]() { return constructed_any && std::chrono::steady_clock::now() >= deadline; };
+
+  while (num_completed_eager_injection_steps < num_steps) {
+    if (!eager_injection_stack.empty()) {
+      EagerInjectionFrame& frame = eager_injection_stack.back();
+      if (frame.node.isTerminal()) {
+        // Constructed in the meantime, as a dependency of another binding or by a get() between calls.
+        eager_injection_stack.pop_back();
+      } else if (frame.next_neighbor < frame.node.numNeighbors()) {
+        std::size_t neighbor = frame.next_neighbor++;
+        // Lazy dependencies (i.e. Provider<>s) are not constructed when this binding is constructed.
+        if (!frame.node.isLazyNeighbor(neighbor)) {
+          pushEagerInjectionFrame(frame.node.neighborsBegin().getNodeIterator(neighbor, bindings.begin()));
+        }
+      } else {
+        if (isOverBudget()) {
+          break;
+        }
+        // All the dependencies are constructed already, so this only constructs this binding.
+        Graph::node_iterator node = frame.node;
+        eager_injection_stack.pop_back();
+        getPtrInternal(node);
+        constructed_any = true;
+      }
+      continue;
+    }
+
+    std::size_t step = num_completed_eager_injection_steps;
+    if (step < num_exposed_types) {
+      if (!is_eager_injection_step_started) {
+        pushEagerInjectionFrame(bindings.at(exposed_types[step]));
+        is_eager_injection_step_started = true;
+      } else {
+        is_eager_injection_step_started = false;
+        ++num_completed_eager_injection_steps;
+      }
+      continue;
+    }
+
+    NormalizedMultibindingSet& multibinding_set = *eager_injection_multibinding_sets[step - num_exposed_types];
+    if (next_eager_injection_multibinding < multibinding_set.elems.size()) {
+      NormalizedMultibinding& multibinding = multibinding_set.elems[next_eager_injection_multibinding];
+      if (multibinding.is_constructed) {
+        is_eager_injection_step_started = false;
+        ++next_eager_injection_multibinding;
+      } else if (!is_eager_injection_step_started) {
+        // Pushed in reverse order, so that they're constructed in order.
+        for (std::size_t i = multibinding.deps->num_deps; i > 0; --i) {
+          if (multibinding.deps->lazy_deps == nullptr || !multibinding.deps->lazy_deps[i - 1]) {
+            pushEagerInjectionFrame(bindings.at(multibinding.deps->deps[i - 1]));
+          }
+        }
+        is_eager_injection_step_started = true;
+      } else {
+        if (isOverBudget()) {
+          break;
+        }
+        constructMultibinding(multibinding);
+        constructed_any = true;
+      }
+      continue;
+    }
+
+    // All the multibindings are constructed already, so this only creates the vector.
+    multibinding_set.get_multibindings_vector(*this);
+    next_eager_injection_multibinding = 0;
+    ++num_completed_eager_injection_steps;
+  }
+
+  return EagerInjectionProgress{num_completed_eager_injection_steps, num_steps};
+}
+
+void InjectorStorage::pushEagerInjectionFrame(Graph::node_iterator node) {
+  if (!node.isTerminal()) {
+    eager_injection_stack.push_back(EagerInjectionFrame{node, 0});
+  }
+}
+
 } // namespace impl
 // We need a LCOV_EXCL_BR_LINE below because for some reason gcov/lcov think there's a branch there.
 } // namespace fruit LCOV_EXCL_BR_LINE
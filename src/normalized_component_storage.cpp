@@ -89,6 +89,162 @@ NormalizedComponentStorage::NormalizedComponentStorage(ComponentStorage&& compon
   bindings = SemistaticGraph<TypeId, NormalizedBinding>(InjectorStorage::BindingDataNodeIter{bindings_vector.begin()},
                                                         InjectorStorage::BindingDataNodeIter{bindings_vector.end()},
                                                         memory_pool);
+
+  binding_entries.assign(bindings_vector.begin(), bindings_vector.end());
+}
+
+NormalizedComponentStorage::NormalizedComponentStorage(const NormalizedComponentStorage& parent,
+                                                       const std::vector<TypeId, ArenaAllocator<TypeId>>& exposed_types,
+                                                       MemoryPool& memory_pool)
+    : normalized_component_memory_pool(),
+      binding_compression_info_map(createHashMapWithArenaAllocator<TypeId, CompressedBindingUndoInfo>(
+          20 /* capacity */, normalized_component_memory_pool)),
+      fully_expanded_components_with_no_args(createLazyComponentWithNoArgsSet(
+          parent.fully_expanded_components_with_no_args.size(), normalized_component_memory_pool)),
+      fully_expanded_components_with_args(createLazyComponentWithArgsSet(
+          parent.fully_expanded_components_with_args.size(), normalized_component_memory_pool)),
+      component_with_no_args_replacements(createLazyComponentWithNoArgsReplacementMap(
+          parent.component_with_no_args_replacements.size(), normalized_component_memory_pool)),
+      component_with_args_replacements(createLazyComponentWithArgsReplacementMap(
+          parent.component_with_args_replacements.size(), normalized_component_memory_pool)) {
+
+  HashMapWithArenaAllocator<TypeId, const ComponentStorageEntry*> parent_entries_by_type =
+      createHashMapWithArenaAllocator<TypeId, const ComponentStorageEntry*>(parent.binding_entries.size(),
+                                                                             memory_pool);
+  for (const ComponentStorageEntry& entry : parent.binding_entries) {
+    parent_entries_by_type[entry.type_id] = &entry;
+  }
+
+  // Maps the I type of each compressed binding (I->C) to C, the type that is actually constructed for I.
+  HashMapWithArenaAllocator<TypeId, TypeId> c_type_by_compressed_i_type =
+      createHashMapWithArenaAllocator<TypeId, TypeId>(parent.binding_compression_info_map.size(), memory_pool);
+  for (const auto& p : parent.binding_compression_info_map) {
+    c_type_by_compressed_i_type[p.second.i_type_id] = p.first;
+  }
+
+  HashSetWithArenaAllocator<TypeId> reached_types =
+      createHashSetWithArenaAllocator<TypeId>(exposed_types.size(), memory_pool);
+  std::vector<TypeId, ArenaAllocator<TypeId>> types_to_visit(exposed_types.begin(), exposed_types.end(),
+                                                             ArenaAllocator<TypeId>(memory_pool));
+
+  using entry_ptrs_vector_t = std::vector<const ComponentStorageEntry*, ArenaAllocator<const ComponentStorageEntry*>>;
+  entry_ptrs_vector_t reached_entries = entry_ptrs_vector_t(ArenaAllocator<const ComponentStorageEntry*>(memory_pool));
+
+  while (!types_to_visit.empty()) {
+    TypeId type_id = types_to_visit.back();
+    types_to_visit.pop_back();
+    if (!reached_types.insert(type_id).second) {
+      continue;
+    }
+    auto itr = parent_entries_by_type.find(type_id);
+    if (itr == parent_entries_by_type.end()) {
+      // A type required by `parent', it will be bound by the component passed to the injector.
+      continue;
+    }
+    const ComponentStorageEntry& entry = *itr->second;
+    reached_entries.push_back(&entry);
+
+    switch (entry.kind) { // LCOV_EXCL_BR_LINE
+    case ComponentStorageEntry::Kind::BINDING_FOR_CONSTRUCTED_OBJECT:
+      break;
+
+    case ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_ALLOCATION:
+    case ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION: {
+      const BindingDeps* deps = entry.binding_for_object_to_construct.deps;
+      types_to_visit.insert(types_to_visit.end(), deps->deps, deps->deps + deps->num_deps);
+    } break;
+
+    default:
+#if FRUIT_EXTRA_DEBUG
+      std::cerr << "Unexpected kind: " << (std::size_t)entry.kind << std::endl;
+#endif
+      FRUIT_UNREACHABLE; // LCOV_EXCL_LINE
+      break;
+    }
+  }
+
+  // The components expanded in `parent' are skipped when they're installed again in the component passed to the
+  // injector, so we can only keep treating them as expanded if the slice kept all the bindings and multibindings that
+  // they contributed. We don't know which component contributed each binding, so this is only the case if the slice
+  // kept everything.
+  // Otherwise they're expanded again in the injector. The bindings of theirs that the slice kept are then bound again
+  // with the same create function, so they're just ignored as duplicates; but that's not the case for compressed
+  // bindings, so in that case the slice undoes all binding compressions.
+  bool keeps_all_bindings = reached_entries.size() == parent.binding_entries.size() && parent.multibindings.empty();
+
+  using bindings_vector_t = std::vector<ComponentStorageEntry, ArenaAllocator<ComponentStorageEntry>>;
+  bindings_vector_t bindings_vector = bindings_vector_t(ArenaAllocator<ComponentStorageEntry>(memory_pool));
+
+  for (const ComponentStorageEntry* entry_ptr : reached_entries) {
+    const ComponentStorageEntry& entry = *entry_ptr;
+    if (entry.kind == ComponentStorageEntry::Kind::BINDING_FOR_CONSTRUCTED_OBJECT) {
+      bindings_vector.push_back(entry);
+      continue;
+    }
+
+    // This adds to fixed_size_allocator_data what the normalization of `parent' added for this binding (and for C, if
+    // this is the I of a compressed binding).
+    auto c_type_itr = c_type_by_compressed_i_type.find(entry.type_id);
+    if (c_type_itr == c_type_by_compressed_i_type.end()) {
+      bindings_vector.push_back(entry);
+      if (entry.kind == ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_ALLOCATION) {
+        fixed_size_allocator_data.addType(entry.type_id);
+      } else {
+        fixed_size_allocator_data.addExternallyAllocatedType(entry.type_id);
+      }
+      continue;
+    }
+
+    TypeId c_type_id = c_type_itr->second;
+    const CompressedBindingUndoInfo& undo_info = parent.binding_compression_info_map.find(c_type_id)->second;
+    fixed_size_allocator_data.addExternallyAllocatedType(entry.type_id);
+    if (entry.kind == ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_ALLOCATION) {
+      fixed_size_allocator_data.addType(c_type_id);
+    } else {
+      fixed_size_allocator_data.addExternallyAllocatedType(c_type_id);
+    }
+
+    if (keeps_all_bindings) {
+      bindings_vector.push_back(entry);
+      binding_compression_info_map[c_type_id] = undo_info;
+    } else {
+      ComponentStorageEntry c_binding;
+      c_binding.type_id = c_type_id;
+      c_binding.kind = entry.kind;
+      c_binding.binding_for_object_to_construct = undo_info.c_binding;
+
+      ComponentStorageEntry i_binding;
+      i_binding.type_id = entry.type_id;
+      i_binding.kind = ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION;
+      i_binding.binding_for_object_to_construct = undo_info.i_binding;
+
+      bindings_vector.push_back(c_binding);
+      bindings_vector.push_back(i_binding);
+    }
+  }
+
+  if (keeps_all_bindings) {
+    for (const LazyComponentWithNoArgs& lazy_component : parent.fully_expanded_components_with_no_args) {
+      fully_expanded_components_with_no_args.insert(lazy_component);
+    }
+    for (const LazyComponentWithArgs& lazy_component : parent.fully_expanded_components_with_args) {
+      fully_expanded_components_with_args.insert(lazy_component.copy());
+    }
+  }
+  // The replacements still apply; if the replacement component was expanded in `parent' but it's no longer considered
+  // expanded here, it's expanded again in the injector.
+  for (const auto& pair : parent.component_with_no_args_replacements) {
+    component_with_no_args_replacements[pair.first] = pair.second.copy();
+  }
+  for (const auto& pair : parent.component_with_args_replacements) {
+    component_with_args_replacements[pair.first.copy()] = pair.second.copy();
+  }
+
+  bindings = SemistaticGraph<TypeId, NormalizedBinding>(InjectorStorage::BindingDataNodeIter{bindings_vector.begin()},
+                                                        InjectorStorage::BindingDataNodeIter{bindings_vector.end()},
+                                                        memory_pool);
+
+  binding_entries.assign(bindings_vector.begin(), bindings_vector.end());
 }
 
 NormalizedComponentStorage::~NormalizedComponentStorage() noexcept {
@@ -28,6 +28,11 @@ NormalizedComponentStorageHolder::NormalizedComponentStorageHolder(
     : storage(new NormalizedComponentStorage(std::move(component), exposed_types, memory_pool,
                                              NormalizedComponentStorage::WithUndoableCompression())) {}
 
+NormalizedComponentStorageHolder::NormalizedComponentStorageHolder(
+    const NormalizedComponentStorageHolder& parent, const std::vector<TypeId, ArenaAllocator<TypeId>>& exposed_types,
+    MemoryPool& memory_pool)
+    : storage(new NormalizedComponentStorage(*parent.storage, exposed_types, memory_pool)) {}
+
 NormalizedComponentStorageHolder::~NormalizedComponentStorageHolder() noexcept {}
 
 } // namespace impl
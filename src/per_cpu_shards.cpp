@@ -0,0 +1,121 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define IN_FRUIT_CPP_FILE 1
+
+#include <fruit/impl/injector/per_cpu_shards.h>
+
+#include <fruit/impl/fruit-config.h>
+#include <fruit/impl/fruit_assert.h>
+
+#include <cstdint>
+#include <functional>
+#include <thread>
+
+#if FRUIT_HAS_SCHED_GETCPU
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+namespace fruit {
+namespace impl {
+
+constexpr std::size_t PerCpuShards::shard_alignment;
+
+namespace {
+
+// The number of CPUs that the process might ever run on. This includes the ones that are currently offline, since
+// they might come online later and sched_getcpu() could then return their index.
+std::size_t getNumCpus() {
+#if FRUIT_HAS_SCHED_GETCPU
+  long num_cpus = sysconf(_SC_NPROCESSORS_CONF);
+  if (num_cpus > 0) {
+    return num_cpus;
+  }
+#endif
+  unsigned num_threads = std::thread::hardware_concurrency();
+  return num_threads == 0 ? 1 : num_threads;
+}
+
+std::size_t roundUp(std::size_t n, std::size_t alignment) {
+  return (n + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+PerCpuShards::PerCpuShards(std::size_t object_size, std::size_t object_alignment, const construct_t& construct,
+                           destroy_t destroy)
+    : num_shards(getNumCpus()), destroy(destroy) {
+  std::size_t alignment = object_alignment > shard_alignment ? object_alignment : shard_alignment;
+  shard_size = roundUp(object_size == 0 ? 1 : object_size, alignment);
+  memory = new char[num_shards * shard_size + alignment - 1];
+  shards_begin = memory + (roundUp(reinterpret_cast<std::uintptr_t>(memory), alignment) -
+                           reinterpret_cast<std::uintptr_t>(memory));
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+  std::size_t num_constructed_shards = 0;
+  try {
+    for (; num_constructed_shards < num_shards; ++num_constructed_shards) {
+      construct(shards_begin + num_constructed_shards * shard_size);
+    }
+  } catch (...) {
+    // The destructor won't run, so the shards constructed so far must be destroyed here.
+    for (std::size_t i = num_constructed_shards; i > 0; --i) {
+      destroy(shards_begin + (i - 1) * shard_size);
+    }
+    delete[] memory;
+    throw;
+  }
+#else
+  for (std::size_t i = 0; i < num_shards; ++i) {
+    construct(shards_begin + i * shard_size);
+  }
+#endif
+}
+
+PerCpuShards::~PerCpuShards() {
+  for (std::size_t i = num_shards; i > 0; --i) {
+    destroy(shards_begin + (i - 1) * shard_size);
+  }
+  delete[] memory;
+}
+
+void* PerCpuShards::getCurrent() {
+  return getShard(getCurrentShardIndex());
+}
+
+void* PerCpuShards::getShard(std::size_t index) {
+  FruitAssert(index < num_shards);
+  return shards_begin + index * shard_size;
+}
+
+std::size_t PerCpuShards::numShards() const {
+  return num_shards;
+}
+
+std::size_t PerCpuShards::getCurrentShardIndex() const {
+#if FRUIT_HAS_SCHED_GETCPU
+  int cpu = sched_getcpu();
+  if (cpu >= 0) {
+    // The modulo is only needed if CPUs were hot-added after the shards were created.
+    return std::size_t(cpu) % num_shards;
+  }
+#endif
+  // Without a way to know the current CPU, we at least keep different threads on (usually) different shards.
+  return std::hash<std::thread::id>()(std::this_thread::get_id()) % num_shards;
+}
+
+} // namespace impl
+} // namespace fruit
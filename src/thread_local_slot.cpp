@@ -0,0 +1,179 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define IN_FRUIT_CPP_FILE 1
+
+#include <fruit/impl/injector/thread_local_slot.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+namespace fruit {
+namespace impl {
+
+struct ThreadLocalSlot::ControlBlock {
+  // Protects all other fields.
+  std::mutex mutex;
+
+  // False once the slot has been destroyed.
+  bool alive = true;
+
+  destroy_t destroy;
+
+  // The objects (of all threads) that haven't been destroyed yet.
+  std::vector<void*> objects;
+
+  // The number of objects that exiting threads removed from `objects' but haven't finished destroying yet. These are
+  // destroyed without holding the mutex, so the slot's destructor waits for this to become 0 instead.
+  std::size_t num_objects_being_destroyed = 0;
+  std::condition_variable all_objects_destroyed;
+
+  explicit ControlBlock(destroy_t destroy) : destroy(destroy) {}
+};
+
+namespace {
+
+struct PerThreadEntry {
+  // The control block of the slot that this entry belongs to, or nullptr for unused entries.
+  std::shared_ptr<ThreadLocalSlot::ControlBlock> control_block;
+  void* object = nullptr;
+};
+
+struct PerThreadData {
+  // Indexed by ThreadLocalSlot::index.
+  std::vector<PerThreadEntry> entries;
+
+  // Runs at thread exit.
+  ~PerThreadData() {
+    // The destructors of the objects might call get() on other slots, adding entries. So we move the entries out
+    // before destroying the objects, and repeat until no more entries are added.
+    while (!entries.empty()) {
+      std::vector<PerThreadEntry> entries_to_destroy;
+      entries_to_destroy.swap(entries);
+      for (PerThreadEntry& entry : entries_to_destroy) {
+        if (entry.control_block != nullptr) {
+          destroyObject(*entry.control_block, entry.object);
+        }
+      }
+    }
+  }
+
+  static void destroyObject(ThreadLocalSlot::ControlBlock& control_block, void* object) {
+    {
+      std::lock_guard<std::mutex> lock(control_block.mutex);
+      if (!control_block.alive) {
+        // The slot destroyed this object already.
+        return;
+      }
+      control_block.objects.erase(std::find(control_block.objects.begin(), control_block.objects.end(), object));
+      ++control_block.num_objects_being_destroyed;
+    }
+    // This is called without holding the mutex, since the object's destructor might use other slots.
+    control_block.destroy(object);
+    {
+      std::lock_guard<std::mutex> lock(control_block.mutex);
+      --control_block.num_objects_being_destroyed;
+      if (control_block.num_objects_being_destroyed == 0) {
+        control_block.all_objects_destroyed.notify_all();
+      }
+    }
+  }
+};
+
+thread_local PerThreadData per_thread_data;
+
+// The indexes of the slots are shared by all threads, so they must be allocated under a lock.
+struct SlotIndexAllocator {
+  std::mutex mutex;
+  std::vector<std::size_t> free_indexes;
+  std::size_t num_indexes = 0;
+
+  std::size_t allocate() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (free_indexes.empty()) {
+      return num_indexes++;
+    }
+    std::size_t index = free_indexes.back();
+    free_indexes.pop_back();
+    return index;
+  }
+
+  void release(std::size_t index) {
+    std::lock_guard<std::mutex> lock(mutex);
+    free_indexes.push_back(index);
+  }
+};
+
+SlotIndexAllocator& getSlotIndexAllocator() {
+  static SlotIndexAllocator slot_index_allocator;
+  return slot_index_allocator;
+}
+
+} // namespace
+
+ThreadLocalSlot::ThreadLocalSlot(create_t create, destroy_t destroy)
+    : index(getSlotIndexAllocator().allocate()), control_block(std::make_shared<ControlBlock>(destroy)),
+      create(std::move(create)) {}
+
+ThreadLocalSlot::~ThreadLocalSlot() {
+  std::vector<void*> objects_to_destroy;
+  {
+    std::lock_guard<std::mutex> lock(control_block->mutex);
+    control_block->alive = false;
+    objects_to_destroy.swap(control_block->objects);
+  }
+  // As in PerThreadData::destroyObject(), this is done without holding the mutex, since the objects' destructors might
+  // use other slots.
+  for (void* object : objects_to_destroy) {
+    control_block->destroy(object);
+  }
+  {
+    std::unique_lock<std::mutex> lock(control_block->mutex);
+    // Wait for the exiting threads that are destroying their objects, the objects might depend on the injector.
+    control_block->all_objects_destroyed.wait(lock,
+                                              [this] { return control_block->num_objects_being_destroyed == 0; });
+  }
+  getSlotIndexAllocator().release(index);
+}
+
+void* ThreadLocalSlot::get() {
+  std::vector<PerThreadEntry>& entries = per_thread_data.entries;
+  if (index < entries.size() && entries[index].control_block == control_block) {
+    return entries[index].object;
+  }
+  return constructForCurrentThread();
+}
+
+void* ThreadLocalSlot::constructForCurrentThread() {
+  void* object = create();
+  {
+    std::lock_guard<std::mutex> lock(control_block->mutex);
+    control_block->objects.push_back(object);
+  }
+  // create() might have used other slots, so we only look up the entry now (the vector might have been resized).
+  std::vector<PerThreadEntry>& entries = per_thread_data.entries;
+  if (entries.size() <= index) {
+    entries.resize(index + 1);
+  }
+  entries[index].control_block = control_block;
+  entries[index].object = object;
+  return object;
+}
+
+} // namespace impl
+} // namespace fruit
@@ -173,6 +173,9 @@ class TestSemistaticGraph(parameterized.TestCase):
               Assert(graph.at(2).isTerminal() == false);
               Assert(graph.at(3).getNode() == string("bar"));
               Assert(graph.at(3).isTerminal() == false);
+              Assert(graph.at(3).numNeighbors() == 2);
+              Assert(!graph.at(3).isLazyNeighbor(0));
+              Assert(!graph.at(3).isLazyNeighbor(1));
               edge_iterator itr = graph.at(3).neighborsBegin();
               Assert(itr.getNodeIterator(graph.begin()).getNode() == string("foo"));
               Assert(itr.getNodeIterator(graph.begin()).isTerminal() == false);
@@ -216,6 +219,9 @@ class TestSemistaticGraph(parameterized.TestCase):
               Assert(graph.at(2).isTerminal() == false);
               Assert(graph.at(3).getNode() == string("bar"));
               Assert(graph.at(3).isTerminal() == false);
+              Assert(graph.at(3).numNeighbors() == 2);
+              Assert(!graph.at(3).isLazyNeighbor(0));
+              Assert(!graph.at(3).isLazyNeighbor(1));
               edge_iterator itr = graph.at(3).neighborsBegin();
               Assert(itr.getNodeIterator(graph.begin()).getNode() == string("foo"));
               Assert(itr.getNodeIterator(graph.begin()).isTerminal() == false);
@@ -165,6 +165,57 @@ class TestSemistaticMap(parameterized.TestCase):
             source,
             locals())
 
+    def test_many_elems_inserted(self):
+        source = '''
+            int main() {
+              MemoryPool memory_pool;
+              vector<pair<int, int>> values{{1, 10}, {3, 30}, {5, 50}};
+              SemistaticMap<int, int> old_map(values.begin(), values.end(), values.size(), memory_pool);
+              // Many more elements than the buckets of old_map can hold, so most of these end up in the second level.
+              ArenaAllocator<pair<int, int>> allocator(memory_pool);
+              vector<pair<int, int>, ArenaAllocator<pair<int, int>>> new_values(allocator);
+              for (int i = 6; i < 1006; ++i) {
+                new_values.emplace_back(i, i * 10);
+              }
+              SemistaticMap<int, int> map(old_map, std::move(new_values));
+              // Extending a map that already has a second level.
+              vector<pair<int, int>, ArenaAllocator<pair<int, int>>> more_new_values(
+                  {{2, 20}, {4, 40}, {2000, 20000}}, allocator);
+              SemistaticMap<int, int> map2(map, std::move(more_new_values));
+
+              for (int i = 0; i < 3000; ++i) {
+                bool in_old_map = i == 1 || i == 3 || i == 5;
+                bool in_map = in_old_map || (i >= 6 && i < 1006);
+                bool in_map2 = in_map || i == 2 || i == 4 || i == 2000;
+                Assert((old_map.find(i) != nullptr) == in_old_map);
+                Assert((map.find(i) != nullptr) == in_map);
+                Assert((map2.find(i) != nullptr) == in_map2);
+                if (in_map) {
+                  Assert(*map.find(i) == i * 10);
+                  Assert(map.at(i) == i * 10);
+                }
+                if (in_map2) {
+                  Assert(*map2.find(i) == i * 10);
+                  Assert(map2.at(i) == i * 10);
+                }
+              }
+
+              std::size_t num_visited = 0;
+              long long sum = 0;
+              map2.forEach([&](int key, int value) {
+                Assert(value == key * 10);
+                ++num_visited;
+                sum += key;
+              });
+              Assert(num_visited == 1006);
+              Assert(sum == 1 + 2 + 3 + 4 + 5 + (6 + 1005) * 1000 / 2 + 2000);
+            }
+            '''
+        expect_success(
+            COMMON_DEFINITIONS,
+            source,
+            locals())
+
     def test_move_constructor(self):
         source = '''
             int main() {
@@ -61,5 +61,26 @@ class TestGraph(parameterized.TestCase):
             source,
             locals())
 
+    def test_GraphFindLoopFromNodes(self):
+        source = '''
+            int main() {
+              // A -> B
+              // B -> C
+              // C -> B
+              // D -> A
+              AssertSameType(Id<GraphFindLoopFromNodes(Vector<Pair<A, Vector<B>>, Pair<B, Vector<C>>, Pair<C, Vector<B>>, Pair<D, Vector<A>>>, Vector<D>)>, Vector<C, B>);
+
+              // The loop is not reachable from E.
+              AssertSameType(Id<GraphFindLoopFromNodes(Vector<Pair<A, Vector<B>>, Pair<B, Vector<C>>, Pair<C, Vector<B>>, Pair<E, Vector<>>>, Vector<E>)>, None);
+
+              // No start nodes.
+              AssertSameType(Id<GraphFindLoopFromNodes(Vector<Pair<A, Vector<A>>>, Vector<>)>, None);
+            }
+            '''
+        expect_success(
+            COMMON_DEFINITIONS,
+            source,
+            locals())
+
 if __name__ == '__main__':
     absltest.main()
@@ -83,5 +83,21 @@ class TestMetaComponent(parameterized.TestCase):
             source,
             locals())
 
+    def test_AssistedFactoryArgSources(self):
+        source = '''
+            int main() {
+              AssertSame(Vector<>, AssistedFactoryArgSources(Vector<>));
+              AssertSame(Vector<Pair<Bool<false>, Int<0>>>, AssistedFactoryArgSources(Vector<A>));
+              AssertSame(Vector<Pair<Bool<true>, Int<0>>>, AssistedFactoryArgSources(Vector<AssistedA>));
+              AssertSame(Vector<Pair<Bool<true>, Int<0>>, Pair<Bool<false>, Int<0>>, Pair<Bool<true>, Int<1>>,
+                                Pair<Bool<false>, Int<1>>>,
+                         AssistedFactoryArgSources(Vector<AssistedA, A, AssistedB, B>));
+            }
+            '''
+        expect_success(
+            COMMON_DEFINITIONS,
+            source,
+            locals())
+
 if __name__ == '__main__':
     absltest.main()
@@ -158,5 +158,38 @@ class TestBindingCompression(parameterized.TestCase):
             COMMON_DEFINITIONS,
             source)
 
+    def test_no_compression_with_normalized_component_exposing_interface_and_implementation(self):
+        source = '''
+            struct I {
+              virtual ~I() = default;
+            };
+
+            struct C : public I, ConstructionTracker<C> {
+              INJECT(C()) = default;
+            };
+
+            fruit::Component<I, C> getComponent() {
+              return fruit::createComponent()
+                  .bind<I, C>();
+            }
+
+            fruit::Component<> getEmptyComponent() {
+              return fruit::createComponent();
+            }
+
+            int main() {
+              // C is exposed by the NormalizedComponent, so the I->C binding must not be compressed.
+              fruit::NormalizedComponent<I, C> normalizedComponent(getComponent);
+              fruit::Injector<I, C> injector(normalizedComponent, getEmptyComponent);
+
+              C* c = injector.get<C*>();
+              Assert(injector.get<I*>() == c);
+              Assert(C::num_objects_constructed == 1);
+            }
+            '''
+        expect_success(
+            COMMON_DEFINITIONS,
+            source)
+
 if __name__ == '__main__':
     absltest.main()
@@ -170,5 +170,167 @@ class TestClassDestruction(parameterized.TestCase):
             source,
             locals())
 
+    @parameterized.parameters([
+        ('I1', 'I2', 'I3', 'I4', 'X1', 'X2', 'X3', 'X4', 'X5', 'X6', 'X7', 'X8', 'X1*', 'bindInstance(x5)', 'addInstanceMultibinding(*x7)'),
+        ('I1Annot', 'I2Annot', 'I3Annot', 'I4Annot', 'X1Annot', 'X2Annot', 'X3Annot', 'X4Annot', 'X5Annot', 'X6Annot', 'X7Annot', 'X8Annot', 'X1PtrAnnot', 'bindInstance<X5Annot>(x5)', 'addInstanceMultibinding<X7Annot>(*x7)'),
+    ])
+    def test_injector_creation_and_injection_with_concurrent_destruction(self,
+            I1Annot, I2Annot, I3Annot, I4Annot, X1Annot, X2Annot, X3Annot, X4Annot, X5Annot, X6Annot, X7Annot, X8Annot, X1PtrAnnot, bindX5Instance, addX7InstanceMultibinding):
+        source = '''
+            fruit::Component<I1Annot, I2Annot, I3Annot, I4Annot, X5Annot> getComponent() {
+              static X5 x5;
+              static std::unique_ptr<X7> x7(new X7());
+              return fruit::createComponent()
+                  .bind<I1Annot, X1Annot>()
+                  .bind<I2Annot, X2Annot>()
+                  .bind<I3Annot, X3Annot>()
+                  .bind<I4Annot, X4Annot>()
+                  .registerProvider<X3Annot()>([]() { return X3(); })
+                  .registerProvider<X4Annot(X3Annot)>([](X3 x3) { return X4(x3); })
+                  .bindX5Instance
+                  .addMultibinding<I1Annot, X6Annot>()
+                  .addX7InstanceMultibinding
+                  .addMultibindingProvider<X1PtrAnnot()>([]() { return (X1*) new X8(); });
+            }
+            
+            int main() {
+              fruit::Injector<I1Annot, I2Annot, I3Annot, I4Annot, X5Annot> injector(getComponent);
+              injector.enableConcurrentDestruction(4);
+              
+              injector.get<I1Annot>();
+              injector.get<I2Annot>();
+              injector.get<I3Annot>();
+              injector.get<I4Annot>();
+              injector.get<X5Annot>();
+              
+              injector.getMultibindings<I1Annot>();
+            }
+            '''
+        expect_success(
+            COMMON_DEFINITIONS,
+            source,
+            locals())
+
+    def test_concurrent_destruction_destroys_dependents_first(self):
+        source = '''
+            #include <atomic>
+            #include <chrono>
+            #include <thread>
+            
+            std::atomic<int> num_destroyed_y(0);
+            std::atomic<int> num_destroyed_z(0);
+            std::atomic<bool> z0_destroyed(false);
+            std::atomic<bool> w_destroyed(false);
+            
+            struct Y {
+              INJECT(Y()) = default;
+              ~Y() {
+                // Give a chance to other threads to (incorrectly) destroy dependents concurrently.
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                ++num_destroyed_y;
+              }
+            };
+            
+            template <int n>
+            struct Z {
+              Y& y;
+              INJECT(Z(Y& y)) : y(y) {}
+              ~Z() {
+                Assert(num_destroyed_y == 0);
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                if (n == 0) {
+                  Assert(w_destroyed);
+                  z0_destroyed = true;
+                }
+                ++num_destroyed_z;
+              }
+            };
+            
+            struct W {
+              fruit::Provider<Z<1>> z1_provider;
+              INJECT(W(Z<0>&, fruit::Provider<Z<1>> z1_provider)) : z1_provider(z1_provider) {}
+              ~W() {
+                Assert(!z0_destroyed);
+                w_destroyed = true;
+              }
+            };
+            
+            fruit::Component<W, Z<2>> getComponent() {
+              return fruit::createComponent();
+            }
+            
+            int main() {
+              {
+                fruit::Injector<W, Z<2>> injector(getComponent);
+                injector.enableConcurrentDestruction(4);
+                W& w = injector.get<W&>();
+                w.z1_provider.get();
+                injector.get<Z<2>&>();
+              }
+              Assert(w_destroyed);
+              Assert(num_destroyed_z == 3);
+              Assert(num_destroyed_y == 1);
+            }
+            '''
+        expect_success(
+            COMMON_DEFINITIONS,
+            source)
+
+    def test_concurrent_destruction_after_provider_threw(self):
+        source = '''
+            #include <atomic>
+            #include <chrono>
+            #include <stdexcept>
+            #include <thread>
+
+            std::atomic<bool> y_destroyed(false);
+
+            struct X {
+              ~X() {
+                // Y was constructed after X by a separate top-level request, so it must be destroyed first.
+                Assert(y_destroyed);
+              }
+            };
+
+            struct Y {
+              ~Y() {
+                // Give a chance to other threads to (incorrectly) destroy X concurrently.
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                y_destroyed = true;
+              }
+            };
+
+            struct Z {};
+
+            fruit::Component<X, Y, Z> getComponent() {
+              return fruit::createComponent()
+                  .registerProvider([]() { return new X(); })
+                  .registerProvider([]() { return new Y(); })
+                  .registerProvider([]() -> Z* { throw std::runtime_error("Z"); });
+            }
+
+            int main() {
+            #if __cpp_exceptions
+              {
+                fruit::Injector<X, Y, Z> injector(getComponent);
+                injector.enableConcurrentDestruction(4);
+                bool threw = false;
+                try {
+                  injector.get<Z&>();
+                } catch (const std::runtime_error&) {
+                  threw = true;
+                }
+                Assert(threw);
+                injector.get<X&>();
+                injector.get<Y&>();
+              }
+              Assert(y_destroyed);
+            #endif
+            }
+            '''
+        expect_success(
+            COMMON_DEFINITIONS,
+            source)
+
 if __name__ == '__main__':
     absltest.main()
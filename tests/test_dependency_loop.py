@@ -123,6 +123,47 @@ class TestDependencyLoop(parameterized.TestCase):
             source,
             locals())
 
+    def test_loop_closed_by_last_binding(self):
+        source = '''
+            struct X {};
+            struct Y {};
+            struct Z {};
+    
+            fruit::Component<X> mutuallyConstructibleComponent() {
+              return fruit::createComponent()
+                  .registerProvider<X(Y)>([](Y) {return X();})
+                  .registerProvider<Z(X)>([](X) {return Z();})
+                  .registerProvider<Y(Z)>([](Z) {return Y();});
+            }
+            '''
+        expect_compile_error(
+            'SelfLoopError<Z,X,Y>',
+            'Found a loop in the dependencies',
+            COMMON_DEFINITIONS,
+            source)
+
+    def test_loop_through_installed_component(self):
+        source = '''
+            struct X {};
+            struct Y {};
+    
+            fruit::Component<fruit::Required<Y>, X> getXComponent() {
+              return fruit::createComponent()
+                  .registerProvider([](Y) {return X();});
+            }
+    
+            fruit::Component<Y> mutuallyConstructibleComponent() {
+              return fruit::createComponent()
+                  .install(getXComponent)
+                  .registerProvider([](X) {return Y();});
+            }
+            '''
+        expect_compile_error(
+            'SelfLoopError<X,Y>',
+            'Found a loop in the dependencies',
+            COMMON_DEFINITIONS,
+            source)
+
     def test_with_different_annotations_ok(self):
         source = '''
             struct X {};
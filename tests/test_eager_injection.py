@@ -117,5 +117,168 @@ class TestEagerInjection(parameterized.TestCase):
             locals(),
             ignore_deprecation_warnings=True)
 
+    def test_eager_injection_in_slices(self):
+        source = '''
+            struct W {
+              INJECT(W(X*)) {}
+            };
+
+            fruit::Component<X, W> getComponent() {
+              return fruit::createComponent()
+                .addMultibindingProvider([](){return new Y();})
+                .registerConstructor<Z()>();
+            }
+
+            int main() {
+
+              fruit::Injector<X, W> injector(getComponent);
+
+              // With a zero time budget, each call performs exactly one step.
+              fruit::EagerInjectionProgress progress = injector.eagerlyInjectSome(std::chrono::seconds(0));
+              Assert(progress.num_completed_steps == 1);
+              Assert(progress.num_steps == 3);
+              Assert(!progress.isDone());
+              Assert(X::constructed);
+              Assert(!Y::constructed);
+
+              progress = injector.eagerlyInjectSome(std::chrono::seconds(0));
+              Assert(progress.num_completed_steps == 2);
+              Assert(!Y::constructed);
+
+              progress = injector.eagerlyInjectSome(std::chrono::seconds(0));
+              Assert(progress.num_completed_steps == 3);
+              Assert(progress.isDone());
+              Assert(Y::constructed);
+              // Z still not constructed, it's not reachable from Injector<X, W>.
+              Assert(!Z::constructed);
+
+              // Further calls do nothing.
+              progress = injector.eagerlyInjectSome(std::chrono::seconds(0));
+              Assert(progress.num_completed_steps == 3);
+              Assert(progress.isDone());
+
+              return 0;
+            }
+            '''
+        expect_success(
+            COMMON_DEFINITIONS,
+            source,
+            locals())
+
+    def test_eager_injection_in_slices_with_large_time_budget(self):
+        source = '''
+            fruit::Component<X> getComponent() {
+              return fruit::createComponent()
+                .addMultibindingProvider([](){return new Y();})
+                .registerConstructor<Z()>();
+            }
+
+            int main() {
+
+              fruit::Injector<X> injector(getComponent);
+
+              fruit::EagerInjectionProgress progress = injector.eagerlyInjectSome(std::chrono::hours(1));
+              Assert(progress.isDone());
+              Assert(X::constructed);
+              Assert(Y::constructed);
+              Assert(!Z::constructed);
+
+              return 0;
+            }
+            '''
+        expect_success(
+            COMMON_DEFINITIONS,
+            source,
+            locals())
+
+    def test_eager_injection_in_slices_one_object_at_a_time(self):
+        source = '''
+            struct W {
+              INJECT(W(X*)) {
+                Assert(!constructed);
+                constructed = true;
+              }
+
+              static bool constructed;
+            };
+
+            bool W::constructed = false;
+
+            struct V {
+              INJECT(V(W*)) {}
+            };
+
+            fruit::Component<V> getComponent() {
+              return fruit::createComponent()
+                .addMultibindingProvider([](Z*){return new Y();})
+                .registerConstructor<Z()>();
+            }
+
+            int main() {
+              fruit::Injector<V> injector(getComponent);
+
+              // With a zero time budget, each call constructs exactly one object, dependencies first.
+              fruit::EagerInjectionProgress progress = injector.eagerlyInjectSome(std::chrono::seconds(0));
+              Assert(progress.num_completed_steps == 0);
+              Assert(progress.num_steps == 2);
+              Assert(X::constructed);
+              Assert(!W::constructed);
+
+              progress = injector.eagerlyInjectSome(std::chrono::seconds(0));
+              Assert(progress.num_completed_steps == 0);
+              Assert(W::constructed);
+
+              // This constructs V, then stops before the dependency of the multibinding.
+              progress = injector.eagerlyInjectSome(std::chrono::seconds(0));
+              Assert(progress.num_completed_steps == 1);
+              Assert(!Z::constructed);
+
+              progress = injector.eagerlyInjectSome(std::chrono::seconds(0));
+              Assert(progress.num_completed_steps == 1);
+              Assert(Z::constructed);
+              Assert(!Y::constructed);
+
+              progress = injector.eagerlyInjectSome(std::chrono::seconds(0));
+              Assert(progress.isDone());
+              Assert(Y::constructed);
+
+              return 0;
+            }
+            '''
+        expect_success(
+            COMMON_DEFINITIONS,
+            source,
+            locals())
+
+    def test_eager_injection_in_slices_does_not_inject_provider_deps(self):
+        source = '''
+            struct W {
+              INJECT(W(fruit::Provider<X>, Z*)) {}
+            };
+
+            fruit::Component<W> getComponent() {
+              return fruit::createComponent()
+                .addMultibindingProvider([](fruit::Provider<X>){return new Y();})
+                .registerConstructor<Z()>();
+            }
+
+            int main() {
+              fruit::Injector<W> injector(getComponent);
+
+              while (!injector.eagerlyInjectSome(std::chrono::seconds(0)).isDone()) {
+              }
+              Assert(Y::constructed);
+              Assert(Z::constructed);
+              // Only injected through a Provider.
+              Assert(!X::constructed);
+
+              return 0;
+            }
+            '''
+        expect_success(
+            COMMON_DEFINITIONS,
+            source,
+            locals())
+
 if __name__ == '__main__':
     absltest.main()
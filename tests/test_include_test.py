@@ -21,12 +21,15 @@ COMMON_DEFINITIONS = '''
 
 FRUIT_PUBLIC_HEADERS = [
     "component.h",
+    "eager_injection_progress.h",
     "fruit.h",
     "fruit_forward_decls.h",
     "injector.h",
+    "injector_buffer.h",
     "macro.h",
     "normalized_component.h",
     "provider.h",
+    "type_allocation_stats.h",
 ]
 
 class TestHeaders(parameterized.TestCase):
@@ -40,5 +43,32 @@ class TestHeaders(parameterized.TestCase):
             source,
             locals())
 
+    def test_forward_decls_header_enough_to_declare_component_functions(self):
+        source = '''
+            #include <fruit/fruit_forward_decls.h>
+
+            struct X;
+            struct Y;
+            struct Annotation1;
+
+            fruit::Component<fruit::Required<X>, fruit::Annotated<Annotation1, Y>> getYComponent();
+
+            #include <fruit/fruit.h>
+
+            struct X {};
+            struct Y {
+              INJECT(Y(X)) {}
+            };
+
+            fruit::Component<fruit::Required<X>, fruit::Annotated<Annotation1, Y>> getYComponent() {
+              return fruit::createComponent()
+                  .registerConstructor<fruit::Annotated<Annotation1, Y>(X)>();
+            }
+            '''
+        expect_success(
+            COMMON_DEFINITIONS,
+            source,
+            locals())
+
 if __name__ == '__main__':
     absltest.main()
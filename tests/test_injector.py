@@ -221,6 +221,711 @@ class TestInjector(parameterized.TestCase):
             source,
             locals())
 
+    def test_single_threaded_injector(self):
+        source = '''
+            struct X {
+              using Inject = X();
+            };
+
+            fruit::Component<X> getComponent() {
+              return fruit::createComponent()
+                  .addInstanceMultibinding(*(new int(5)));
+            }
+
+            int main() {
+              fruit::Injector<X> injector(fruit::SingleThreaded(), getComponent);
+
+              X& x = injector.get<X&>();
+              fruit::Provider<X> provider = injector.get<fruit::Provider<X>>();
+              Assert(&x == provider.get<X*>());
+              Assert(injector.getMultibindings<int>().size() == 1);
+            }
+            '''
+        expect_success(
+            COMMON_DEFINITIONS,
+            source)
+
+    def test_single_threaded_injector_with_normalized_component(self):
+        source = '''
+            struct X {
+              using Inject = X();
+            };
+
+            fruit::Component<X> getComponent() {
+              return fruit::createComponent();
+            }
+
+            fruit::Component<> getEmptyComponent() {
+              return fruit::createComponent();
+            }
+
+            int main() {
+              fruit::NormalizedComponent<X> normalizedComponent(getComponent);
+              fruit::Injector<X> injector(fruit::SingleThreaded(), normalizedComponent, getEmptyComponent);
+
+              X* x = injector.get<X*>();
+              Assert(x == &injector.get<X&>());
+            }
+            '''
+        expect_success(
+            COMMON_DEFINITIONS,
+            source)
+
+    @parameterized.parameters([
+        ('fruit::InjectorBuffer{buffer, sizeof(buffer)}'),
+        ('fruit::SingleThreaded(), fruit::InjectorBuffer{buffer, sizeof(buffer)}'),
+    ])
+    def test_injector_with_buffer(self, BufferArgs):
+        source = '''
+            struct Y {
+              using Inject = Y();
+              std::shared_ptr<int> p = std::make_shared<int>(3);
+            };
+
+            struct X {
+              using Inject = X(Y&);
+              X(Y& y) : y(y) {}
+              Y& y;
+              std::shared_ptr<int> p = std::make_shared<int>(4);
+            };
+
+            fruit::Component<X> getComponent() {
+              return fruit::createComponent();
+            }
+
+            fruit::Component<> getEmptyComponent() {
+              return fruit::createComponent();
+            }
+
+            int main() {
+              fruit::NormalizedComponent<X> normalizedComponent(getComponent);
+              std::size_t required_buffer_size;
+              {
+                fruit::Injector<X> injector(normalizedComponent, getEmptyComponent);
+                required_buffer_size = injector.getRequiredBufferSize();
+              }
+              Assert(required_buffer_size <= 1024);
+
+              char buffer[1024];
+              fruit::Injector<X> injector(BufferArgs, normalizedComponent, getEmptyComponent);
+              Assert(injector.getRequiredBufferSize() == required_buffer_size);
+              X* x = injector.get<X*>();
+              Assert((char*)x >= buffer && (char*)x < buffer + sizeof(buffer));
+              Assert((char*)&x->y >= buffer && (char*)&x->y < buffer + sizeof(buffer));
+            }
+            '''
+        expect_success(
+            COMMON_DEFINITIONS,
+            source,
+            locals())
+
+    def test_injector_with_too_small_buffer(self):
+        source = '''
+            struct X {
+              using Inject = X();
+              std::shared_ptr<int> p = std::make_shared<int>(3);
+            };
+
+            fruit::Component<X> getComponent() {
+              return fruit::createComponent();
+            }
+
+            fruit::Component<> getEmptyComponent() {
+              return fruit::createComponent();
+            }
+
+            int main() {
+              fruit::NormalizedComponent<X> normalizedComponent(getComponent);
+              char buffer[1];
+              fruit::Injector<X> injector(fruit::InjectorBuffer{buffer, sizeof(buffer)}, normalizedComponent,
+                                          getEmptyComponent);
+            }
+            '''
+        expect_runtime_error(
+            r'Fatal injection error: The InjectorBuffer passed to the Injector constructor is too small: it has 1 bytes but this injector needs [0-9]+ bytes \(see Injector::getRequiredBufferSize\(\)\).',
+            COMMON_DEFINITIONS,
+            source)
+
+    def test_allocation_tracking(self):
+        source = '''
+            // The tracked "allocations" are simulated by the constructors below, so that the expected numbers don't
+            // depend on the heap allocations performed by Fruit and by the standard library.
+            std::size_t num_allocated_bytes = 0;
+
+            std::size_t getAllocatedBytes() {
+              return num_allocated_bytes;
+            }
+
+            struct Y {
+              INJECT(Y()) {
+                num_allocated_bytes += 10;
+              }
+            };
+
+            struct Z {
+              INJECT(Z()) {
+                num_allocated_bytes += 1;
+              }
+            };
+
+            struct X {
+              INJECT(X(Y&, fruit::Provider<Z> z_provider)) {
+                num_allocated_bytes += 100;
+                z_provider.get();
+                num_allocated_bytes += 200;
+              }
+            };
+
+            struct W {};
+
+            fruit::Component<X> getComponent() {
+              return fruit::createComponent()
+                  .addMultibindingProvider([]() { num_allocated_bytes += 5; return new W(); })
+                  .addMultibindingProvider([]() { num_allocated_bytes += 7; return new W(); });
+            }
+
+            int main() {
+              fruit::Injector<X> injector(getComponent);
+              injector.enableAllocationTracking(getAllocatedBytes);
+              injector.get<X&>();
+              injector.getMultibindings<W>();
+
+              std::vector<fruit::TypeAllocationStats> stats = injector.getTopAllocatingTypes(10);
+              Assert(stats.size() == 4);
+              Assert(stats[0].type_name == "X" && !stats[0].is_multibinding && stats[0].num_bytes == 300);
+              Assert(stats[1].type_name == "W" && stats[1].is_multibinding && stats[1].num_bytes == 12);
+              Assert(stats[2].type_name == "Y" && !stats[2].is_multibinding && stats[2].num_bytes == 10);
+              Assert(stats[3].type_name == "Z" && !stats[3].is_multibinding && stats[3].num_bytes == 1);
+
+              Assert(injector.getTopAllocatingTypes(2).size() == 2);
+            }
+            '''
+        expect_success(
+            COMMON_DEFINITIONS,
+            source)
+
+    def test_allocation_tracking_excludes_other_instrumentation(self):
+        source = '''
+            #include <cstdlib>
+            #include <new>
+
+            std::size_t num_allocated_bytes = 0;
+
+            void* operator new(std::size_t n) {
+              num_allocated_bytes += n;
+              void* p = std::malloc(n == 0 ? 1 : n);
+              if (p == nullptr) {
+                throw std::bad_alloc();
+              }
+              return p;
+            }
+
+            void operator delete(void* p) noexcept {
+              std::free(p);
+            }
+
+            #if __cpp_sized_deallocation
+            void operator delete(void* p, std::size_t) noexcept {
+              std::free(p);
+            }
+            #endif
+
+            std::size_t getAllocatedBytes() {
+              return num_allocated_bytes;
+            }
+
+            struct Y {
+              INJECT(Y()) = default;
+            };
+
+            struct X {
+              INJECT(X(Y&)) {
+                delete[] new char[100];
+              }
+            };
+
+            fruit::Component<X> getComponent() {
+              return fruit::createComponent();
+            }
+
+            int main() {
+              fruit::Injector<X> injector(getComponent);
+              // The destruction graph allocates memory when recording each construction, that must not be attributed
+              // to X (or Y).
+              injector.enableConcurrentDestruction(4);
+              injector.enableAllocationTracking(getAllocatedBytes);
+              injector.get<X&>();
+
+              std::vector<fruit::TypeAllocationStats> stats = injector.getTopAllocatingTypes(10);
+              Assert(stats.size() == 1);
+              Assert(stats[0].type_name == "X" && stats[0].num_bytes == 100);
+            }
+            '''
+        expect_success(
+            COMMON_DEFINITIONS,
+            source)
+
+    def test_allocation_tracking_not_enabled_error(self):
+        source = '''
+            struct X {
+              INJECT(X()) = default;
+            };
+
+            fruit::Component<X> getComponent() {
+              return fruit::createComponent();
+            }
+
+            int main() {
+              fruit::Injector<X> injector(getComponent);
+              injector.get<X&>();
+              injector.getTopAllocatingTypes(10);
+            }
+            '''
+        expect_runtime_error(
+            r'Fatal injection error: getTopAllocatingTypes\(\) was called but allocation tracking was not enabled.',
+            COMMON_DEFINITIONS,
+            source)
+
+    def test_stats_export(self):
+        source = '''
+            #if FRUIT_HAS_POSIX_SHARED_MEMORY
+            #include <fruit/impl/injector/injector_stats_segment.h>
+            #include <cstring>
+            #include <string>
+            #include <fcntl.h>
+            #include <sys/mman.h>
+            #include <unistd.h>
+
+            using fruit::impl::InjectorStatsSegment;
+
+            struct Y {
+              INJECT(Y()) = default;
+            };
+
+            struct X {
+              INJECT(X(Y&)) {}
+            };
+
+            struct W {};
+
+            fruit::Component<X> getComponent() {
+              return fruit::createComponent()
+                  .addMultibindingProvider([]() { return new W(); })
+                  .addMultibindingProvider([]() { return new W(); });
+            }
+
+            // Maps the segment as a separate process would.
+            const InjectorStatsSegment::Header* mapSegment(const std::string& segment_name) {
+              int fd = shm_open(segment_name.c_str(), O_RDONLY, 0);
+              Assert(fd >= 0);
+              void* p = mmap(nullptr, InjectorStatsSegment::getSegmentSize(3), PROT_READ, MAP_SHARED, fd, 0);
+              close(fd);
+              Assert(p != MAP_FAILED);
+              return static_cast<const InjectorStatsSegment::Header*>(p);
+            }
+
+            const InjectorStatsSegment::BindingSlot* findSlot(const InjectorStatsSegment::Header* header,
+                                                              const char* type_name) {
+              const InjectorStatsSegment::BindingSlot* slots = InjectorStatsSegment::getBindingSlots(header);
+              for (std::size_t i = 0; i < header->num_binding_slots; ++i) {
+                if (std::strcmp(slots[i].type_name, type_name) == 0) {
+                  return &slots[i];
+                }
+              }
+              Assert(false);
+              return nullptr;
+            }
+
+            int main() {
+              std::string segment_name = "/fruit_test_stats_" + std::to_string(getpid());
+              {
+                fruit::Injector<X> injector(getComponent);
+                injector.enableStatsExport(segment_name);
+                const InjectorStatsSegment::Header* header = mapSegment(segment_name);
+                Assert(header->magic.load() == InjectorStatsSegment::magic_value);
+                Assert(header->version == InjectorStatsSegment::current_version);
+                Assert(header->num_binding_slots == 3);
+                Assert(header->num_constructions.load() == 0);
+                Assert(header->arena_capacity_bytes.load() == injector.getRequiredBufferSize());
+
+                injector.get<X&>();
+                injector.get<X&>();
+                injector.getMultibindings<W>();
+
+                Assert(header->num_constructions.load() == 4);
+                Assert(header->num_lock_acquisitions.load() >= 3);
+                Assert(header->arena_used_bytes.load() <= header->arena_capacity_bytes.load());
+                Assert(findSlot(header, "X")->num_constructions.load() == 1);
+                Assert(!findSlot(header, "X")->is_multibinding);
+                Assert(findSlot(header, "Y")->num_constructions.load() == 1);
+                Assert(findSlot(header, "W")->num_constructions.load() == 2);
+                Assert(findSlot(header, "W")->is_multibinding);
+              }
+              // The segment is removed when the injector is destroyed.
+              Assert(shm_open(segment_name.c_str(), O_RDONLY, 0) < 0);
+
+              {
+                fruit::Injector<X> injector(getComponent);
+                injector.enableStatsExport(segment_name);
+                // Someone else replaces the segment: the injector must not remove the new one.
+                Assert(shm_unlink(segment_name.c_str()) == 0);
+                int fd = shm_open(segment_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+                Assert(fd >= 0);
+                close(fd);
+              }
+              int fd = shm_open(segment_name.c_str(), O_RDONLY, 0);
+              Assert(fd >= 0);
+              close(fd);
+              shm_unlink(segment_name.c_str());
+            }
+            #else
+            int main() {}
+            #endif
+            '''
+        expect_success(
+            COMMON_DEFINITIONS,
+            source)
+
+    def test_stats_export_segment_already_exists_error(self):
+        source = '''
+            #if FRUIT_HAS_POSIX_SHARED_MEMORY
+            #include <string>
+            #include <fcntl.h>
+            #include <sys/mman.h>
+            #include <unistd.h>
+            #endif
+
+            struct X {
+              INJECT(X()) = default;
+            };
+
+            fruit::Component<X> getComponent() {
+              return fruit::createComponent();
+            }
+
+            int main() {
+            #if FRUIT_HAS_POSIX_SHARED_MEMORY
+              std::string segment_name = "/fruit_test_stats_" + std::to_string(getpid());
+              int fd = shm_open(segment_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+              Assert(fd >= 0);
+              close(fd);
+              // Removed at exit, since the injector won't remove a segment that it didn't create.
+              static std::string segment_name_to_remove = segment_name;
+              atexit([]() { shm_unlink(segment_name_to_remove.c_str()); });
+
+              fruit::Injector<X> injector(getComponent);
+              injector.enableStatsExport(segment_name);
+            #else
+              fruit::impl::InjectorStorage::fatal("enableStatsExport() couldn't create the shared memory segment because it already exists.");
+            #endif
+            }
+            '''
+        expect_runtime_error(
+            r'Fatal injection error: enableStatsExport\(\) couldn.t create the shared memory segment .* because it already exists.',
+            COMMON_DEFINITIONS,
+            source)
+
+    def test_compact(self):
+        source = '''
+            struct Y {
+              static int num_constructed;
+              INJECT(Y()) {
+                ++num_constructed;
+              }
+            };
+            int Y::num_constructed = 0;
+
+            struct X {
+              fruit::Provider<Y> y_provider;
+              INJECT(X(fruit::Provider<Y> y_provider)) : y_provider(y_provider) {
+                y_provider.get();
+              }
+            };
+
+            struct Z {
+              INJECT(Z(X&)) {}
+            };
+
+            struct W {
+              int n;
+            };
+
+            fruit::Component<X, const Z> getComponent() {
+              return fruit::createComponent()
+                  .addMultibindingProvider([](X&) { return W{1}; })
+                  .addMultibindingProvider([]() { return W{2}; });
+            }
+
+            fruit::Component<> getEmptyComponent() {
+              return fruit::createComponent();
+            }
+
+            template <typename Injector>
+            void checkCompact(Injector& injector) {
+              injector.compact();
+              // Calling it again does nothing.
+              injector.compact();
+              X& x = injector.template get<X&>();
+              Assert(&x == injector.template get<X*>());
+              Assert(&x == injector.template get<fruit::Provider<X>>().get());
+              injector.template get<const Z&>();
+              x.y_provider.get();
+              const std::vector<W*>& w_vector = injector.template getMultibindings<W>();
+              Assert(w_vector.size() == 2);
+              Assert(w_vector[0]->n + w_vector[1]->n == 3);
+              Assert(injector.template getMultibindings<Y>().empty());
+            }
+
+            int main() {
+              {
+                fruit::Injector<X, const Z> injector(getComponent);
+                checkCompact(injector);
+              }
+              {
+                fruit::NormalizedComponent<X, const Z> normalized_component(getComponent);
+                fruit::Injector<X, const Z> injector(normalized_component, getEmptyComponent);
+                checkCompact(injector);
+              }
+              Assert(Y::num_constructed == 2);
+            }
+            '''
+        expect_success(
+            COMMON_DEFINITIONS,
+            source)
+
+    def test_compact_provider_for_object_not_constructed_error(self):
+        source = '''
+            struct Y {
+              INJECT(Y()) = default;
+            };
+
+            struct X {
+              fruit::Provider<Y> y_provider;
+              INJECT(X(fruit::Provider<Y> y_provider)) : y_provider(y_provider) {}
+            };
+
+            fruit::Component<X> getComponent() {
+              return fruit::createComponent();
+            }
+
+            int main() {
+              fruit::Injector<X> injector(getComponent);
+              injector.compact();
+              injector.get<X&>().y_provider.get();
+            }
+            '''
+        expect_runtime_error(
+            r'Fatal injection error: attempted to construct an object using a Provider obtained before compact\(\) was '
+            r'called on the injector.',
+            COMMON_DEFINITIONS,
+            source)
+
+    def test_generational_injector_reuses_unchanged_objects(self):
+        source = '''
+            struct Config {
+              int n;
+            };
+
+            struct Y {
+              static int num_constructed;
+              INJECT(Y()) {
+                ++num_constructed;
+              }
+            };
+            int Y::num_constructed = 0;
+
+            struct Z {
+              static int num_constructed;
+              int n;
+              Z(int n) : n(n) {
+                ++num_constructed;
+              }
+            };
+            int Z::num_constructed = 0;
+
+            struct X {
+              static int num_constructed;
+              Y* y;
+              Z* z;
+              INJECT(X(Y* y, Z* z)) : y(y), z(z) {
+                ++num_constructed;
+              }
+            };
+            int X::num_constructed = 0;
+
+            struct W {
+              static int num_constructed;
+              INJECT(W(fruit::Provider<Y>)) {
+                ++num_constructed;
+              }
+            };
+            int W::num_constructed = 0;
+
+            fruit::Component<X, W> getComponent(const Config* config) {
+              return fruit::createComponent()
+                  .bindInstance(*config)
+                  .registerProvider([](const Config& config) { return Z(config.n); });
+            }
+
+            int main() {
+              Config config1{1};
+              Config config2{2};
+              fruit::GenerationalInjector<X, W> injector(getComponent, &config1);
+              std::shared_ptr<fruit::Injector<X, W>> generation1 = injector.current();
+              X* x1 = generation1->get<X*>();
+              generation1->get<W*>();
+
+              // Nothing changed, so all objects are reused except W (that obtained a Provider).
+              injector.reload(getComponent, &config1);
+              std::shared_ptr<fruit::Injector<X, W>> generation2 = injector.current();
+              Assert(generation2 != generation1);
+              Assert(generation2->get<X*>() == x1);
+              generation2->get<W*>();
+              Assert(X::num_constructed == 1);
+              Assert(W::num_constructed == 2);
+
+              // Z depends on the config, and X depends on Z; Y can still be reused.
+              Y* y1 = x1->y;
+              generation1.reset();
+              injector.reload(getComponent, &config2);
+              generation2.reset();
+              X* x3 = injector.current()->get<X*>();
+              Assert(x3->y == y1);
+              Assert(x3->z->n == 2);
+              Assert(X::num_constructed == 2);
+              Assert(Y::num_constructed == 1);
+              Assert(Z::num_constructed == 2);
+            }
+            '''
+        expect_success(
+            COMMON_DEFINITIONS,
+            source)
+
+    def test_generational_injector_destroys_superseded_objects(self):
+        source = '''
+            struct Config {
+              int n;
+            };
+
+            struct Y {
+              static int num_alive;
+              INJECT(Y()) {
+                ++num_alive;
+              }
+              ~Y() {
+                --num_alive;
+              }
+            };
+            int Y::num_alive = 0;
+
+            struct X {
+              static int num_alive;
+              Y* y;
+              const Config& config;
+              INJECT(X(Y* y, const Config& config)) : y(y), config(config) {
+                ++num_alive;
+              }
+              ~X() {
+                Assert(Y::num_alive == 1);
+                --num_alive;
+              }
+            };
+            int X::num_alive = 0;
+
+            struct W {
+              static int num_alive;
+              Y* y;
+              INJECT(W(Y* y)) : y(y) {
+                ++num_alive;
+              }
+              ~W() {
+                Assert(Y::num_alive == 1);
+                --num_alive;
+              }
+            };
+            int W::num_alive = 0;
+
+            fruit::Component<X, W> getComponent(const Config* config) {
+              return fruit::createComponent()
+                  .bindInstance(*config);
+            }
+
+            int main() {
+              Config configs[10];
+              fruit::GenerationalInjector<X, W> injector(getComponent, &configs[0]);
+              Y* y = injector.current()->get<X*>()->y;
+              for (int i = 1; i < 10; ++i) {
+                injector.reload(getComponent, &configs[i]);
+                std::shared_ptr<fruit::Injector<X, W>> generation = injector.current();
+                Assert(generation->get<X*>()->y == y);
+                // The previous generations have been destroyed, together with their X (even if their Y was reused).
+                Assert(X::num_alive == 1);
+                if (i == 5) {
+                  // Constructed by this generation and then reused by all the following ones.
+                  generation->get<W*>();
+                }
+              }
+              Assert(X::num_alive == 1);
+              Assert(Y::num_alive == 1);
+              Assert(W::num_alive == 1);
+
+              // A generation that is no longer current is destroyed when its last user releases it.
+              std::shared_ptr<fruit::Injector<X, W>> generation = injector.current();
+              injector.reload(getComponent, &configs[0]);
+              Assert(X::num_alive == 1);
+              generation.reset();
+              Assert(X::num_alive == 0);
+              Assert(Y::num_alive == 1);
+              Assert(W::num_alive == 1);
+            }
+            '''
+        expect_success(
+            COMMON_DEFINITIONS,
+            source)
+
+    def test_generational_injector_with_normalized_component(self):
+        source = '''
+            struct Y {
+              static int num_constructed;
+              INJECT(Y()) {
+                ++num_constructed;
+              }
+            };
+            int Y::num_constructed = 0;
+
+            struct X {
+              Y* y;
+              int n;
+              X(Y* y, int n) : y(y), n(n) {}
+            };
+
+            fruit::Component<Y> getYComponent() {
+              return fruit::createComponent();
+            }
+
+            fruit::Component<X> getXComponent(int* n) {
+              return fruit::createComponent()
+                  .bindInstance(*n)
+                  .registerProvider([](Y* y, int& n) { return X(y, n); });
+            }
+
+            int main() {
+              fruit::NormalizedComponent<Y> normalizedComponent(getYComponent);
+              int n1 = 1;
+              int n2 = 2;
+              fruit::GenerationalInjector<X> injector(normalizedComponent, getXComponent, &n1);
+              X* x1 = injector.current()->get<X*>();
+              injector.reload(normalizedComponent, getXComponent, &n2);
+              X* x2 = injector.current()->get<X*>();
+              Assert(x2->n == 2);
+              Assert(x2->y == x1->y);
+              Assert(Y::num_constructed == 1);
+            }
+            '''
+        expect_success(
+            COMMON_DEFINITIONS,
+            source)
+
     @parameterized.parameters([
         ('const X', 'X'),
         ('const X', 'const X&'),
@@ -1065,5 +1065,59 @@ class TestInstall(parameterized.TestCase):
             source,
             locals())
 
+    def test_install_components_with_different_numbers_of_bindings(self):
+        source = '''
+            struct X {
+              int n;
+              X(int n) : n(n) {}
+            };
+
+            struct Y {
+              int n;
+              Y(int n) : n(n) {}
+            };
+
+            struct Z {
+              INJECT(Z(X x, Y y)) : n(x.n + y.n) {}
+              int n;
+            };
+
+            fruit::Component<X> getXComponent(X* x) {
+              return fruit::createComponent()
+                .bindInstance(*x)
+                .addInstanceMultibinding(*x);
+            }
+
+            fruit::Component<Y> getYComponent() {
+              return fruit::createComponent()
+                .registerProvider([]() { return Y(10); });
+            }
+
+            fruit::Component<Z> getZComponent(X* x) {
+              return fruit::createComponent()
+                .install(getXComponent, x)
+                .install(getYComponent);
+            }
+
+            fruit::Component<Z> getRootComponent(X* x) {
+              return fruit::createComponent()
+                .install(getZComponent, x)
+                .install(getYComponent);
+            }
+
+            int main() {
+              X x(5);
+              for (int i = 0; i < 3; i++) {
+                fruit::Injector<Z> injector(getRootComponent, &x);
+                Assert(injector.get<Z>().n == 15);
+                Assert(injector.getMultibindings<X>().size() == 1);
+              }
+            }
+            '''
+        expect_success(
+            COMMON_DEFINITIONS,
+            source,
+            locals())
+
 if __name__ == '__main__':
     absltest.main()
@@ -203,5 +203,211 @@ class TestNormalizedComponent(parameterized.TestCase):
             source,
             locals())
 
+    @parameterized.parameters([
+        ('X', 'X', 'Y', 'Y', 'Y*'),
+        ('fruit::Annotated<Annotation1, X>', 'ANNOTATED(Annotation1, X)', 'fruit::Annotated<Annotation2, Y>',
+         'ANNOTATED(Annotation2, Y)', 'fruit::Annotated<Annotation2, Y*>'),
+    ])
+    def test_slice_success(self, XAnnot, X_ANNOT, YAnnot, Y_ANNOT, YPtrAnnot):
+        source = '''
+            struct X {};
+
+            struct Interface {
+              virtual ~Interface() = default;
+            };
+
+            struct Impl : public Interface {
+              INJECT(Impl()) = default;
+            };
+
+            struct Y {
+              Interface* interface;
+              INJECT(Y(X_ANNOT, Interface* interface)) : interface(interface) {}
+            };
+
+            struct Z {
+              static int num_objects_constructed;
+              char data[1000];
+              INJECT(Z(Y_ANNOT)) {
+                ++num_objects_constructed;
+              }
+            };
+
+            int Z::num_objects_constructed = 0;
+
+            struct W {
+              INJECT(W()) = default;
+            };
+
+            struct Plugin {
+              INJECT(Plugin()) = default;
+            };
+
+            fruit::Component<fruit::Required<XAnnot>, YAnnot, Z, W> getComponent() {
+              return fruit::createComponent()
+                .bind<Interface, Impl>()
+                .addMultibinding<Plugin, Plugin>();
+            }
+
+            fruit::Component<XAnnot> getXComponent(X* x) {
+              return fruit::createComponent()
+                .bindInstance<XAnnot, X>(*x);
+            }
+
+            int main() {
+              using ParentNormalizedComponent = fruit::NormalizedComponent<fruit::Required<XAnnot>, YAnnot, Z, W>;
+              std::unique_ptr<ParentNormalizedComponent> normalized_component(
+                  new ParentNormalizedComponent(getComponent));
+              fruit::NormalizedComponent<fruit::Required<XAnnot>, YAnnot> slice(*normalized_component);
+              fruit::NormalizedComponent<fruit::Required<XAnnot>, YAnnot, Z> other_slice(*normalized_component);
+
+              X x{};
+              std::size_t parent_buffer_size;
+              {
+                fruit::Injector<YAnnot, Z> injector(*normalized_component, getXComponent, &x);
+                parent_buffer_size = injector.getRequiredBufferSize();
+                Assert(injector.getMultibindings<Plugin>().size() == 1);
+              }
+              // The slices don't depend on the parent.
+              normalized_component.reset();
+
+              {
+                fruit::Injector<YAnnot> injector(slice, getXComponent, &x);
+                Y* y = injector.get<YPtrAnnot>();
+                Assert(y->interface != nullptr);
+                Assert(injector.getRequiredBufferSize() < parent_buffer_size);
+                // Multibindings are not kept in slices.
+                Assert(injector.getMultibindings<Plugin>().empty());
+              }
+
+              {
+                fruit::Injector<Z> injector(other_slice, getXComponent, &x);
+                injector.get<Z*>();
+                Assert(Z::num_objects_constructed == 1);
+              }
+
+              // A slice can be sliced further.
+              fruit::NormalizedComponent<fruit::Required<XAnnot>, Z> slice_of_slice(other_slice);
+              {
+                fruit::Injector<Z> injector(slice_of_slice, getXComponent, &x);
+                injector.get<Z*>();
+                Assert(Z::num_objects_constructed == 2);
+              }
+            }
+            '''
+        expect_success(
+            COMMON_DEFINITIONS,
+            source,
+            locals())
+
+    def test_slice_with_parent_component_installed_again(self):
+        source = '''
+            struct X {
+              INJECT(X()) = default;
+            };
+
+            struct Interface {
+              virtual ~Interface() = default;
+            };
+
+            struct Impl : public Interface {
+              INJECT(Impl()) = default;
+            };
+
+            struct Y {
+              Interface* interface;
+              INJECT(Y(Interface* interface)) : interface(interface) {}
+            };
+
+            struct Plugin {
+              INJECT(Plugin()) = default;
+            };
+
+            fruit::Component<X, Interface> getXComponent() {
+              return fruit::createComponent()
+                .bind<Interface, Impl>()
+                .addMultibinding<Plugin, Plugin>();
+            }
+
+            fruit::Component<X, Y> getParentComponent() {
+              return fruit::createComponent()
+                .install(getXComponent);
+            }
+
+            int main() {
+              fruit::NormalizedComponent<X, Y> normalized_component(getParentComponent);
+              fruit::NormalizedComponent<Y> slice(normalized_component);
+
+              // The slice doesn't have the binding for X, so getXComponent must be expanded again here.
+              fruit::Injector<X, Y> injector(slice, getXComponent);
+              Assert(injector.get<X*>() != nullptr);
+              Assert(injector.get<Y*>()->interface != nullptr);
+              Assert(injector.getMultibindings<Plugin>().size() == 1);
+            }
+            '''
+        expect_success(
+            COMMON_DEFINITIONS,
+            source,
+            locals())
+
+    @parameterized.parameters([
+        ('X', 'Y'),
+        ('fruit::Annotated<Annotation1, X>', 'fruit::Annotated<Annotation2, Y>'),
+    ])
+    def test_slice_type_not_provided_error(self, XAnnot, YAnnot):
+        source = '''
+            struct X {};
+            struct Y {};
+
+            void f(fruit::NormalizedComponent<XAnnot>& normalized_component) {
+              fruit::NormalizedComponent<YAnnot> slice(normalized_component);
+            }
+            '''
+        expect_compile_error(
+            r'TypesInNormalizedComponentSliceNotProvidedError<YAnnot>',
+            r'The types in TypesNotProvided are declared as provided by the sliced NormalizedComponent, but the NormalizedComponent that it.s sliced from doesn.t provide them.',
+            COMMON_DEFINITIONS,
+            source,
+            locals())
+
+    @parameterized.parameters([
+        ('X', 'const X'),
+        ('fruit::Annotated<Annotation1, X>', 'fruit::Annotated<Annotation1, const X>'),
+    ])
+    def test_slice_type_provided_as_const_only_error(self, XAnnot, ConstXAnnot):
+        source = '''
+            struct X {};
+
+            void f(fruit::NormalizedComponent<ConstXAnnot, int>& normalized_component) {
+              fruit::NormalizedComponent<XAnnot> slice(normalized_component);
+            }
+            '''
+        expect_compile_error(
+            r'TypesInNormalizedComponentSliceProvidedAsConstOnlyError<XAnnot>',
+            r'The types in TypesProvidedAsConstOnly are declared as non-const provided types by the sliced NormalizedComponent',
+            COMMON_DEFINITIONS,
+            source,
+            locals())
+
+    @parameterized.parameters([
+        ('X', 'Y'),
+        ('fruit::Annotated<Annotation1, X>', 'fruit::Annotated<Annotation2, Y>'),
+    ])
+    def test_slice_missing_requirements_error(self, XAnnot, YAnnot):
+        source = '''
+            struct X {};
+            struct Y {};
+
+            void f(fruit::NormalizedComponent<fruit::Required<XAnnot>, YAnnot, int>& normalized_component) {
+              fruit::NormalizedComponent<YAnnot> slice(normalized_component);
+            }
+            '''
+        expect_compile_error(
+            r'NormalizedComponentSliceWithMissingRequirementsError<XAnnot>',
+            r'The types in MissingRequirements are required by the NormalizedComponent that the slice is created from',
+            COMMON_DEFINITIONS,
+            source,
+            locals())
+
 if __name__ == '__main__':
     absltest.main()
@@ -195,9 +195,11 @@ class TestRegisterConstructor(parameterized.TestCase):
             }
             '''
         if re.search('GNU', CXX_COMPILER_NAME) is not None:
+            # Since C++17, GCC allows the abstract return type in X(int*), so Fruit reports the error instead.
             expect_generic_compile_error(
                 'invalid abstract return type'
-                '|.X.: cannot instantiate abstract class',
+                '|.X.: cannot instantiate abstract class'
+                '|The specified class can.t be constructed because it.s an abstract class',
                 COMMON_DEFINITIONS,
                 source)
         else:
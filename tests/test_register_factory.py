@@ -2304,5 +2304,180 @@ class TestRegisterFactory(parameterized.TestCase):
             ignore_warnings=True,
             disable_error_line_number_check=True)
 
+    @parameterized.parameters([
+        ('Scaler',
+         'std::function<std::shared_ptr<Scaler>(double)>'),
+        ('fruit::Annotated<Annotation1, Scaler>',
+         'fruit::Annotated<Annotation1, std::function<std::shared_ptr<Scaler>(double)>>'),
+    ])
+    def test_register_memoized_factory_success(self, ScalerAnnot, ScalerFactoryAnnot):
+        source = '''
+            struct Scaler {
+            private:
+              double factor;
+
+            public:
+              static int num_constructed;
+
+              Scaler(double factor)
+                : factor(factor) {
+                ++num_constructed;
+              }
+
+              double scale(double x) {
+                return x * factor;
+              }
+            };
+
+            int Scaler::num_constructed = 0;
+
+            using ScalerFactory = std::function<std::shared_ptr<Scaler>(double)>;
+
+            fruit::Component<ScalerFactoryAnnot> getScalerComponent() {
+              return fruit::createComponent()
+                .registerMemoizedFactory<ScalerAnnot(fruit::Assisted<double>)>([](double factor) { return Scaler(factor); });
+            }
+
+            int main() {
+              fruit::Injector<ScalerFactoryAnnot> injector(getScalerComponent);
+              ScalerFactory scalerFactory = injector.get<ScalerFactoryAnnot>();
+              std::shared_ptr<Scaler> scaler1 = scalerFactory(12.1);
+              std::shared_ptr<Scaler> scaler2 = scalerFactory(12.1);
+              std::shared_ptr<Scaler> scaler3 = scalerFactory(2.0);
+              Assert(scaler1 == scaler2);
+              Assert(scaler1 != scaler3);
+              Assert(Scaler::num_constructed == 2);
+              Assert(scaler3->scale(3) == 6);
+            }
+            '''
+        expect_success(
+            COMMON_DEFINITIONS,
+            source,
+            locals())
+
+    def test_register_memoized_factory_with_injected_params_and_max_cached_objects(self):
+        source = '''
+            struct X {
+              INJECT(X()) = default;
+              int n = 5;
+            };
+
+            struct Scaler {
+              virtual double scale(double x) = 0;
+              virtual ~Scaler() = default;
+            };
+
+            struct ScalerImpl : public Scaler {
+            private:
+              double factor;
+
+            public:
+              static int num_constructed;
+
+              ScalerImpl(double factor)
+                : factor(factor) {
+                ++num_constructed;
+              }
+
+              double scale(double x) override {
+                return x * factor;
+              }
+            };
+
+            int ScalerImpl::num_constructed = 0;
+
+            using ScalerFactory = std::function<std::shared_ptr<Scaler>(double)>;
+
+            fruit::Component<ScalerFactory> getScalerComponent() {
+              return fruit::createComponent()
+                .registerMemoizedFactory<std::unique_ptr<Scaler>(X*, fruit::Assisted<double>), 16>(
+                    [](X* x, double factor) {
+                      return std::unique_ptr<Scaler>(new ScalerImpl(factor * x->n));
+                    });
+            }
+
+            int main() {
+              fruit::Injector<ScalerFactory> injector(getScalerComponent);
+              ScalerFactory scalerFactory(injector);
+              std::shared_ptr<Scaler> scaler = scalerFactory(1.0);
+              Assert(scaler->scale(2) == 10);
+              Assert(scalerFactory(1.0) == scaler);
+              // Each shard of the cache holds at most 1 object, so this evicts most of the cached objects.
+              for (int i = 0; i < 1000; i++) {
+                Assert(scalerFactory(i + 0.5)->scale(2) == (i + 0.5) * 10);
+              }
+              Assert(ScalerImpl::num_constructed == 1001);
+              // The object returned earlier is still alive even if it was evicted.
+              Assert(scaler->scale(3) == 15);
+            }
+            '''
+        expect_success(
+            COMMON_DEFINITIONS,
+            source,
+            locals())
+
+    def test_register_memoized_factory_evicted_objects_released_during_concurrent_lookups(self):
+        source = '''
+            #include <atomic>
+            #include <thread>
+            #include <vector>
+
+            std::atomic<int> num_alive(0);
+
+            struct Scaler {
+              double factor;
+
+              Scaler(double factor) : factor(factor) {
+                ++num_alive;
+              }
+
+              Scaler(const Scaler& other) : factor(other.factor) {
+                ++num_alive;
+              }
+
+              ~Scaler() {
+                --num_alive;
+              }
+            };
+
+            using ScalerFactory = std::function<std::shared_ptr<Scaler>(double)>;
+
+            fruit::Component<ScalerFactory> getScalerComponent() {
+              return fruit::createComponent()
+                .registerMemoizedFactory<Scaler(fruit::Assisted<double>), 16>(
+                    [](double factor) { return Scaler(factor); });
+            }
+
+            int main() {
+              fruit::Injector<ScalerFactory> injector(getScalerComponent);
+              ScalerFactory scalerFactory(injector);
+              scalerFactory(0.5);
+
+              std::atomic<bool> done(false);
+              std::vector<std::thread> threads;
+              for (int i = 0; i < 4; ++i) {
+                threads.emplace_back([&, scalerFactory]() {
+                  while (!done) {
+                    scalerFactory(0.5);
+                  }
+                });
+              }
+              for (int i = 0; i < 5000; ++i) {
+                scalerFactory(i + 1.5);
+                // At most 1 cached object for each of the 16 shards, plus the retired ones that might still be in use
+                // by a lookup (at most 2 for each thread).
+                Assert(num_alive <= 64);
+              }
+              done = true;
+              for (std::thread& thread : threads) {
+                thread.join();
+              }
+            }
+            '''
+        expect_success(
+            COMMON_DEFINITIONS,
+            source,
+            locals())
+
 if __name__ == '__main__':
     absltest.main()
@@ -502,5 +502,404 @@ class TestRegisterProvider(parameterized.TestCase):
             source,
             locals())
 
+    @multiple_parameters([
+        'WithNoAnnot',
+        'WithAnnot1',
+    ], [
+       ('X(y)', 'X'),
+       ('new X(y)', 'X*'),
+    ])
+    def test_register_thread_local_provider_success(self, WithAnnot, ConstructX, XPtr):
+        source = '''
+            #include <thread>
+
+            struct Y {
+              INJECT(Y()) = default;
+            };
+
+            struct X : public ConstructionTracker<X> {
+              Y* y;
+              X(Y* y) : y(y) {}
+            };
+
+            fruit::Component<WithAnnot<fruit::ThreadLocal<X>>> getComponent() {
+              return fruit::createComponent()
+                .registerThreadLocalProvider<WithAnnot<XPtr>(Y*)>([](Y* y){return ConstructX;});
+            }
+
+            int main() {
+              fruit::Injector<WithAnnot<fruit::ThreadLocal<X>>> injector(getComponent);
+              fruit::ThreadLocal<X>& x = injector.get<WithAnnot<fruit::ThreadLocal<X>&>>();
+
+              X* x1 = &x.get();
+              Assert(&x.get() == x1);
+              Assert(&*x == x1);
+              Assert(x->y == x1->y);
+
+              std::thread thread([&]() {
+                X* x2 = &x.get();
+                Assert(&x.get() == x2);
+                Assert(x2 != x1);
+                Assert(x2->y == x1->y);
+              });
+              thread.join();
+            }
+            '''
+        expect_success(
+            COMMON_DEFINITIONS,
+            source,
+            locals())
+
+    def test_register_thread_local_provider_destruction(self):
+        source = '''
+            #include <thread>
+
+            struct X {
+              static int num_objects_destroyed;
+              ~X() {
+                ++num_objects_destroyed;
+              }
+            };
+
+            int X::num_objects_destroyed = 0;
+
+            fruit::Component<fruit::ThreadLocal<X>> getComponent() {
+              return fruit::createComponent()
+                .registerThreadLocalProvider([](){return new X();});
+            }
+
+            int main() {
+              {
+                fruit::Injector<fruit::ThreadLocal<X>> injector(getComponent);
+                fruit::ThreadLocal<X>& x = injector.get<fruit::ThreadLocal<X>&>();
+                x.get();
+
+                std::thread thread([&]() {
+                  x.get();
+                });
+                thread.join();
+                // The instance of the other thread is destroyed at thread exit.
+                Assert(X::num_objects_destroyed == 1);
+
+                std::thread thread2([&]() {});
+                thread2.join();
+                Assert(X::num_objects_destroyed == 1);
+              }
+              // The instance of this thread is destroyed with the injector.
+              Assert(X::num_objects_destroyed == 2);
+            }
+            '''
+        expect_success(
+            COMMON_DEFINITIONS,
+            source,
+            locals())
+
+    def test_register_thread_local_provider_destructor_using_other_thread_local(self):
+        source = '''
+            #include <thread>
+
+            struct Y {
+              static int num_objects_destroyed;
+              ~Y() {
+                ++num_objects_destroyed;
+              }
+            };
+
+            int Y::num_objects_destroyed = 0;
+
+            struct X {
+              fruit::ThreadLocal<Y>& y;
+              X(fruit::ThreadLocal<Y>& y) : y(y) {}
+              ~X() {
+                // At thread exit, this constructs the Y instance of the exiting thread.
+                y.get();
+              }
+            };
+
+            fruit::Component<fruit::ThreadLocal<X>> getComponent() {
+              return fruit::createComponent()
+                .registerThreadLocalProvider([](fruit::ThreadLocal<Y>& y){return new X(y);})
+                .registerThreadLocalProvider([](){return new Y();});
+            }
+
+            int main() {
+              fruit::Injector<fruit::ThreadLocal<X>> injector(getComponent);
+              fruit::ThreadLocal<X>& x = injector.get<fruit::ThreadLocal<X>&>();
+
+              std::thread thread([&]() {
+                x.get();
+              });
+              thread.join();
+              // The Y instance constructed while destroying X is destroyed at thread exit too.
+              Assert(Y::num_objects_destroyed == 1);
+            }
+            '''
+        expect_success(
+            COMMON_DEFINITIONS,
+            source,
+            locals())
+
+    def test_register_thread_local_provider_destructor_using_other_thread_local_in_injector_destruction(self):
+        source = '''
+            #include <condition_variable>
+            #include <mutex>
+            #include <thread>
+
+            struct Y {
+              static int num_objects_destroyed;
+              ~Y() {
+                ++num_objects_destroyed;
+              }
+            };
+
+            int Y::num_objects_destroyed = 0;
+
+            struct X {
+              fruit::ThreadLocal<Y>& y;
+              X(fruit::ThreadLocal<Y>& y) : y(y) {}
+              ~X() {
+                // When the injector is destroyed, this constructs the Y instance of the main thread.
+                y.get();
+              }
+            };
+
+            fruit::Component<fruit::ThreadLocal<X>> getComponent() {
+              return fruit::createComponent()
+                .registerThreadLocalProvider([](fruit::ThreadLocal<Y>& y){return new X(y);})
+                .registerThreadLocalProvider([](){return new Y();});
+            }
+
+            int main() {
+              std::mutex mutex;
+              std::condition_variable cv;
+              bool x_constructed = false;
+              bool injector_destroyed = false;
+              std::thread thread;
+              {
+                fruit::Injector<fruit::ThreadLocal<X>> injector(getComponent);
+                fruit::ThreadLocal<X>& x = injector.get<fruit::ThreadLocal<X>&>();
+
+                thread = std::thread([&]() {
+                  x.get();
+                  std::unique_lock<std::mutex> lock(mutex);
+                  x_constructed = true;
+                  cv.notify_all();
+                  cv.wait(lock, [&] { return injector_destroyed; });
+                });
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [&] { return x_constructed; });
+              }
+              // The X instance of the other thread was destroyed with the injector (on this thread), and so was the Y
+              // instance that its destructor constructed.
+              Assert(Y::num_objects_destroyed == 1);
+              {
+                std::lock_guard<std::mutex> lock(mutex);
+                injector_destroyed = true;
+                cv.notify_all();
+              }
+              thread.join();
+            }
+            '''
+        expect_success(
+            COMMON_DEFINITIONS,
+            source,
+            locals())
+
+    def test_register_thread_local_provider_error_signature_mismatch(self):
+        source = '''
+            struct X {};
+
+            fruit::Component<fruit::ThreadLocal<X>> getComponent() {
+              return fruit::createComponent()
+                .registerThreadLocalProvider<X()>([](int){return X();});
+            }
+            '''
+        expect_compile_error(
+            r'AnnotatedSignatureDifferentFromLambdaSignatureError<X\(\),X\(int\)>',
+            r'The annotated signature specified is not the same as the lambda.s signature \(after removing annotations\).',
+            COMMON_DEFINITIONS,
+            source,
+            locals())
+
+    @parameterized.parameters([
+        'WithNoAnnot',
+        'WithAnnot1',
+    ])
+    def test_register_per_cpu_provider_success(self, WithAnnot):
+        source = '''
+            #include <atomic>
+            #include <thread>
+            #include <vector>
+
+            struct Y {
+              INJECT(Y()) = default;
+            };
+
+            struct X {
+              Y* y;
+              std::atomic<int> count{0};
+              X(Y* y) : y(y) {}
+              X(X&& other) : y(other.y) {}
+            };
+
+            fruit::Component<WithAnnot<fruit::PerCpu<X>>> getComponent() {
+              return fruit::createComponent()
+                .registerPerCpuProvider<WithAnnot<X>(Y*)>([](Y* y){return X(y);});
+            }
+
+            int main() {
+              fruit::Injector<WithAnnot<fruit::PerCpu<X>>> injector(getComponent);
+              fruit::PerCpu<X>& x = injector.get<WithAnnot<fruit::PerCpu<X>&>>();
+
+              Assert(x.numShards() >= 1);
+              Assert(x->y == x.getShard(0).y);
+              for (std::size_t i = 1; i < x.numShards(); ++i) {
+                // Each shard is in its own cache lines.
+                Assert(reinterpret_cast<char*>(&x.getShard(i)) - reinterpret_cast<char*>(&x.getShard(i - 1)) >= 64);
+              }
+
+              std::vector<std::thread> threads;
+              for (int i = 0; i < 4; ++i) {
+                threads.emplace_back([&]() {
+                  for (int j = 0; j < 1000; ++j) {
+                    ++x.get().count;
+                  }
+                });
+              }
+              for (std::thread& thread : threads) {
+                thread.join();
+              }
+
+              int total = 0;
+              std::size_t num_shards = 0;
+              x.forEachShard([&](X& shard) {
+                total += shard.count;
+                ++num_shards;
+              });
+              Assert(total == 4000);
+              Assert(num_shards == x.numShards());
+            }
+            '''
+        expect_success(
+            COMMON_DEFINITIONS,
+            source,
+            locals())
+
+    def test_register_per_cpu_provider_not_movable_success(self):
+        source = '''
+            #include <atomic>
+
+            // Returning a non-movable type by value from the lambda requires C++17.
+            #if __cplusplus >= 201703L
+            class RequestCounter {
+            public:
+              INJECT(RequestCounter(fruit::PerCpu<std::atomic<long>>* counts)) : counts(counts) {}
+
+              void increment() {
+                counts->get().fetch_add(1, std::memory_order_relaxed);
+              }
+
+              long total() {
+                long result = 0;
+                counts->forEachShard([&](std::atomic<long>& count) { result += count.load(std::memory_order_relaxed); });
+                return result;
+              }
+
+            private:
+              fruit::PerCpu<std::atomic<long>>* counts;
+            };
+
+            fruit::Component<RequestCounter> getRequestCounterComponent() {
+              return fruit::createComponent()
+                  .registerPerCpuProvider([]() { return std::atomic<long>(0); });
+            }
+            #endif
+
+            int main() {
+            #if __cplusplus >= 201703L
+              fruit::Injector<RequestCounter> injector(getRequestCounterComponent);
+              RequestCounter& counter = injector.get<RequestCounter&>();
+              counter.increment();
+              counter.increment();
+              Assert(counter.total() == 2);
+            #endif
+            }
+            '''
+        expect_success(
+            COMMON_DEFINITIONS,
+            source,
+            locals())
+
+    def test_register_per_cpu_provider_destruction(self):
+        source = '''
+            struct X {
+              static int num_objects_constructed;
+              static int num_objects_destroyed;
+              X() {
+                ++num_objects_constructed;
+              }
+              X(X&&) {
+                ++num_objects_constructed;
+              }
+              ~X() {
+                ++num_objects_destroyed;
+              }
+            };
+
+            int X::num_objects_constructed = 0;
+            int X::num_objects_destroyed = 0;
+
+            fruit::Component<fruit::PerCpu<X>> getComponent() {
+              return fruit::createComponent()
+                .registerPerCpuProvider([](){return X();});
+            }
+
+            int main() {
+              std::size_t num_shards;
+              {
+                fruit::Injector<fruit::PerCpu<X>> injector(getComponent);
+                num_shards = injector.get<fruit::PerCpu<X>&>().numShards();
+              }
+              Assert(X::num_objects_constructed == X::num_objects_destroyed);
+              Assert(X::num_objects_destroyed >= int(num_shards));
+            }
+            '''
+        expect_success(
+            COMMON_DEFINITIONS,
+            source,
+            locals())
+
+    def test_register_per_cpu_provider_error_returning_pointer(self):
+        source = '''
+            struct X {};
+
+            fruit::Component<fruit::PerCpu<X*>> getComponent() {
+              return fruit::createComponent()
+                .registerPerCpuProvider([](){return new X();});
+            }
+            '''
+        expect_compile_error(
+            r'PerCpuProviderReturningPointerError<X>',
+            r'registerPerCpuProvider\(\) was called with a lambda that returns a pointer to T',
+            COMMON_DEFINITIONS,
+            source,
+            locals())
+
+    def test_register_per_cpu_provider_error_signature_mismatch(self):
+        source = '''
+            struct X {};
+
+            fruit::Component<fruit::PerCpu<X>> getComponent() {
+              return fruit::createComponent()
+                .registerPerCpuProvider<X()>([](int){return X();});
+            }
+            '''
+        expect_compile_error(
+            r'AnnotatedSignatureDifferentFromLambdaSignatureError<X\(\),X\(int\)>',
+            r'The annotated signature specified is not the same as the lambda.s signature \(after removing annotations\).',
+            COMMON_DEFINITIONS,
+            source,
+            locals())
+
 if __name__ == '__main__':
     absltest.main()